@@ -0,0 +1,136 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A minimal harness for the interpreter's microbenchmarks. Benchmarks
+ * register themselves with the BENCHMARK macro and are run by benchmark/main.cpp.
+ *
+ */
+namespace benchmark {
+/**
+ * @brief A single registered benchmark.
+ *
+ */
+struct Case {
+  std::string name;
+  std::function<void()> run;
+};
+
+/**
+ * @brief Gets every registered benchmark.
+ *
+ * @return std::vector<Case>&
+ */
+inline std::vector<Case> &registry() {
+  static std::vector<Case> cases{};
+  return cases;
+}
+
+/**
+ * @brief Registers a benchmark when constructed.
+ *
+ */
+struct Registrar {
+  Registrar(const std::string &name, std::function<void()> run) {
+    registry().push_back({name, std::move(run)});
+  }
+};
+
+/**
+ * @brief Runs the given function and returns how long it took in seconds.
+ *
+ * @param fn
+ * @return double
+ */
+template <typename Function>
+double time(Function fn) {
+  const auto start{std::chrono::steady_clock::now()};
+  fn();
+  const std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() -
+                                              start};
+  return elapsed.count();
+}
+
+/**
+ * @brief Prints the throughput of a measured operation.
+ *
+ * @param label
+ * @param operations
+ * @param seconds
+ */
+inline void report(const std::string &label,
+                   const std::size_t operations,
+                   const double seconds) {
+  std::cout << "  " << std::left << std::setw(48) << label << std::right
+            << std::setw(12) << std::fixed << std::setprecision(3)
+            << seconds * 1e3 << " ms" << std::setw(14) << std::setprecision(0)
+            << operations / seconds << " ops/s\n";
+}
+
+/**
+ * @brief Gets how many times the global operator new has been called so far.
+ * Defined alongside the replacement operator new in benchmark/main.cpp.
+ *
+ * @return std::size_t
+ */
+std::size_t allocations();
+
+/**
+ * @brief Runs the given function and returns how many allocations it made.
+ *
+ * @param fn
+ * @return std::size_t
+ */
+template <typename Function>
+std::size_t countAllocations(Function fn) {
+  const std::size_t start{allocations()};
+  fn();
+  return allocations() - start;
+}
+
+/**
+ * @brief Prints how many allocations a measured operation made.
+ *
+ * @param label
+ * @param operations
+ * @param allocations
+ */
+inline void reportAllocations(const std::string &label,
+                              const std::size_t operations,
+                              const std::size_t allocations) {
+  std::cout << "  " << std::left << std::setw(48) << label << std::right
+            << std::setw(12) << allocations << " allocs" << std::setw(11)
+            << std::fixed << std::setprecision(2)
+            << static_cast<double>(allocations) / operations << " per op\n";
+}
+
+/**
+ * @brief Keeps the optimizer from discarding a computed value.
+ *
+ * @param value
+ */
+template <typename T>
+void keep(const T &value) {
+  asm volatile("" : : "g"(&value) : "memory");
+}
+} // namespace benchmark
+
+#define BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_IMPL(a, b)
+
+/**
+ * @brief Defines and registers a benchmark with the given name.
+ *
+ */
+#define BENCHMARK(name)                                                        \
+  static void BENCHMARK_CONCAT(benchmarkFunction, __LINE__)();                 \
+  static const benchmark::Registrar BENCHMARK_CONCAT(benchmarkRegistrar,       \
+                                                     __LINE__){               \
+      name, BENCHMARK_CONCAT(benchmarkFunction, __LINE__)};                    \
+  static void BENCHMARK_CONCAT(benchmarkFunction, __LINE__)()
@@ -0,0 +1,44 @@
+#include "benchmark.hpp"
+#include "interpreter.hpp"
+#include "parser.hpp"
+#include "resolver.hpp"
+#include "scanner.hpp"
+#include "virtualMachine.hpp"
+
+namespace {
+const std::string fib{"subroutine fib(n) {\n"
+                      "  if n <= 1 { return n; }\n"
+                      "  return fib(n - 2) + fib(n - 1);\n"
+                      "}\n"
+                      "variable result = fib(25);\n"};
+
+const std::string loop{"variable result = 0;\n"
+                       "for i = 0; i < 1000000; i = i + 1 {\n"
+                       "  result = result + i * 2 mod 7;\n"
+                       "}\n"};
+
+// Runs a program on an engine and reports how long it took per run.
+template <typename Engine>
+void run(const std::string &name,
+         Engine &&engine,
+         const std::string &text,
+         const std::size_t operations) {
+  Parser parser{Scanner{text}.tokenize()};
+  const std::vector<Statement::StatementUPtr> statements{parser.parse()};
+  Resolver{engine.globals()}.resolve(statements);
+  const double seconds{
+      benchmark::time([&]() { engine.interpret(statements); })};
+  benchmark::report(name, operations, seconds);
+}
+} // namespace
+
+BENCHMARK("Engines: tree walker, closures and virtual machine") {
+  using Mode = Interpreter::Mode;
+  // fib(25) makes 242785 calls.
+  run("tree fib(25) calls", Interpreter{Mode::Walk}, fib, 242785);
+  run("closures fib(25) calls", Interpreter{Mode::Closures}, fib, 242785);
+  run("vm fib(25) calls", VirtualMachine{}, fib, 242785);
+  run("tree loop iterations", Interpreter{Mode::Walk}, loop, 1000000);
+  run("closures loop iterations", Interpreter{Mode::Closures}, loop, 1000000);
+  run("vm loop iterations", VirtualMachine{}, loop, 1000000);
+}
@@ -0,0 +1,82 @@
+#include "benchmark.hpp"
+#include "interpreter.hpp"
+#include "parser.hpp"
+#include "resolver.hpp"
+#include "scanner.hpp"
+
+namespace {
+template <typename Make>
+void frames(const std::string &name,
+            const std::size_t slotCount,
+            const std::size_t count,
+            Make make) {
+  std::shared_ptr<Environment> outer{std::make_shared<Environment>()};
+  std::size_t allocations{0};
+  const double seconds{benchmark::time([&]() {
+    allocations = benchmark::countAllocations([&]() {
+      for(std::size_t i{0}; i < count; i++) {
+        std::shared_ptr<Environment> frame{make(outer, slotCount)};
+        frame->defineAt(0, true);
+        benchmark::keep(frame);
+      }
+    });
+  })};
+  const std::string label{name + " frames of " + std::to_string(slotCount) +
+                          " slots x" + std::to_string(count)};
+  benchmark::report(label, count, seconds);
+  benchmark::reportAllocations(label, count, allocations);
+}
+
+void script(const std::string &name, const std::string &text) {
+  Interpreter interpreter{};
+  Parser parser{Scanner{text}.tokenize()};
+  std::vector<Statement::StatementUPtr> statements{parser.parse()};
+  Resolver{interpreter.globals()}.resolve(statements);
+  std::size_t allocations{0};
+  const double seconds{benchmark::time([&]() {
+    allocations = benchmark::countAllocations(
+        [&]() { interpreter.interpret(statements); });
+  })};
+  const EnvironmentPool::Stats &stats{interpreter.environmentPool().stats()};
+  benchmark::report(name, 1, seconds);
+  benchmark::reportAllocations(name + " all", 1, allocations);
+  benchmark::reportAllocations(name + " pool blocks",
+                               1,
+                               stats.allocations);
+  benchmark::reportAllocations(name + " pool blocks (fresh)",
+                               1,
+                               stats.allocations - stats.reused);
+}
+} // namespace
+
+BENCHMARK("EnvironmentPool: captured frames with and without the pool") {
+  EnvironmentPool pool{};
+  for(const std::size_t slotCount : {2, 8}) {
+    frames("make_shared",
+           slotCount,
+           100000,
+           [](std::shared_ptr<Environment> outer, std::size_t slots) {
+             return std::make_shared<Environment>(std::move(outer), slots);
+           });
+    frames("pooled     ",
+           slotCount,
+           100000,
+           [&](std::shared_ptr<Environment> outer, std::size_t slots) {
+             return std::allocate_shared<Environment>(
+                 PoolAllocator<Environment>{&pool},
+                 std::move(outer),
+                 slots,
+                 &pool);
+           });
+  }
+  script("adder(i)(1) loop",
+         "subroutine adder(x) {\n"
+         "  variable a = x; variable b = a; variable c = b; variable d = c;\n"
+         "  variable e = d;\n"
+         "  return lambda(y) { return e + y; };\n"
+         "}\n"
+         "variable total = 0;\n"
+         "for i = 0; i < 10000; i = i + 1 {\n"
+         "  total = total + adder(i)(1);\n"
+         "}\n");
+}
@@ -0,0 +1,48 @@
+#include "benchmark.hpp"
+#include "interpreter.hpp"
+#include "parser.hpp"
+#include "resolver.hpp"
+#include "scanner.hpp"
+
+namespace {
+// Runs a loop whose every iteration evaluates the given number of binary
+// expressions (its condition and update included), and reports the time and
+// allocations each of them took.
+void binaries(const std::string &name,
+              const std::string &declarations,
+              const std::string &body,
+              const std::size_t perIteration) {
+  const std::size_t count{200000};
+  Interpreter interpreter{};
+  Parser parser{Scanner{declarations + "for i = 0; i < " +
+                        std::to_string(count) + "; i = i + 1 {\n" + body +
+                        "\n}\n"}
+                    .tokenize()};
+  std::vector<Statement::StatementUPtr> statements{parser.parse()};
+  Resolver{interpreter.globals()}.resolve(statements);
+  std::size_t allocations{0};
+  const double seconds{benchmark::time([&]() {
+    allocations = benchmark::countAllocations(
+        [&]() { interpreter.interpret(statements); });
+  })};
+  const std::size_t nodes{count * perIteration};
+  benchmark::report(name, nodes, seconds);
+  benchmark::reportAllocations(name, nodes, allocations);
+}
+} // namespace
+
+BENCHMARK("Evaluation: binary expressions") {
+  binaries("integer a * 3 + i - 1",
+           "variable a = 2; variable total = 0;\n",
+           "  total = a * 3 + i - 1;",
+           5);
+  binaries("number x * 0.5 + i",
+           "variable x = 2.5; variable total = 0;\n",
+           "  total = x * 0.5 + i;",
+           4);
+  binaries("string s == t and s != t",
+           "variable s = \"left\"; variable t = \"right\";\n"
+           "variable same = false;\n",
+           "  same = s == t and s != t;",
+           5);
+}
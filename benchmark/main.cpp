@@ -0,0 +1,37 @@
+#include "benchmark.hpp"
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::size_t allocationCount{0};
+} // namespace
+
+std::size_t benchmark::allocations() {
+  return allocationCount;
+}
+
+// Counts every allocation made by the benchmarks.
+void *operator new(std::size_t size) {
+  allocationCount++;
+  if(void *block{std::malloc(size == 0 ? 1 : size)}) return block;
+  throw std::bad_alloc{};
+}
+
+void operator delete(void *block) noexcept {
+  std::free(block);
+}
+
+void operator delete(void *block, std::size_t) noexcept {
+  std::free(block);
+}
+
+int main(int argc, char *argv[]) {
+  // Runs every benchmark whose name contains the (optional) filter argument.
+  const std::string filter{argc > 1 ? argv[1] : ""};
+  for(const benchmark::Case &benchmarkCase : benchmark::registry()) {
+    if(benchmarkCase.name.find(filter) == std::string::npos) continue;
+    std::cout << benchmarkCase.name << '\n';
+    benchmarkCase.run();
+  }
+  return 0;
+}
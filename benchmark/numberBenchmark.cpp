@@ -0,0 +1,81 @@
+#include "benchmark.hpp"
+#include "interpreter.hpp"
+#include "parser.hpp"
+#include "resolver.hpp"
+#include "scanner.hpp"
+#include <cmath>
+
+namespace {
+template <typename T>
+std::string typeName() {
+  return std::is_same_v<T, double> ? "double" : "long double";
+}
+
+// What the interpreter's numeric operators do, over arrays so the compiler is
+// free to vectorize when the type allows it.
+template <typename T>
+void arithmetic(const std::size_t count) {
+  std::vector<T> xs(count), ys(count);
+  for(std::size_t i{0}; i < count; i++) xs[i] = static_cast<T>(i) / 7;
+  const std::size_t rounds{100};
+  const double seconds{benchmark::time([&]() {
+    for(std::size_t round{0}; round < rounds; round++) {
+      for(std::size_t i{0}; i < count; i++) ys[i] = xs[i] * T{1.5} + ys[i];
+      benchmark::keep(ys);
+    }
+  })};
+  benchmark::report(typeName<T>() + " multiply-add x" +
+                        std::to_string(count * rounds),
+                    count * rounds,
+                    seconds);
+}
+
+// What the math natives do.
+template <typename T>
+void transcendental(const std::size_t count) {
+  T total{0};
+  const double seconds{benchmark::time([&]() {
+    for(std::size_t i{0}; i < count; i++) {
+      const T x{static_cast<T>(i) / 1000};
+      total += std::sin(x) + std::sqrt(x) + std::exp(-x) + std::log(x + 1);
+    }
+  })};
+  benchmark::keep(total);
+  benchmark::report(typeName<T>() + " sin+sqrt+exp+log x" +
+                        std::to_string(count),
+                    count,
+                    seconds);
+}
+
+void script(const std::string &name, const std::string &text) {
+  Interpreter interpreter{};
+  Parser parser{Scanner{text}.tokenize()};
+  std::vector<Statement::StatementUPtr> statements{parser.parse()};
+  Resolver{interpreter.globals()}.resolve(statements);
+  const double seconds{
+      benchmark::time([&]() { interpreter.interpret(statements); })};
+  benchmark::report(typeName<Number>() + " " + name, 1, seconds);
+}
+} // namespace
+
+BENCHMARK("Numbers: long double against double") {
+  std::cout << "  Value is " << sizeof(Value) << " bytes with "
+            << typeName<Number>() << " numbers (configure with "
+            << "-DWICK_DOUBLE_NUMBERS=ON to switch)\n";
+  for(const std::size_t count : {1000, 100000}) {
+    arithmetic<long double>(count);
+    arithmetic<double>(count);
+  }
+  transcendental<long double>(1000000);
+  transcendental<double>(1000000);
+  script("script: float loop",
+         "variable total = 0.5;\n"
+         "for i = 0; i < 100000; i = i + 1 {\n"
+         "  total = total * 0.999 + i / 3;\n"
+         "}\n");
+  script("script: math natives",
+         "variable total = 0;\n"
+         "for i = 0; i < 100000; i = i + 1 {\n"
+         "  total = total + sin(i) + sqrt(i) + ln(i + 1);\n"
+         "}\n");
+}
@@ -0,0 +1,40 @@
+#include "benchmark.hpp"
+#include "environment.hpp"
+#include "persistentTable.hpp"
+
+namespace {
+Tokens makeKeys(const std::size_t count) {
+  Tokens keys{};
+  for(std::size_t i{0}; i < count; i++)
+    keys.push_back({"identifier" + std::to_string(i), Token::Type::Identifier});
+  return keys;
+}
+
+template <typename Map>
+void compare(const std::string &name, const std::size_t count) {
+  const Tokens keys{makeKeys(count)};
+  Map map{};
+  const double insertTime{benchmark::time([&]() {
+    for(std::size_t i{0}; i < count; i++)
+      map = map.insert(keys[i], static_cast<long double>(i));
+  })};
+  benchmark::report(name + " insert x" + std::to_string(count),
+                    count,
+                    insertTime);
+  const std::size_t rounds{100};
+  const double lookupTime{benchmark::time([&]() {
+    for(std::size_t round{0}; round < rounds; round++)
+      for(const Token &key : keys) benchmark::keep(map.get(key));
+  })};
+  benchmark::report(name + " get x" + std::to_string(count * rounds),
+                    count * rounds,
+                    lookupTime);
+}
+} // namespace
+
+BENCHMARK("PersistentMap: insert and lookup against the bucket table") {
+  for(const std::size_t count : {10, 100, 1000, 5000}) {
+    compare<PersistentTable<Token, Value>>("table", count);
+    compare<PersistentMap<Token, Value>>("trie ", count);
+  }
+}
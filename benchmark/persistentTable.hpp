@@ -0,0 +1,136 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief The original bucket-array PersistentMap, kept as a baseline for the
+ * benchmarks. Every insertion copies the entire array of buckets.
+ *
+ * @tparam KeyType
+ * @tparam ValueType
+ * @tparam N
+ */
+template <typename KeyType, typename ValueType, std::size_t N = 1024>
+class PersistentTable {
+  public:
+  using Entry = std::shared_ptr<std::pair<KeyType, ValueType>>;
+
+  using Table = std::array<std::vector<Entry>, N>;
+
+  /**
+   * @brief Constructs a new PersistentTable.
+   *
+   */
+  PersistentTable() = default;
+
+  /**
+   * @brief Constructs a new PersistentTable based off a table of values.
+   *
+   * @param iTable
+   */
+  PersistentTable(const Table &iTable) : table{iTable} {}
+
+  /**
+   * @brief Inserts a new key and value pair into the table and returns the new
+   * map.
+   *
+   * @param key
+   * @param value
+   * @return PersistentTable
+   */
+  PersistentTable insert(const KeyType &key, const ValueType &value) {
+    Table newTable{table};
+    const std::size_t hashIndex{std::hash<KeyType>{}(key) % N};
+    newTable[hashIndex].push_back(
+        std::make_shared<std::pair<KeyType, ValueType>>(
+            std::make_pair(key, value)));
+    return PersistentTable{newTable};
+  }
+
+  /**
+   * @brief Assigns a key to a value and returns the new map if it was possible.
+   *
+   * @param key
+   * @param value
+   * @return std::optional<PersistentTable>
+   */
+  std::optional<PersistentTable> assign(const KeyType &key,
+                                      const ValueType &value) {
+    Table newTable{table};
+    const std::size_t hashIndex{std::hash<KeyType>{}(key) % N};
+    for(std::size_t i{0}; i < newTable[hashIndex].size(); i++) {
+      if(newTable[hashIndex][i]->first == key) {
+        newTable[hashIndex][i]->second = value;
+        return PersistentTable{newTable};
+      }
+    }
+    return {};
+  }
+
+  /**
+   * @brief Gets the value associated with the provided key if it exists.
+   *
+   * @param key
+   * @return std::optional<ValueType>
+   */
+  std::optional<ValueType> get(const KeyType &key) const {
+    const std::size_t hashIndex{std::hash<KeyType>{}(key) % N};
+    for(std::size_t i{0}; i < table[hashIndex].size(); i++) {
+      if(table[hashIndex][i]->first == key) return table[hashIndex][i]->second;
+    }
+    return {};
+  }
+
+  /**
+   * @brief Gets the entry associated with the provided key.
+   *
+   * @param key
+   * @return Entry
+   */
+  Entry getEntry(const KeyType &key) const {
+    const std::size_t hashIndex{std::hash<KeyType>{}(key) % N};
+    for(std::size_t i{0}; i < table[hashIndex].size(); i++) {
+      if(table[hashIndex][i]->first == key) return table[hashIndex][i];
+    }
+    return nullptr;
+  }
+
+  /**
+   * @brief Copies the values of another PersistentTable (rather than sharing the
+   * entries themselves).
+   *
+   * @param other
+   * @return PersistentTable
+   */
+  PersistentTable copyOver(const PersistentTable &other) {
+    PersistentTable newMap{table};
+    for(std::vector<Entry> entries : other.table) {
+      for(Entry entry : entries)
+        newMap = newMap.insert(entry->first, entry->second);
+    }
+    return newMap;
+  }
+
+  /**
+   * @brief Combines several maps into one new PersistentTable.
+   *
+   * @param maps
+   * @return PersistentTable
+   */
+  static PersistentTable unionize(const std::vector<PersistentTable> &maps) {
+    Table newTable{};
+    for(std::size_t i{0}; i < newTable.size(); i++) {
+      for(PersistentTable map : maps) {
+        for(Entry entry : map.table[i]) newTable[i].push_back(entry);
+      }
+    }
+    return newTable;
+  }
+
+  private:
+  Table table;
+};
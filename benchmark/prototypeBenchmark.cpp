@@ -0,0 +1,78 @@
+#include "benchmark.hpp"
+#include "interpreter.hpp"
+#include "parser.hpp"
+#include "resolver.hpp"
+#include "scanner.hpp"
+
+namespace {
+// The per-key insertion copyOver used before the bulk builder.
+Environment::SymbolTable insertEach(const Environment::SymbolTable &map,
+                                    const Environment::SymbolTable &other) {
+  Environment::SymbolTable newMap{map};
+  other.forEach([&newMap](const Environment::SymbolTable::Entry &entry) {
+    newMap = newMap.insert(entry->first, entry->second);
+  });
+  return newMap;
+}
+
+void copies(const std::size_t count) {
+  Environment::SymbolTable properties{};
+  for(std::size_t i{0}; i < count; i++)
+    properties = properties.insert(
+        Token{"property" + std::to_string(i), Token::Type::Identifier, false},
+        static_cast<long double>(i));
+  const std::size_t rounds{std::max<std::size_t>(1, 20000 / count)};
+  const std::string suffix{" of " + std::to_string(count) + " x" +
+                           std::to_string(rounds)};
+  benchmark::report("insert each copyOver" + suffix,
+                    rounds,
+                    benchmark::time([&]() {
+                      for(std::size_t i{0}; i < rounds; i++)
+                        benchmark::keep(
+                            insertEach(Environment::SymbolTable{}, properties));
+                    }));
+  benchmark::report("bulk copyOver" + suffix,
+                    rounds,
+                    benchmark::time([&]() {
+                      for(std::size_t i{0}; i < rounds; i++)
+                        benchmark::keep(Environment::SymbolTable{}.copyOver(
+                            properties));
+                    }));
+  const Environment::SymbolTable other{
+      Environment::SymbolTable{}.insert(Token{"this", Token::Type::Identifier},
+                                        true)};
+  benchmark::report("bulk unionize" + suffix,
+                    rounds,
+                    benchmark::time([&]() {
+                      for(std::size_t i{0}; i < rounds; i++)
+                        benchmark::keep(Environment::SymbolTable::unionize(
+                            {other, properties, other}));
+                    }));
+}
+
+void instantiate(const std::size_t count) {
+  std::string text{"variable P = prototype { public: "};
+  for(std::size_t i{0}; i < count; i++)
+    text += "variable property" + std::to_string(i) + " = " +
+            std::to_string(i) + "; ";
+  const std::size_t rounds{std::max<std::size_t>(1, 20000 / count)};
+  text += "};\nfor i = 0; i < " + std::to_string(rounds) +
+          "; i = i + 1 { P(); }\n";
+  Interpreter interpreter{};
+  Parser parser{Scanner{text}.tokenize()};
+  std::vector<Statement::StatementUPtr> statements{parser.parse()};
+  Resolver{interpreter.globals()}.resolve(statements);
+  benchmark::report("instantiate prototype of " + std::to_string(count) +
+                        " x" + std::to_string(rounds),
+                    rounds,
+                    benchmark::time([&]() { interpreter.interpret(statements); }));
+}
+} // namespace
+
+BENCHMARK("Prototypes: bulk copyOver and unionize") {
+  for(const std::size_t count : {10, 100, 1000}) copies(count);
+}
+
+BENCHMARK("Prototypes: instantiation") {
+  for(const std::size_t count : {10, 100, 1000}) instantiate(count);
+}
@@ -0,0 +1,32 @@
+#include "benchmark.hpp"
+#include "interpreter.hpp"
+#include "parser.hpp"
+#include "resolver.hpp"
+#include "scanner.hpp"
+
+namespace {
+// Builds a string a piece at a time, which copied everything built so far on
+// every iteration before concatenations made ropes.
+void build(const std::size_t count) {
+  Interpreter interpreter{};
+  Parser parser{Scanner{"variable built = \"\";\n"
+                        "for i = 0; i < " +
+                        std::to_string(count) +
+                        "; i = i + 1 {\n"
+                        "  built = built + \"row,value;\";\n"
+                        "}\n"
+                        "variable same = built == built + \"\";\n"}
+                    .tokenize()};
+  std::vector<Statement::StatementUPtr> statements{parser.parse()};
+  Resolver{interpreter.globals()}.resolve(statements);
+  benchmark::report("script: build a string of " + std::to_string(count) +
+                        " pieces",
+                    count,
+                    benchmark::time(
+                        [&]() { interpreter.interpret(statements); }));
+}
+} // namespace
+
+BENCHMARK("Strings: concatenation in a loop") {
+  for(const std::size_t count : {1000, 10000, 100000}) build(count);
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "expression.hpp"
+#include "token.hpp"
+#include "value.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Contains the compiled form of Wick programs run by the virtual
+ * machine.
+ *
+ */
+namespace Bytecode {
+/**
+ * @brief The operations of the virtual machine. Operands are taken from and
+ * results pushed onto the operand stack unless noted otherwise. Registers are
+ * the variable slots of the running subroutine.
+ *
+ */
+enum class OpCode : std::uint8_t {
+  Constant,       // Pushes the constant at a.
+  Nil,            // Pushes nil.
+  Pop,            // Discards the top of the stack.
+  GetLocal,       // Pushes register a.
+  SetLocal,       // Stores the top of the stack in register a.
+  DefineLocal,    // Pops into register a.
+  NewCell,        // Puts a new cell holding nil in register a.
+  Box,            // Replaces register a with a cell holding it.
+  GetCell,        // Pushes the contents of the cell in register a.
+  SetCell,        // Stores the top of the stack in the cell in register a.
+  GetCaptured,    // Pushes the contents of captured cell a.
+  SetCaptured,    // Stores the top of the stack in captured cell a.
+  GetGlobal,      // Pushes global a.
+  SetGlobal,      // Stores the top of the stack in global a.
+  DefineGlobal,   // Pops into global a.
+  Negate,         // Unary -.
+  Not,            // Unary !.
+  Add,            // Binary +.
+  Subtract,       // Binary -.
+  Multiply,       // Binary *.
+  Divide,         // Binary /.
+  Modulus,        // Binary mod.
+  Equal,          // Binary ==.
+  NotEqual,       // Binary !=.
+  Less,           // Binary <.
+  LessEqual,      // Binary <=.
+  Greater,        // Binary >.
+  GreaterEqual,   // Binary >=.
+  CheckBoolean,   // Throws error unless the top of the stack is a boolean.
+  ShortCircuit,   // Continues at a, keeping the boolean on top, if it equals
+                  // b, and pops it otherwise.
+  Jump,           // Continues at instruction a.
+  JumpIfFalse,    // Pops a condition and continues at a if it is not true.
+  JumpIfTrue,     // Pops a condition and continues at a if it is true.
+  JumpIfHolds,    // Pops two operands and continues at a if comparison b
+                  // holds between them.
+  JumpUnless,     // Pops two operands and continues at a unless comparison b
+                  // holds between them.
+  JumpIfPassed,   // Continues at a if argument b was passed to the call.
+  Call,           // Calls the callee below a arguments, leaving its result,
+                  // which may only be missing if b is set.
+  TailCall,       // Calls the callee below a arguments in place of the
+                  // running subroutine, or as Call when it can not.
+  Closure,        // Pushes a closure of function a.
+  Prototype,      // Pushes the prototype declared by prototype expression a.
+  GetProperty,    // Replaces an object with its property named by name a.
+  SetProperty,    // Sets property a of the object below a value to it.
+  Return          // Returns the top of the stack from the running subroutine.
+};
+
+/**
+ * @brief A single operation with its operands, in 8 bytes.
+ *
+ */
+struct Instruction {
+  OpCode op;
+  std::uint16_t b{0};
+  std::uint32_t a{0};
+};
+
+/**
+ * @brief Where a closure takes one of its captured cells from when it is
+ * created: a register of the subroutine creating it, or a cell that subroutine
+ * captured itself.
+ *
+ */
+struct Capture {
+  bool fromRegister;
+  std::uint32_t index;
+};
+
+/**
+ * @brief A compiled subroutine (or the top level of a program) along with the
+ * constants and names its instructions refer to.
+ *
+ */
+struct Function {
+  std::vector<Instruction> code{};
+  std::vector<Value> constants{};
+  std::vector<Token> names{};
+  std::vector<Capture> captures{};
+  std::size_t registers{0};
+  std::size_t minArity{0};
+  std::size_t maxArity{0};
+  std::size_t index{0};
+};
+
+/**
+ * @brief A compiled program. The first function is the top level, and the
+ * prototype expressions are kept to be evaluated by the tree walker, which
+ * owns their semantics. Programs refer to the statements they were compiled
+ * from, which must outlive them.
+ *
+ */
+struct Program {
+  std::vector<std::unique_ptr<Function>> functions{};
+  std::vector<const Expression::Prototype *> prototypes{};
+};
+} // namespace Bytecode
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+
+/**
+ * @brief Class responsible for bounding how deeply calls nest. Calls are
+ * counted against a maximum depth, past which they fail with a stack overflow
+ * rather than crashing the process.
+ *
+ * Calls that find the native stack of their thread nearly used up continue on
+ * a fresh segment of stack allocated for them, so how deep recursion can go
+ * is bounded by the maximum depth rather than by the native stack. The calls
+ * themselves still recurse natively, each segment running on a thread of its
+ * own, so deep recursion costs native stack in proportion to its depth; only
+ * the virtual machine keeps its frames on the heap.
+ *
+ */
+class CallStack {
+  public:
+  /**
+   * @brief How many calls may be running at once unless set otherwise. Each
+   * call of the tree engines takes about 2 KB of native stack, so calls nested
+   * this deeply take about 200 MB.
+   *
+   */
+  static constexpr std::size_t defaultMaxDepth{100000};
+
+  /**
+   * @brief Constructs a call stack allowing the given number of calls to run
+   * at once.
+   *
+   * @param iMaxDepth
+   */
+  explicit CallStack(const std::size_t iMaxDepth = defaultMaxDepth);
+
+  /**
+   * @brief Sets how many calls may be running at once.
+   *
+   * @param iMaxDepth
+   */
+  void setMaxDepth(const std::size_t iMaxDepth);
+
+  /**
+   * @brief Gets how many calls may be running at once.
+   *
+   * @return std::size_t
+   */
+  std::size_t maxDepth() const;
+
+  /**
+   * @brief Runs a call nested within the running ones, failing with a stack
+   * overflow if that would nest calls deeper than the maximum.
+   *
+   * @tparam Call
+   * @param call
+   * @return auto What the call returned.
+   */
+  template <typename Call> auto enter(Call call);
+
+  /**
+   * @brief Runs a body on the native stack if enough of it is left, or on a
+   * new segment of stack otherwise.
+   *
+   * @tparam Body
+   * @param body
+   * @return auto What the body returned.
+   */
+  template <typename Body> static auto grow(Body body);
+
+  /**
+   * @brief Fails with a stack overflow.
+   *
+   */
+  [[noreturn]] static void overflow();
+
+  private:
+  std::size_t limit;
+  std::size_t calls{0};
+
+  static bool low();
+
+  static void onNewSegment(const std::function<void()> &body);
+};
+
+template <typename Call> auto CallStack::enter(Call call) {
+  if(calls >= limit) overflow();
+  // Counts the call out however it ends.
+  struct Depth {
+    std::size_t &calls;
+
+    ~Depth() { calls--; }
+  } depth{++calls};
+  return grow(call);
+}
+
+template <typename Body> auto CallStack::grow(Body body) {
+  if(!low()) return body();
+  std::optional<decltype(body())> result{};
+  onNewSegment([&] { result.emplace(body()); });
+  return std::move(result.value());
+}
@@ -0,0 +1,314 @@
+#pragma once
+
+#include "interpreter.hpp"
+#include <functional>
+
+/**
+ * @brief Class responsible for compiling resolved programs into trees of C++
+ * closures the interpreter runs instead of walking the parse tree. Each node
+ * is visited once and becomes a closure with its operator, the closures of its
+ * children, and where its variables were bound already captured, so running
+ * it involves no visitor dispatch and no decisions the tree already settled.
+ *
+ * Compiled programs run on the interpreter's own environments and captures,
+ * so they create the same closures the tree walker would, and prototypes are
+ * handed to the tree walker whole. Programs must outlive what they compile to.
+ *
+ */
+class ClosureCompiler :
+    public Expression::Expression::Visitor,
+    public Statement::Statement::Visitor {
+  public:
+  /**
+   * @brief Evaluates a compiled expression into the result, returning whether
+   * it had a value.
+   *
+   */
+  using Evaluate = std::function<bool(Environment *env, Value &result)>;
+
+  /**
+   * @brief Executes a compiled statement, returning whether a return statement
+   * ran. Returned holds what it returned, if anything.
+   *
+   */
+  using Execute = std::function<bool(Environment *env,
+                                     std::optional<Value> &returned)>;
+
+  /**
+   * @brief Tests a compiled condition, returning whether it is true.
+   *
+   */
+  using Test = std::function<bool(Environment *env)>;
+
+  /**
+   * @brief Constructs a compiler for programs run by the given interpreter.
+   *
+   * @param iInterpreter
+   */
+  ClosureCompiler(Interpreter *iInterpreter);
+
+  /**
+   * @brief Compiles a resolved program.
+   *
+   * @param statements
+   * @return std::vector<Execute>
+   */
+  std::vector<Execute>
+      compile(const std::vector<Statement::StatementUPtr> &statements);
+
+  /**
+   * @brief Compiles a literal into the loading of its value.
+   *
+   * @param literal
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Literal &literal,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Compiles a unary expression into the application of its operator.
+   *
+   * @param unary
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Unary &unary,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Compiles a binary expression into the operation of its operator,
+   * reading operands that are literals or variables of the running scope
+   * directly.
+   *
+   * @param binary
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Binary &binary,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Compiles a logical expression into a closure that only evaluates
+   * its right operand when the left one does not decide the result.
+   *
+   * @param logical
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Logical &logical,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Compiles the expression within a group.
+   *
+   * @param group
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Group &group,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Compiles a ternary expression.
+   *
+   * @param ternary
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Ternary &ternary,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Compiles a variable into a load from where it was bound.
+   *
+   * @param variable
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Variable &variable,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Compiles an assignment into a store to where its variable was bound.
+   *
+   * @param assignment
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Assignment &assignment,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Compiles a call.
+   *
+   * @param call
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Call &call,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Compiles the body of a lambda once, and the lambda into the creation
+   * of a closure running it.
+   *
+   * @param lambda
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Lambda &lambda,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Compiles a prototype into its evaluation by the tree walker.
+   *
+   * @param prototype
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Prototype &prototype,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Compiles a set expression.
+   *
+   * @param set
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Set &set,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Compiles a get expression.
+   *
+   * @param get
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Get &get,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Compiles an expression statement, discarding its value.
+   *
+   * @param expr
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::Expression &expr,
+                              Environment *env) override;
+
+  /**
+   * @brief Compiles a variable declaration into a definition of its slot.
+   *
+   * @param variable
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::Variable &variable,
+                              Environment *env) override;
+
+  /**
+   * @brief Compiles the statements of a scope.
+   *
+   * @param scope
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::Scope &scope,
+                              Environment *env) override;
+
+  /**
+   * @brief Compiles an if statement.
+   *
+   * @param ifStmt
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::If &ifStmt,
+                              Environment *env) override;
+
+  /**
+   * @brief Compiles a for statement.
+   *
+   * @param forStmt
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::For &forStmt,
+                              Environment *env) override;
+
+  /**
+   * @brief Compiles a return statement.
+   *
+   * @param returnStmt
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::Return &returnStmt,
+                              Environment *env) override;
+
+  private:
+  Interpreter *interpreter;
+  Evaluate evaluated{};
+  Execute executed{};
+
+  Evaluate compile(Expression::Expression *expr);
+
+  Execute compile(Statement::Statement *statement);
+
+  // Compiles a condition into a test. Logical operators and comparisons
+  // branch on their operands rather than making a boolean to test.
+  Test test(Expression::Expression *condition,
+            const bool logicalOperand = false);
+};
+
+/**
+ * @brief What a lambda compiles to, shared by every closure created from it.
+ *
+ */
+struct CompiledLambda {
+  std::vector<ClosureCompiler::Evaluate> defaultParams;
+  ClosureCompiler::Execute body;
+};
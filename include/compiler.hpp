@@ -0,0 +1,322 @@
+#pragma once
+
+#include "bytecode.hpp"
+#include "expression.hpp"
+#include "statement.hpp"
+#include <stdexcept>
+
+/**
+ * @brief Class responsible for compiling resolved programs into bytecode for
+ * the virtual machine. The variables of every subroutine become registers:
+ * each environment the tree walker would create takes the registers after the
+ * ones of the environments enclosing it within the same subroutine, so the
+ * depth and slot the resolver bound a variable to name a single register.
+ *
+ * Prototypes keep the tree walker's environments and are only compiled at the
+ * top level, outside of every scope, where those environments need nothing
+ * but the global one. Programs using them anywhere else are left to the tree
+ * walker.
+ *
+ */
+class Compiler :
+    public Expression::Expression::Visitor,
+    public Statement::Statement::Visitor {
+  public:
+  /**
+   * @brief Error thrown for programs the compiler can not compile, which the
+   * tree walker can still run.
+   *
+   */
+  class Unsupported : public std::runtime_error {
+    public:
+    using std::runtime_error::runtime_error;
+  };
+
+  /**
+   * @brief Compiles a resolved program. Throws Unsupported for programs it
+   * can not compile.
+   *
+   * @param statements
+   * @return Bytecode::Program
+   */
+  Bytecode::Program
+      compile(const std::vector<Statement::StatementUPtr> &statements);
+
+  /**
+   * @brief Compiles a literal into a constant.
+   *
+   * @param literal
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Literal &literal,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Compiles a unary expression.
+   *
+   * @param unary
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Unary &unary,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Compiles a binary expression into the operation of its operator.
+   *
+   * @param binary
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Binary &binary,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Compiles a logical expression into a jump past its right operand
+   * when the left one decides the result.
+   *
+   * @param logical
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Logical &logical,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Compiles the expression within a group.
+   *
+   * @param group
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Group &group,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Compiles a ternary expression into a branch.
+   *
+   * @param ternary
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Ternary &ternary,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Compiles a variable into a load from where it was bound.
+   *
+   * @param variable
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Variable &variable,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Compiles an assignment into a store to where its variable was bound.
+   *
+   * @param assignment
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Assignment &assignment,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Compiles a call.
+   *
+   * @param call
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Call &call,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Compiles the body of a lambda into a function of its own, and the
+   * lambda into the creation of a closure over it.
+   *
+   * @param lambda
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Lambda &lambda,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Compiles a prototype declared at the top level into its evaluation
+   * by the tree walker.
+   *
+   * @param prototype
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Prototype &prototype,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Compiles a set expression.
+   *
+   * @param set
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Set &set,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Compiles a get expression.
+   *
+   * @param get
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Get &get,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Compiles an expression statement, discarding its value.
+   *
+   * @param expr
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::Expression &expr,
+                              Environment *env) override;
+
+  /**
+   * @brief Compiles a variable declaration into a definition of its register
+   * or global.
+   *
+   * @param variable
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::Variable &variable,
+                              Environment *env) override;
+
+  /**
+   * @brief Compiles the statements of a scope, giving its variables the
+   * registers after the enclosing ones.
+   *
+   * @param scope
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::Scope &scope,
+                              Environment *env) override;
+
+  /**
+   * @brief Compiles an if statement into branches.
+   *
+   * @param ifStmt
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::If &ifStmt,
+                              Environment *env) override;
+
+  /**
+   * @brief Compiles a for statement into a loop.
+   *
+   * @param forStmt
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::For &forStmt,
+                              Environment *env) override;
+
+  /**
+   * @brief Compiles a return statement.
+   *
+   * @param returnStmt
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::Return &returnStmt,
+                              Environment *env) override;
+
+  private:
+  // The function being compiled, the first register of each environment the
+  // tree walker would have within it, and the first register none of them use.
+  struct FunctionState {
+    Bytecode::Function *function;
+    std::vector<std::size_t> frames{};
+    std::size_t nextRegister{0};
+  };
+
+  Bytecode::Program program{};
+  std::vector<FunctionState> states{};
+  // The expression of the expression statement being compiled, whose value
+  // is discarded and so may be missing.
+  const Expression::Expression *discarded{nullptr};
+
+  void compile(Expression::Expression *expr);
+
+  void compile(Statement::Statement *statement);
+
+  std::size_t emit(const Bytecode::OpCode op,
+                   const std::size_t a = 0,
+                   const std::size_t b = 0);
+
+  void patch(const std::size_t jump);
+
+  void patch(const std::vector<std::size_t> &jumps);
+
+  // Compiles a condition into jumps, left for the caller to patch, taken when
+  // its truth is the one given and passed otherwise.
+  void branch(Expression::Expression *condition,
+              const bool when,
+              std::vector<std::size_t> &jumps,
+              const bool logicalOperand = false);
+
+  bool beginFrame(const FrameLayout &layout);
+
+  void endFrame();
+
+  std::uint32_t registerOf(const Binding &binding) const;
+
+  void load(const Binding &binding);
+
+  void store(const Binding &binding);
+};
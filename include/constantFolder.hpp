@@ -0,0 +1,225 @@
+#pragma once
+
+#include "globalEnvironment.hpp"
+#include "native.hpp"
+#include "treeRewriter.hpp"
+#include <unordered_set>
+
+/**
+ * @brief Class responsible for the optimization pass between parsing and
+ * resolution. Evaluates whatever can be known before the program runs:
+ * operators on literals, constants with such initializers, calls to pure
+ * natives on known arguments, and ternaries and ifs on known conditions. Each
+ * is replaced in the tree by what it evaluates to.
+ *
+ * Anything that would raise an error is left for the program to raise when it
+ * runs, so folding never changes what a program does, only how much it does.
+ *
+ */
+class ConstantFolder : public TreeRewriter {
+  public:
+  /**
+   * @brief Constructs a folder for programs that will run with the given
+   * global environment, whose constants and pure natives it may evaluate.
+   *
+   * @param iGlobals
+   */
+  explicit ConstantFolder(GlobalEnvironment *const iGlobals);
+
+  /**
+   * @brief Folds the constants within a series of statements.
+   *
+   * @param statements
+   */
+  void rewrite(std::vector<Statement::StatementUPtr> &statements) override;
+
+  /**
+   * @brief Gives the value of a literal.
+   *
+   * @param literal
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Literal &literal,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Applies a unary operator to a known operand.
+   *
+   * @param unary
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Unary &unary,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Applies a binary operator to known operands.
+   *
+   * @param binary
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Binary &binary,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Gives the result of a logical expression whose known left operand
+   * decides it, or whose operands are both known.
+   *
+   * @param logical
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Logical &logical,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Gives the value of a known expression within a group.
+   *
+   * @param group
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Group &group,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Replaces a ternary with a known condition by the branch it takes.
+   *
+   * @param ternary
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Ternary &ternary,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Gives the value of a constant known ahead of time.
+   *
+   * @param variable
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Variable &variable,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Makes a call to a pure native with known arguments.
+   *
+   * @param call
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Call &call,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Folds the default parameters and body of a lambda in a scope of
+   * its parameters.
+   *
+   * @param lambda
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Lambda &lambda,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Folds the properties of a prototype. Names within it may refer to
+   * inherited properties, so constants from outside it are not propagated.
+   *
+   * @param prototype
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Prototype &prototype,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Folds an initializer, remembering the value of constants whose
+   * initializer is known.
+   *
+   * @param variable
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::Variable &variable,
+                              Environment *env) override;
+
+  /**
+   * @brief Folds the statements of a scope.
+   *
+   * @param scope
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::Scope &scope,
+                              Environment *env) override;
+
+  /**
+   * @brief Replaces an if statement with a known condition by the branch it
+   * takes, or removes it if there is none.
+   *
+   * @param ifStmt
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::If &ifStmt,
+                              Environment *env) override;
+
+  /**
+   * @brief Folds every part of a for loop.
+   *
+   * @param forStmt
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::For &forStmt,
+                              Environment *env) override;
+
+  private:
+  using TreeRewriter::rewrite;
+
+  bool known(const Value &value, Value &result);
+
+  void declare(const Token &variable, const std::optional<Value> &value);
+
+  std::optional<Value> constant(const Token &variable) const;
+
+  GlobalEnvironment *const globals;
+  // Declarations map to their value when they are constants known ahead of
+  // time. Declarations within prototypes are never known.
+  Scopes<std::optional<Value>> scopes{};
+  std::unordered_set<SymbolId> declaredGlobals{};
+};
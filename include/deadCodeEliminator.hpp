@@ -0,0 +1,153 @@
+#pragma once
+
+#include "treeRewriter.hpp"
+#include <unordered_set>
+
+/**
+ * @brief Class responsible for removing code that can never run or whose
+ * result is never used: statements after a return, loops whose conditions are
+ * literals that are never true, declarations of local names that are never
+ * read, and private prototype subroutines that are never mentioned. Branches
+ * whose conditions are literals are already removed by the constant folder.
+ *
+ * A declaration that is removed still evaluates its initializer unless the
+ * initializer can neither fail nor have effects, and assignments to the name
+ * it declared are replaced by the values they assigned. Declarations of names
+ * initialized or assigned values that may be missing, like calls, are kept,
+ * as giving a name no value is an error. Names are only ever
+ * compared by symbol across the whole program, so a name read anywhere keeps
+ * every declaration of it.
+ *
+ */
+class DeadCodeEliminator : public TreeRewriter {
+  public:
+  /**
+   * @brief How many statements or expressions of a kind were removed, and how
+   * many nodes they had in all.
+   *
+   */
+  struct Removal {
+    std::string kind;
+    std::size_t count{0};
+    std::size_t nodes{0};
+  };
+
+  /**
+   * @brief Constructs an eliminator that has removed nothing yet.
+   *
+   */
+  DeadCodeEliminator();
+
+  /**
+   * @brief Removes the dead code within a program.
+   *
+   * @param statements
+   */
+  void rewrite(std::vector<Statement::StatementUPtr> &statements) override;
+
+  /**
+   * @brief Gives what was removed so far, one entry for each kind of code
+   * removed.
+   *
+   * @return const std::vector<Removal>&
+   */
+  const std::vector<Removal> &removals() const;
+
+  /**
+   * @brief Replaces an assignment to a removed declaration by the value it
+   * assigns.
+   *
+   * @param assignment
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Assignment &assignment,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Removes dead code within a lambda in a scope of its parameters.
+   *
+   * @param lambda
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Lambda &lambda,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Removes dead code within a prototype, and the private subroutines
+   * of it that are never mentioned. Names within it may refer to inherited
+   * properties, so nothing it declares is removed as unused.
+   *
+   * @param prototype
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Prototype &prototype,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Declares a name, removing the declaration if it is local to a
+   * scope and never read.
+   *
+   * @param variable
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::Variable &variable,
+                              Environment *env) override;
+
+  /**
+   * @brief Removes dead code within a scope, including every statement after
+   * one that always returns.
+   *
+   * @param scope
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::Scope &scope,
+                              Environment *env) override;
+
+  /**
+   * @brief Removes a loop whose condition is a literal that is never true,
+   * keeping only its initializer.
+   *
+   * @param forStmt
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::For &forStmt,
+                              Environment *env) override;
+
+  private:
+  // The kinds of code removed, in the order they are reported.
+  enum Kind { Unreachable, Unused, Loop, Helper };
+
+  using TreeRewriter::rewrite;
+
+  bool inert(const Expression::Expression *expr) const;
+
+  void removed(const Kind kind, const std::size_t nodes);
+
+  // Whether each name a scope declares had its declaration removed. Only the
+  // declarations of blocks may be.
+  Scopes<bool> scopes{};
+  // Names the program reads, assigns, or mentions as properties, the ones it
+  // assigns from within prototypes, and the ones it assigns values that may be
+  // missing.
+  std::unordered_set<SymbolId> read{};
+  std::unordered_set<SymbolId> assigned{};
+  std::unordered_set<SymbolId> properties{};
+  std::unordered_set<SymbolId> assignedInPrototypes{};
+  std::unordered_set<SymbolId> assignedMissing{};
+  std::vector<Removal> removedCode{};
+};
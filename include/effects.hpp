@@ -0,0 +1,121 @@
+#pragma once
+
+#include "treeRewriter.hpp"
+#include <unordered_set>
+
+/**
+ * @brief Class responsible for finding what a part of a program may change
+ * when it runs: the names it assigns or declares, whether it sets properties
+ * and whether it calls anything other than a native. It never changes the tree
+ * it analyzes.
+ *
+ */
+class Effects : public TreeRewriter {
+  public:
+  /**
+   * @brief Adds the effects of a statement.
+   *
+   * @param statement
+   */
+  void analyze(Statement::StatementUPtr &statement);
+
+  /**
+   * @brief Adds the effects of an expression.
+   *
+   * @param expr
+   */
+  void analyze(Expression::ExpressionUPtr &expr);
+
+  /**
+   * @brief Determines whether the analyzed code may assign or declare a name.
+   *
+   * @param variable
+   * @return true
+   * @return false
+   */
+  bool writes(const Token &variable) const;
+
+  /**
+   * @brief Determines whether the analyzed code assigns a name from within a
+   * lambda or prototype, where any call might run the assignment.
+   *
+   * @param variable
+   * @return true
+   * @return false
+   */
+  bool writesFromCalls(const Token &variable) const;
+
+  /**
+   * @brief Determines whether the analyzed code declares a name.
+   *
+   * @param variable
+   * @return true
+   * @return false
+   */
+  bool declares(const Token &variable) const;
+
+  /**
+   * @brief Determines whether the analyzed code assigns a name or declares it
+   * more than once, so that it may not always be bound to the same value.
+   *
+   * @param variable
+   * @return true
+   * @return false
+   */
+  bool rebinds(const Token &variable) const;
+
+  /**
+   * @brief Determines whether the analyzed code may call anything but a pure
+   * native. Natives are only pure if the given program does not declare a name
+   * of its own that hides them.
+   *
+   * @param program
+   * @return true
+   * @return false
+   */
+  bool callsImpure(const Effects &program) const;
+
+  /**
+   * @brief Determines whether the analyzed code sets a property.
+   *
+   * @return true
+   * @return false
+   */
+  bool setsProperties() const;
+
+  bool visit(const Expression::Assignment &assignment,
+             Environment *env,
+             Value &result) override;
+
+  bool visit(const Expression::Call &call,
+             Environment *env,
+             Value &result) override;
+
+  bool visit(const Expression::Lambda &lambda,
+             Environment *env,
+             Value &result) override;
+
+  bool visit(const Expression::Prototype &prototype,
+             Environment *env,
+             Value &result) override;
+
+  bool visit(const Expression::Set &set,
+             Environment *env,
+             Value &result) override;
+
+  Statement::Completion visit(const Statement::Variable &variable,
+                              Environment *env) override;
+
+  private:
+  void declare(const Token &variable);
+
+  std::unordered_set<SymbolId> assigned{};
+  std::unordered_set<SymbolId> assignedFromCalls{};
+  std::unordered_set<SymbolId> declared{};
+  std::unordered_set<SymbolId> redeclared{};
+  std::unordered_set<SymbolId> nativeCallees{};
+  bool impureCalls{false};
+  bool sets{false};
+  // How many lambdas and prototypes the visit is within.
+  int callableDepth{0};
+};
@@ -1,23 +1,69 @@
 #pragma once
 
+#include "environmentPool.hpp"
 #include "persistentMap.hpp"
 #include "token.hpp"
-#include <any>
+#include "value.hpp"
+#include <array>
+
+/**
+ * @brief Where the resolver determined a variable lives at runtime. Local
+ * variables are found a number of environments outward at a slot. Boxed
+ * variables are found the same way but are held in a cell because a closure
+ * captured them. Captured variables are found at a slot of the running
+ * closure's captures. Globals are found at their slot of the global
+ * environment, and everything else (like the properties of prototypes) is
+ * searched for by name.
+ *
+ */
+struct Binding {
+  enum class Kind { Dynamic, Local, Boxed, Captured, Global } kind{Kind::Dynamic};
+  std::size_t depth{0};
+  std::size_t slot{0};
+};
+
+/**
+ * @brief Shared storage for a variable captured by a closure (a value of the
+ * cell type). The environment that declared the variable and every closure
+ * capturing it hold the same cell.
+ *
+ */
+using Cell = Value;
+
+/**
+ * @brief The cells a closure captured, in the order the resolver numbered them.
+ *
+ */
+using Captures = std::vector<Cell>;
+
+/**
+ * @brief What the resolver determined about a scope: how many slots its
+ * environment needs, whether a closure (a lambda or prototype) created within
+ * it may keep its environment alive after the scope is left, and whether it
+ * declares nothing and so needs no environment at all.
+ *
+ */
+struct FrameLayout {
+  std::size_t slots{0};
+  bool captured{true};
+  bool elided{false};
+};
 
 /**
  * @brief This class deals with memory environments; where variables, constants,
- * and subroutines are associated with information. This is based off a
- * persistent implementation of a hash table in order to save memory and deal
- * with scope issues.
+ * and subroutines are associated with information. Variables resolved ahead of
+ * time live in a fixed array of slots (stored inline for small scopes) while
+ * everything else lives in a persistent implementation of a hash table in
+ * order to save memory and deal with scope issues.
  */
-class Environment {
+class Environment : public std::enable_shared_from_this<Environment> {
   public:
   /**
    * @brief The underlying data structure for environments. A persistent
    * implementation of a hash map.
    *
    */
-  using SymbolTable = PersistentMap<Token, std::any>;
+  using SymbolTable = PersistentMap<Token, Value>;
 
   /**
    * @brief Constructs a new environment.
@@ -29,8 +75,10 @@ class Environment {
    * @brief Constructs a new environment with the given symbol table.
    *
    * @param iTable
+   * @param iOuter
    */
-  Environment(const SymbolTable &iTable);
+  Environment(const SymbolTable &iTable,
+              std::shared_ptr<Environment> iOuter = nullptr);
 
   /**
    * @brief Constructs a new environment based on the given environments outer
@@ -42,13 +90,35 @@ class Environment {
 
   /**
    * @brief Constructs a new environment with the given environment as its outer
-   * scope if persist is false; copies over the surrounding environment and
-   * table otherwise (creates a persistent copy of the given environment).
+   * scope, which is kept alive for as long as this environment is. Slots that
+   * do not fit inline come from the pool when one is given.
    *
-   * @param iEnv
-   * @param persist
+   * @param iOuter
+   * @param slotCount
+   * @param iPool
+   */
+  explicit Environment(std::shared_ptr<Environment> iOuter,
+                       const std::size_t slotCount = 0,
+                       EnvironmentPool *iPool = nullptr);
+
+  /**
+   * @brief Constructs a new environment with the given environment as its outer
+   * scope without taking ownership of it. Used for environments that live on
+   * the stack because nothing can capture them.
+   *
+   * @param iOuter
+   * @param slotCount
+   * @param iPool
    */
-  Environment(Environment *iEnv, const bool persist = false);
+  Environment(Environment *iOuter,
+              const std::size_t slotCount,
+              EnvironmentPool *iPool = nullptr);
+
+  /**
+   * @brief Destroys the environment, returning its slots to their pool.
+   *
+   */
+  virtual ~Environment();
 
   /**
    * @brief Defines a variable in the environment with a value. Throws error if
@@ -57,25 +127,100 @@ class Environment {
    * @param variable
    * @param value
    */
-  virtual void define(const Token &variable, const std::any &value);
+  virtual void define(const Token &variable, const Value &value);
+
+  /**
+   * @brief Defines the variable in the given slot of this environment. Slots
+   * are fixed when the environment is created.
+   *
+   * @param slot
+   * @param value
+   */
+  void defineAt(const std::size_t slot, const Value &value);
+
+  /**
+   * @brief How an attempt to assign a variable by name ended.
+   *
+   */
+  enum class AssignStatus { Assigned, Undefined, Constant };
 
   /**
    * @brief Assigns a value to a variable in the environment. Throws error if
-   * token is tagged constant.
+   * token is tagged constant or undefined.
+   *
+   * @param variable
+   * @param value
+   */
+  void assign(const Token &variable, const Value &value);
+
+  /**
+   * @brief Assigns a value to a variable in the environment or those enclosing
+   * it, reporting rather than throwing when it is undefined or constant.
    *
    * @param variable
    * @param value
+   * @return AssignStatus
    */
-  virtual void assign(const Token &variable, const std::any &value);
+  virtual AssignStatus tryAssign(const Token &variable, const Value &value);
+
+  /**
+   * @brief Assigns a value to the slot of the environment depth environments
+   * outward.
+   *
+   * @param depth
+   * @param slot
+   * @param value
+   */
+  void assignAt(const std::size_t depth,
+                const std::size_t slot,
+                const Value &value);
 
   /**
    * @brief Gets the value associated with the given token. Throws error if
    * undefined.
    *
    * @param variable
-   * @return std::any
+   * @return Value
+   */
+  Value get(const Token &variable);
+
+  /**
+   * @brief Finds the value associated with the given token in the environment
+   * or those enclosing it, if it is defined.
+   *
+   * @param variable
+   * @return std::optional<Value>
+   */
+  virtual std::optional<Value> find(const Token &variable);
+
+  /**
+   * @brief Gets the value in the slot of the environment depth environments
+   * outward. Throws error if undefined.
+   *
+   * @param depth
+   * @param slot
+   * @return Value
+   */
+  Value getAt(const std::size_t depth, const std::size_t slot);
+
+  /**
+   * @brief Gets the cell in the slot of the environment depth environments
+   * outward.
+   *
+   * @param depth
+   * @param slot
+   * @return Cell&
+   */
+  Cell &cellAt(const std::size_t depth, const std::size_t slot);
+
+  /**
+   * @brief Gets the token a variable was defined with in this environment, if
+   * it was defined by name here.
+   *
+   * @param variable
+   * @return std::optional<Token>
    */
-  virtual std::any get(const Token &variable);
+  virtual std::optional<Token> declaration(const Token &variable) const;
 
   /**
    * @brief Copies the contents of another environments table into this
@@ -85,6 +230,14 @@ class Environment {
    */
   virtual void copyOver(Environment *other);
 
+  /**
+   * @brief Creates a new environment with the same outer environment and a copy
+   * of the values (rather than the entries) of this environment.
+   *
+   * @return std::shared_ptr<Environment>
+   */
+  std::shared_ptr<Environment> copy();
+
   /**
    * @brief Changes if the environment allows assignment when defining.
    *
@@ -94,7 +247,8 @@ class Environment {
 
   /**
    * @brief Creates a new environment that combines the symbol tables of the
-   * given environments.
+   * given environments. The new environment shares the outer environment of
+   * the first one given.
    *
    * @param envs
    * @return std::shared_ptr<Environment>
@@ -102,8 +256,30 @@ class Environment {
   static std::shared_ptr<Environment>
       unionize(const std::vector<Environment *> &envs);
 
+  protected:
+  /**
+   * @brief Grows the slots so there are at least the given number, keeping
+   * their values. Only for environments whose variables are not all known
+   * when they are created, like the global environment.
+   *
+   * @param count
+   */
+  void reserveSlots(const std::size_t count);
+
   private:
+  static constexpr std::size_t inlineSlotCount{4};
+
+  Environment *ancestor(const std::size_t depth);
+
+  void allocateSlots(const std::size_t count);
+
   Environment *outer{nullptr};
+  std::shared_ptr<Environment> outerOwner{nullptr};
   SymbolTable table{};
+  std::size_t slotCount{0};
+  std::array<Value, inlineSlotCount> inlineSlots{};
+  std::unique_ptr<Value[]> extraSlots{nullptr};
+  EnvironmentPool *pool{nullptr};
+  Value *slots{inlineSlots.data()};
   bool allowAssign{false};
-};
\ No newline at end of file
+};
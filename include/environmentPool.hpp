@@ -0,0 +1,140 @@
+#pragma once
+
+#include "value.hpp"
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Recycles the memory of environments and their slot arrays. Blocks are
+ * sorted into size classes and carved out of large chunks; freed blocks go onto
+ * a free list for their class and are reused before any new memory is asked
+ * for. Every chunk is released at once when the pool is destroyed.
+ *
+ */
+class EnvironmentPool {
+  public:
+  /**
+   * @brief Counts of where the pool's blocks came from.
+   *
+   */
+  struct Stats {
+    std::size_t chunks{0};
+    std::size_t allocations{0};
+    std::size_t reused{0};
+    std::size_t oversized{0};
+  };
+
+  EnvironmentPool() = default;
+
+  EnvironmentPool(const EnvironmentPool &) = delete;
+
+  EnvironmentPool &operator=(const EnvironmentPool &) = delete;
+
+  /**
+   * @brief Allocates a block of at least the given size. Blocks too large for
+   * any size class are allocated directly.
+   *
+   * @param bytes
+   * @return void*
+   */
+  void *allocate(const std::size_t bytes);
+
+  /**
+   * @brief Returns a block of the given size to its free list.
+   *
+   * @param block
+   * @param bytes
+   */
+  void deallocate(void *block, const std::size_t bytes) noexcept;
+
+  /**
+   * @brief Allocates and constructs an array of empty slots.
+   *
+   * @param count
+   * @return Value*
+   */
+  Value *allocateSlots(const std::size_t count);
+
+  /**
+   * @brief Destroys and returns an array of slots allocated from this pool.
+   *
+   * @param slots
+   * @param count
+   */
+  void deallocateSlots(Value *slots, const std::size_t count) noexcept;
+
+  /**
+   * @brief Gets the counts of where the pool's blocks came from.
+   *
+   * @return const Stats&
+   */
+  const Stats &stats() const;
+
+  private:
+  using Unit = std::max_align_t;
+
+  struct FreeBlock {
+    FreeBlock *next;
+  };
+
+  static constexpr std::size_t classCount{32};
+  static constexpr std::size_t chunkUnits{1024};
+
+  static std::size_t units(const std::size_t bytes);
+
+  std::array<FreeBlock *, classCount> freeLists{};
+  std::vector<std::unique_ptr<Unit[]>> chunks{};
+  Unit *next{nullptr};
+  Unit *end{nullptr};
+  Stats counts{};
+};
+
+/**
+ * @brief Standard allocator handing out memory from an environment pool. Used
+ * with std::allocate_shared so an environment and its control block come from
+ * the pool together. The pool must outlive everything allocated from it.
+ *
+ * @tparam T
+ */
+template <typename T>
+struct PoolAllocator {
+  using value_type = T;
+
+  /**
+   * @brief Constructs an allocator drawing from the given pool.
+   *
+   * @param iPool
+   */
+  explicit PoolAllocator(EnvironmentPool *iPool) : pool{iPool} {}
+
+  /**
+   * @brief Constructs an allocator for another type sharing the same pool.
+   *
+   * @tparam U
+   * @param other
+   */
+  template <typename U>
+  PoolAllocator(const PoolAllocator<U> &other) : pool{other.pool} {}
+
+  T *allocate(const std::size_t count) {
+    return static_cast<T *>(pool->allocate(count * sizeof(T)));
+  }
+
+  void deallocate(T *block, const std::size_t count) noexcept {
+    pool->deallocate(block, count * sizeof(T));
+  }
+
+  template <typename U>
+  bool operator==(const PoolAllocator<U> &rhs) const {
+    return pool == rhs.pool;
+  }
+
+  template <typename U>
+  bool operator!=(const PoolAllocator<U> &rhs) const {
+    return pool != rhs.pool;
+  }
+
+  EnvironmentPool *pool;
+};
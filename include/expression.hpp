@@ -1,8 +1,8 @@
 #pragma once
 
 #include "environment.hpp"
+#include "operators.hpp"
 #include "statement.hpp"
-#include <any>
 #include <optional>
 
 // Forward declaration in order to implement functions/classes.
@@ -13,7 +13,9 @@ using StatementUPtr = std::unique_ptr<Statement>;
 } // namespace Statement
 
 /**
- * @brief Contains the grammar rules for Wick expressions.
+ * @brief Contains the grammar rules for Wick expressions. The children of
+ * nodes are mutable so optimization passes can rewrite the tree in place
+ * through visitors, as the resolver fills in bindings.
  *
  */
 namespace Expression {
@@ -21,6 +23,7 @@ namespace Expression {
 struct Literal;
 struct Unary;
 struct Binary;
+struct Logical;
 struct Group;
 struct Ternary;
 struct Variable;
@@ -37,7 +40,9 @@ struct Get;
  */
 struct Expression {
   /**
-   * @brief Declares an interface for visitors over Wick expressions.
+   * @brief Declares an interface for visitors over Wick expressions. Every
+   * visit writes the value of its expression into the result given by the
+   * caller, and returns whether the expression had a value at all.
    *
    */
   class Visitor {
@@ -47,30 +52,50 @@ struct Expression {
      *
      * @param literal
      * @param env
-     * @return std::optional<std::any>
+     * @param result
+     * @return true
+     * @return false
      */
-    virtual std::optional<std::any> visit(const Literal &literal,
-                                          Environment *env) = 0;
+    virtual bool visit(const Literal &literal,
+                       Environment *env,
+                       Value &result) = 0;
 
     /**
      * @brief Visits a unary expression.
      *
      * @param unary
      * @param env
-     * @return std::optional<std::any>
+     * @param result
+     * @return true
+     * @return false
      */
-    virtual std::optional<std::any> visit(const Unary &unary,
-                                          Environment *env) = 0;
+    virtual bool visit(const Unary &unary, Environment *env, Value &result) = 0;
 
     /**
      * @brief Visits a binary expression.
      *
      * @param binary
      * @param env
-     * @return std::optional<std::any>
+     * @param result
+     * @return true
+     * @return false
      */
-    virtual std::optional<std::any> visit(const Binary &binary,
-                                          Environment *env) = 0;
+    virtual bool visit(const Binary &binary,
+                       Environment *env,
+                       Value &result) = 0;
+
+    /**
+     * @brief Visits a logical expression.
+     *
+     * @param logical
+     * @param env
+     * @param result
+     * @return true
+     * @return false
+     */
+    virtual bool visit(const Logical &logical,
+                       Environment *env,
+                       Value &result) = 0;
 
     /**
      * @brief Visits a grouped expression (expressions within a set of
@@ -78,10 +103,11 @@ struct Expression {
      *
      * @param group
      * @param env
-     * @return std::optional<std::any>
+     * @param result
+     * @return true
+     * @return false
      */
-    virtual std::optional<std::any> visit(const Group &group,
-                                          Environment *env) = 0;
+    virtual bool visit(const Group &group, Environment *env, Value &result) = 0;
 
     /**
      * @brief Visits a ternary expression (<then result> if <condition> else
@@ -89,60 +115,76 @@ struct Expression {
      *
      * @param ternary
      * @param env
-     * @return std::optional<std::any>
+     * @param result
+     * @return true
+     * @return false
      */
-    virtual std::optional<std::any> visit(const Ternary &ternary,
-                                          Environment *env) = 0;
+    virtual bool visit(const Ternary &ternary,
+                       Environment *env,
+                       Value &result) = 0;
 
     /**
      * @brief Visits a variable expression.
      *
      * @param variable
      * @param env
-     * @return std::optional<std::any>
+     * @param result
+     * @return true
+     * @return false
      */
-    virtual std::optional<std::any> visit(const Variable &variable,
-                                          Environment *env) = 0;
+    virtual bool visit(const Variable &variable,
+                       Environment *env,
+                       Value &result) = 0;
 
     /**
      * @brief Visits an assignment expression.
      *
      * @param assignment
      * @param env
-     * @return std::optional<std::any>
+     * @param result
+     * @return true
+     * @return false
      */
-    virtual std::optional<std::any> visit(const Assignment &assignment,
-                                          Environment *env) = 0;
+    virtual bool visit(const Assignment &assignment,
+                       Environment *env,
+                       Value &result) = 0;
 
     /**
      * @brief Visits a call expression.
      *
      * @param call
      * @param env
-     * @return std::optional<std::any>
+     * @param result
+     * @return true
+     * @return false
      */
-    virtual std::optional<std::any> visit(const Call &call,
-                                          Environment *env) = 0;
+    virtual bool visit(const Call &call, Environment *env, Value &result) = 0;
 
     /**
      * @brief Visits a lambda expression.
      *
      * @param lambdaStmt
      * @param env
-     * @return std::optional<std::any>
+     * @param result
+     * @return true
+     * @return false
      */
-    virtual std::optional<std::any> visit(const Lambda &lambdaStmt,
-                                          Environment *env) = 0;
+    virtual bool visit(const Lambda &lambdaStmt,
+                       Environment *env,
+                       Value &result) = 0;
 
     /**
      * @brief Visits a prototype expression.
      *
      * @param prototype
      * @param env
-     * @return std::optional<std::any>
+     * @param result
+     * @return true
+     * @return false
      */
-    virtual std::optional<std::any> visit(const Prototype &prototype,
-                                          Environment *env) = 0;
+    virtual bool visit(const Prototype &prototype,
+                       Environment *env,
+                       Value &result) = 0;
 
     /**
      * @brief Visits a set expression (as in setting a prototype property to
@@ -150,29 +192,35 @@ struct Expression {
      *
      * @param set
      * @param env
-     * @return std::optional<std::any>
+     * @param result
+     * @return true
+     * @return false
      */
-    virtual std::optional<std::any> visit(const Set &set, Environment *env) = 0;
+    virtual bool visit(const Set &set, Environment *env, Value &result) = 0;
 
     /**
      * @brief Visits a get expression (as in getting a prototype property).
      *
      * @param get
      * @param env
-     * @return std::optional<std::any>
+     * @param result
+     * @return true
+     * @return false
      */
-    virtual std::optional<std::any> visit(const Get &get, Environment *env) = 0;
+    virtual bool visit(const Get &get, Environment *env, Value &result) = 0;
   };
 
   /**
-   * @brief The accept method for all Wick expressions.
+   * @brief The accept method for all Wick expressions. Writes the value of
+   * the expression into result.
    *
    * @param visitor
    * @param env
-   * @return std::optional<std::any>
+   * @param result
+   * @return true
+   * @return false
    */
-  virtual std::optional<std::any> accept(Visitor *visitor,
-                                         Environment *env) = 0;
+  virtual bool accept(Visitor *visitor, Environment *env, Value &result) = 0;
 
   // Needed to free memory in children.
   virtual ~Expression() = default;
@@ -190,11 +238,26 @@ struct Literal : Expression {
    *
    * @param iValue
    */
-  explicit Literal(const std::any &iValue);
+  explicit Literal(const Value &iValue);
 
-  const std::any value;
+  const Value value;
 
-  std::optional<std::any> accept(Visitor *visitor, Environment *env) override;
+  bool accept(Visitor *visitor, Environment *env, Value &result) override;
+};
+
+/**
+ * @brief What an operator has learned about the types of its operands. It
+ * starts out unspecialized, is rewritten into the operation specialized to the
+ * first operands it is applied to, and falls back to the generic operator for
+ * good once it sees operands of other types.
+ *
+ */
+template <typename Operation>
+struct Specialization {
+  enum class State { Unspecialized, Specialized, Generic };
+
+  State state{State::Unspecialized};
+  Operation operation{nullptr};
 };
 
 /**
@@ -211,9 +274,11 @@ struct Unary : Expression {
   Unary(const Token &iOp, ExpressionUPtr iRight);
 
   const Token op;
-  const ExpressionUPtr right;
+  mutable ExpressionUPtr right;
+  // Rewritten by the interpreter as it sees operands.
+  mutable Specialization<operators::UnaryOperation> specialization{};
 
-  std::optional<std::any> accept(Visitor *visitor, Environment *env) override;
+  bool accept(Visitor *visitor, Environment *env, Value &result) override;
 };
 
 /**
@@ -230,11 +295,35 @@ struct Binary : Expression {
    */
   Binary(ExpressionUPtr iLeft, const Token &iOp, ExpressionUPtr iRight);
 
-  const ExpressionUPtr left;
+  mutable ExpressionUPtr left;
+  const Token op;
+  mutable ExpressionUPtr right;
+  // Rewritten by the interpreter as it sees operands.
+  mutable Specialization<operators::BinaryOperation> specialization{};
+
+  bool accept(Visitor *visitor, Environment *env, Value &result) override;
+};
+
+/**
+ * @brief A logical expression like a and b or x or y. The right operand is
+ * only evaluated when the left one does not already decide the result.
+ *
+ */
+struct Logical : Expression {
+  /**
+   * @brief Constructs a new logical expression.
+   *
+   * @param iLeft
+   * @param iOp
+   * @param iRight
+   */
+  Logical(ExpressionUPtr iLeft, const Token &iOp, ExpressionUPtr iRight);
+
+  mutable ExpressionUPtr left;
   const Token op;
-  const ExpressionUPtr right;
+  mutable ExpressionUPtr right;
 
-  std::optional<std::any> accept(Visitor *visitor, Environment *env) override;
+  bool accept(Visitor *visitor, Environment *env, Value &result) override;
 };
 
 /**
@@ -249,9 +338,9 @@ struct Group : Expression {
    */
   explicit Group(ExpressionUPtr iExpr);
 
-  const ExpressionUPtr expr;
+  mutable ExpressionUPtr expr;
 
-  std::optional<std::any> accept(Visitor *visitor, Environment *env) override;
+  bool accept(Visitor *visitor, Environment *env, Value &result) override;
 };
 
 /**
@@ -270,11 +359,11 @@ struct Ternary : Expression {
           ExpressionUPtr iCondition,
           ExpressionUPtr iElseExpr);
 
-  const ExpressionUPtr thenExpr;
-  const ExpressionUPtr condition;
-  const ExpressionUPtr elseExpr;
+  mutable ExpressionUPtr thenExpr;
+  mutable ExpressionUPtr condition;
+  mutable ExpressionUPtr elseExpr;
 
-  std::optional<std::any> accept(Visitor *visitor, Environment *env) override;
+  bool accept(Visitor *visitor, Environment *env, Value &result) override;
 };
 
 /**
@@ -290,8 +379,9 @@ struct Variable : Expression {
   Variable(const Token &iVariable);
 
   const Token variable;
+  mutable Binding binding{}; // Filled in by the resolver.
 
-  std::optional<std::any> accept(Visitor *visitor, Environment *env) override;
+  bool accept(Visitor *visitor, Environment *env, Value &result) override;
 };
 
 /**
@@ -308,9 +398,10 @@ struct Assignment : Expression {
   Assignment(const Token &iVariable, ExpressionUPtr iValue);
 
   const Token variable;
-  const ExpressionUPtr value;
+  mutable ExpressionUPtr value;
+  mutable Binding binding{}; // Filled in by the resolver.
 
-  std::optional<std::any> accept(Visitor *visitor, Environment *env) override;
+  bool accept(Visitor *visitor, Environment *env, Value &result) override;
 };
 
 /**
@@ -329,11 +420,13 @@ struct Call : Expression {
        std::vector<ExpressionUPtr> iArgs,
        const Token &iClosingParen);
 
-  const ExpressionUPtr callee;
-  const std::vector<ExpressionUPtr> args;
+  mutable ExpressionUPtr callee;
+  mutable std::vector<ExpressionUPtr> args;
   const Token closingParen;
+  // Filled in by the resolver. Tail calls are what their caller returns.
+  mutable bool tail{false};
 
-  std::optional<std::any> accept(Visitor *visitor, Environment *env) override;
+  bool accept(Visitor *visitor, Environment *env, Value &result) override;
 };
 
 /**
@@ -353,10 +446,15 @@ struct Lambda : Expression {
          Statement::StatementUPtr iBody);
 
   const std::vector<Token> params;
-  const std::vector<std::pair<Token, ExpressionUPtr>> defaultParams;
-  const Statement::StatementUPtr body;
-
-  std::optional<std::any> accept(Visitor *visitor, Environment *env) override;
+  mutable std::vector<std::pair<Token, ExpressionUPtr>> defaultParams;
+  mutable Statement::StatementUPtr body;
+  // Filled in by the resolver. Lambdas without captures close over the whole
+  // environment they are created in.
+  mutable FrameLayout layout{};
+  mutable std::vector<Binding> paramBindings{};
+  mutable std::optional<std::vector<Binding>> captures{};
+
+  bool accept(Visitor *visitor, Environment *env, Value &result) override;
 };
 
 /**
@@ -378,12 +476,13 @@ struct Prototype : Expression {
             std::vector<Statement::StatementUPtr> iPublicProperties,
             std::vector<Statement::StatementUPtr> iPrivateProperties);
 
-  const ExpressionUPtr constructor;
+  mutable ExpressionUPtr constructor;
   const std::optional<Token> parent;
-  const std::vector<Statement::StatementUPtr> publicProperties;
-  const std::vector<Statement::StatementUPtr> privateProperties;
+  mutable Binding parentBinding{}; // Filled in by the resolver.
+  mutable std::vector<Statement::StatementUPtr> publicProperties;
+  mutable std::vector<Statement::StatementUPtr> privateProperties;
 
-  std::optional<std::any> accept(Visitor *visitor, Environment *env) override;
+  bool accept(Visitor *visitor, Environment *env, Value &result) override;
 };
 
 /**
@@ -400,11 +499,11 @@ struct Set : Expression {
    */
   Set(ExpressionUPtr iObject, const Token &iProperty, ExpressionUPtr iValue);
 
-  const ExpressionUPtr object;
+  mutable ExpressionUPtr object;
   const Token property;
-  const ExpressionUPtr value;
+  mutable ExpressionUPtr value;
 
-  std::optional<std::any> accept(Visitor *visitor, Environment *env) override;
+  bool accept(Visitor *visitor, Environment *env, Value &result) override;
 };
 
 /**
@@ -420,10 +519,10 @@ struct Get : Expression {
    */
   Get(ExpressionUPtr iObject, const Token &iProperty);
 
-  ExpressionUPtr object; // Not constant to support conversion to Set.
+  mutable ExpressionUPtr object; // Not constant to support conversion to Set.
   const Token property;
 
-  std::optional<std::any> accept(Visitor *visitor, Environment *env) override;
+  bool accept(Visitor *visitor, Environment *env, Value &result) override;
 };
 
 } // namespace Expression
\ No newline at end of file
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "environment.hpp"
+#include <unordered_map>
+
+/**
+ * @brief The outermost environment. Every global, native or declared by a
+ * program, is given the next slot of a dense array the first time it is
+ * declared and keeps that slot for the life of the environment, so the
+ * resolver can bind globals to slots and the interpreter can reach them with a
+ * single indexed load. A slot is given out before the program defines its
+ * global, so the environment also tracks which slots have been defined and
+ * reports reading or assigning the others as undefined. Globals can still be
+ * found by name for the lookups the resolver leaves dynamic.
+ *
+ */
+class GlobalEnvironment : public Environment {
+  public:
+  /**
+   * @brief Constructs an empty global environment.
+   *
+   */
+  GlobalEnvironment() = default;
+
+  /**
+   * @brief Gives a global its slot (or finds the one it already has) and
+   * records the token it was declared with.
+   *
+   * @param variable
+   * @return std::size_t
+   */
+  std::size_t declare(const Token &variable);
+
+  /**
+   * @brief Gets the slot of a global if it has been declared.
+   *
+   * @param variable
+   * @return std::optional<std::size_t>
+   */
+  std::optional<std::size_t> slot(const Token &variable) const;
+
+  /**
+   * @brief Gets how many globals have been declared.
+   *
+   * @return std::size_t
+   */
+  std::size_t size() const;
+
+  /**
+   * @brief Defines a global by name, declaring it first if needed.
+   *
+   * @param variable
+   * @param value
+   */
+  void define(const Token &variable, const Value &value) override;
+
+  /**
+   * @brief Defines the global in the given slot, after which it can be read
+   * and assigned.
+   *
+   * @param slot
+   * @param value
+   */
+  void defineSlot(const std::size_t slot, const Value &value);
+
+  /**
+   * @brief Gets the global in the given slot. Throws error if it has not been
+   * defined yet.
+   *
+   * @param slot
+   * @return Value
+   */
+  Value getSlot(const std::size_t slot);
+
+  /**
+   * @brief Assigns the global in the given slot. Throws error if it has not
+   * been defined yet.
+   *
+   * @param slot
+   * @param value
+   */
+  void assignSlot(const std::size_t slot, const Value &value);
+
+  /**
+   * @brief Assigns a global by name, reporting whether it is undefined or
+   * constant.
+   *
+   * @param variable
+   * @param value
+   * @return AssignStatus
+   */
+  AssignStatus tryAssign(const Token &variable, const Value &value) override;
+
+  /**
+   * @brief Finds a global by name, if it is defined.
+   *
+   * @param variable
+   * @return std::optional<Value>
+   */
+  std::optional<Value> find(const Token &variable) override;
+
+  /**
+   * @brief Gets the token a global was last declared with.
+   *
+   * @param variable
+   * @return std::optional<Token>
+   */
+  std::optional<Token> declaration(const Token &variable) const override;
+
+  private:
+  std::unordered_map<SymbolId, std::size_t> indices{};
+  std::vector<Token> declarations{};
+  std::vector<bool> defined{};
+};
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "effects.hpp"
+#include <unordered_map>
+#include <unordered_set>
+
+/**
+ * @brief Class responsible for inlining calls to small subroutines. A
+ * subroutine whose body only returns an expression no bigger than the budget,
+ * and whose name is never bound to anything else, has its calls replaced by
+ * that expression with the arguments in place of the parameters.
+ *
+ * A call is only inlined if it would evaluate the same things in the same
+ * order: arguments that compute anything must each be used exactly once, in
+ * the order they were given, before anything in the body that could fail, and
+ * every other name in the body must mean at the call what it meant where the
+ * subroutine was declared, with globals declared after the subroutine already
+ * declared at the call. Bodies may only call natives, so subroutines are
+ * never inlined into themselves.
+ *
+ */
+class Inliner : public TreeRewriter {
+  public:
+  /**
+   * @brief A call that was inlined.
+   *
+   */
+  struct Inline {
+    std::string subroutine;
+    int line;
+  };
+
+  /**
+   * @brief Constructs an inliner for subroutines whose returned expression has
+   * at most the given number of nodes.
+   *
+   * @param iBudget
+   */
+  explicit Inliner(const std::size_t iBudget = 16);
+
+  /**
+   * @brief Inlines the calls to small subroutines within a program.
+   *
+   * @param statements
+   */
+  void rewrite(std::vector<Statement::StatementUPtr> &statements) override;
+
+  /**
+   * @brief Gives the calls inlined so far, in the order they were.
+   *
+   * @return const std::vector<Inline>&
+   */
+  const std::vector<Inline> &inlines() const;
+
+  /**
+   * @brief Replaces a call to a small subroutine by the expression it returns.
+   *
+   * @param call
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Call &call,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Inlines the calls within a lambda in a scope of its parameters.
+   *
+   * @param lambda
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Lambda &lambda,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Inlines the calls within a prototype. Names within it may refer to
+   * inherited properties, so nothing it declares is inlined and nothing from
+   * outside it is inlined within it.
+   *
+   * @param prototype
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Prototype &prototype,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Declares a name, remembering the subroutine it is bound to if that
+   * subroutine can be inlined.
+   *
+   * @param variable
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::Variable &variable,
+                              Environment *env) override;
+
+  /**
+   * @brief Inlines the calls within a scope.
+   *
+   * @param scope
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::Scope &scope,
+                              Environment *env) override;
+
+  /**
+   * @brief Inlines the calls within a for loop.
+   *
+   * @param forStmt
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::For &forStmt,
+                              Environment *env) override;
+
+  private:
+  // Names are told apart by the token that declared them. Globals not yet
+  // declared and natives have no such token.
+  using Declaration = const Token *;
+
+  // A subroutine that can be inlined, with what each name in its body other
+  // than its parameters refers to, and the globals of the program it reads
+  // that were not yet declared where it was.
+  struct Subroutine {
+    const Expression::Lambda *lambda;
+    const Expression::Expression *returned;
+    std::unordered_map<SymbolId, Declaration> names{};
+    std::unordered_set<SymbolId> laterGlobals{};
+  };
+
+  using TreeRewriter::rewrite;
+
+  std::optional<Declaration> lookup(const SymbolId variable) const;
+
+  bool inlinable(const Expression::Expression *expr,
+                 Subroutine &subroutine) const;
+
+  bool pure(const Expression::Expression *expr) const;
+
+  Expression::ExpressionUPtr inlined(const Expression::Call &call,
+                                     const Subroutine &subroutine) const;
+
+  const std::size_t budget;
+  Effects program{};
+  Scopes<Declaration> scopes{};
+  std::unordered_set<SymbolId> declaredGlobals{};
+  std::unordered_map<Declaration, Subroutine> subroutines{};
+  std::vector<Inline> inlinedCalls{};
+};
@@ -1,86 +1,142 @@
 #pragma once
 
+#include "callStack.hpp"
 #include "expression.hpp"
+#include "globalEnvironment.hpp"
 #include "native.hpp"
+#include "operators.hpp"
 #include <optional>
+#include <unordered_map>
+#include <utility>
+
+class ClosureCompiler;
+struct CompiledLambda;
 
 /**
  * @brief Class responsible for traversing the tree produced by the parser and
  * executing the associated behavior with the expression and statement nodes.
  * Implements the visitor interface for the expression and statement parent
- * nodes.
+ * nodes. Programs must be resolved before they are interpreted.
+ *
+ * Programs can instead be compiled into closures before they run, which
+ * spares the visitor dispatch of every node each time it runs.
+ *
+ * Calls in tail position run in place of the subroutine making them, and
+ * every other call is counted against the maximum depth of the call stack.
  *
  */
 class Interpreter :
     public Expression::Expression::Visitor,
     public Statement::Statement::Visitor {
   public:
+  /**
+   * @brief The ways the interpreter can run a program.
+   *
+   */
+  enum class Mode {
+    Walk,    // Visits the parse tree.
+    Closures // Compiles the parse tree into closures and runs those.
+  };
+
   /**
    * @brief Constructs the interpreter and initialized the global environment
    * with the appropriate native subroutines and constants.
    *
+   * @param iMode
    */
-  Interpreter();
+  Interpreter(const Mode iMode = Mode::Walk);
 
   /**
    * @brief Evaluates a literal expression.
    *
    * @param literal
    * @param env
-   * @return std::optional<std::any>
+   * @param result
+   * @return true
+   * @return false
    */
-  std::optional<std::any> visit(const Expression::Literal &literal,
-                                Environment *env) override;
+  bool visit(const Expression::Literal &literal,
+             Environment *env,
+             Value &result) override;
 
   /**
    * @brief Evaluates a unary expression according to its appropriate operator.
    *
    * @param unary
    * @param env
-   * @return std::optional<std::any>
+   * @param result
+   * @return true
+   * @return false
    */
-  std::optional<std::any> visit(const Expression::Unary &unary,
-                                Environment *env) override;
+  bool visit(const Expression::Unary &unary,
+             Environment *env,
+             Value &result) override;
 
   /**
    * @brief Evaluates a binary expression according to its appropriate operator.
    *
    * @param binary
    * @param env
-   * @return std::optional<std::any>
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Binary &binary,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Evaluates a logical expression, only evaluating its right operand
+   * when the left one does not decide the result.
+   *
+   * @param logical
+   * @param env
+   * @param result
+   * @return true
+   * @return false
    */
-  std::optional<std::any> visit(const Expression::Binary &binary,
-                                Environment *env) override;
+  bool visit(const Expression::Logical &logical,
+             Environment *env,
+             Value &result) override;
 
   /**
    * @brief Evaluates a group.
    *
    * @param group
    * @param env
-   * @return std::optional<std::any>
+   * @param result
+   * @return true
+   * @return false
    */
-  std::optional<std::any> visit(const Expression::Group &group,
-                                Environment *env) override;
+  bool visit(const Expression::Group &group,
+             Environment *env,
+             Value &result) override;
 
   /**
    * @brief Evaluates a ternary expression.
    *
    * @param ternary
    * @param env
-   * @return std::optional<std::any>
+   * @param result
+   * @return true
+   * @return false
    */
-  std::optional<std::any> visit(const Expression::Ternary &ternary,
-                                Environment *env) override;
+  bool visit(const Expression::Ternary &ternary,
+             Environment *env,
+             Value &result) override;
 
   /**
    * @brief Evaluates a variable expression.
    *
    * @param variable
    * @param env
-   * @return std::optional<std::any>
+   * @param result
+   * @return true
+   * @return false
    */
-  std::optional<std::any> visit(const Expression::Variable &variable,
-                                Environment *env) override;
+  bool visit(const Expression::Variable &variable,
+             Environment *env,
+             Value &result) override;
 
   /**
    * @brief Evaluates an assignment and places the result in the appropriate
@@ -88,10 +144,13 @@ class Interpreter :
    *
    * @param assignment
    * @param env
-   * @return std::optional<std::any>
+   * @param result
+   * @return true
+   * @return false
    */
-  std::optional<std::any> visit(const Expression::Assignment &assignment,
-                                Environment *env) override;
+  bool visit(const Expression::Assignment &assignment,
+             Environment *env,
+             Value &result) override;
 
   /**
    * @brief Evaluates a call expression. If the callee is callable it is treated
@@ -100,10 +159,13 @@ class Interpreter :
    *
    * @param call
    * @param env
-   * @return std::optional<std::any>
+   * @param result
+   * @return true
+   * @return false
    */
-  std::optional<std::any> visit(const Expression::Call &call,
-                                Environment *env) override;
+  bool visit(const Expression::Call &call,
+             Environment *env,
+             Value &result) override;
 
   /**
    * @brief Evaluates a lambda expression and creates the appropriate callable
@@ -111,10 +173,13 @@ class Interpreter :
    *
    * @param lambda
    * @param env
-   * @return std::optional<std::any>
+   * @param result
+   * @return true
+   * @return false
    */
-  std::optional<std::any> visit(const Expression::Lambda &lambda,
-                                Environment *env) override;
+  bool visit(const Expression::Lambda &lambda,
+             Environment *env,
+             Value &result) override;
 
   /**
    * @brief Evaluates a prototype expression and creates the appropriate
@@ -122,10 +187,13 @@ class Interpreter :
    *
    * @param prototype
    * @param env
-   * @return std::optional<std::any>
+   * @param result
+   * @return true
+   * @return false
    */
-  std::optional<std::any> visit(const Expression::Prototype &prototype,
-                                Environment *env) override;
+  bool visit(const Expression::Prototype &prototype,
+             Environment *env,
+             Value &result) override;
 
   /**
    * @brief Evaluates a set expression and assigns the property to the value
@@ -133,44 +201,56 @@ class Interpreter :
    *
    * @param set
    * @param env
-   * @return std::optional<std::any>
+   * @param result
+   * @return true
+   * @return false
    */
-  std::optional<std::any> visit(const Expression::Set &set,
-                                Environment *env) override;
+  bool visit(const Expression::Set &set,
+             Environment *env,
+             Value &result) override;
 
   /**
    * @brief Evaluates a get expression and returns the requested property.
    *
    * @param get
    * @param env
-   * @return std::optional<std::any>
+   * @param result
+   * @return true
+   * @return false
    */
-  std::optional<std::any> visit(const Expression::Get &get,
-                                Environment *env) override;
+  bool visit(const Expression::Get &get,
+             Environment *env,
+             Value &result) override;
 
   /**
    * @brief Executes an expression statement.
    *
    * @param expr
    * @param env
+   * @return Statement::Completion
    */
-  void visit(const Statement::Expression &expr, Environment *env) override;
+  Statement::Completion visit(const Statement::Expression &expr,
+                              Environment *env) override;
 
   /**
    * @brief Executes a variable (or constant) declaration.
    *
    * @param variable
    * @param env
+   * @return Statement::Completion
    */
-  void visit(const Statement::Variable &variable, Environment *env) override;
+  Statement::Completion visit(const Statement::Variable &variable,
+                              Environment *env) override;
 
   /**
    * @brief Executes the statements within a scope.
    *
    * @param scope
    * @param env
+   * @return Statement::Completion
    */
-  void visit(const Statement::Scope &scope, Environment *env) override;
+  Statement::Completion visit(const Statement::Scope &scope,
+                              Environment *env) override;
 
   /**
    * @brief Executes a series of if, else-if, and else statements according to
@@ -178,8 +258,10 @@ class Interpreter :
    *
    * @param ifStmt
    * @param env
+   * @return Statement::Completion
    */
-  void visit(const Statement::If &ifStmt, Environment *env) override;
+  Statement::Completion visit(const Statement::If &ifStmt,
+                              Environment *env) override;
 
   /**
    * @brief Executes a for statement body based on its initializer, condition,
@@ -187,16 +269,20 @@ class Interpreter :
    *
    * @param forStmt
    * @param env
+   * @return Statement::Completion
    */
-  void visit(const Statement::For &forStmt, Environment *env) override;
+  Statement::Completion visit(const Statement::For &forStmt,
+                              Environment *env) override;
 
   /**
    * @brief Returns an expression from within a subroutine.
    *
    * @param returnStmt
    * @param env
+   * @return Statement::Completion
    */
-  void visit(const Statement::Return &returnStmt, Environment *env) override;
+  Statement::Completion visit(const Statement::Return &returnStmt,
+                              Environment *env) override;
 
   /**
    * @brief Interprets a series of statements.
@@ -205,26 +291,120 @@ class Interpreter :
    */
   void interpret(const std::vector<Statement::StatementUPtr> &statements);
 
+  /**
+   * @brief Gets the global environment programs are interpreted within.
+   *
+   * @return GlobalEnvironment*
+   */
+  GlobalEnvironment *globals() const;
+
+  /**
+   * @brief Gets the pool the interpreter's environments are allocated from.
+   *
+   * @return const EnvironmentPool&
+   */
+  const EnvironmentPool &environmentPool() const;
+
+  /**
+   * @brief Sets how many calls may be running at once before a call fails
+   * with a stack overflow.
+   *
+   * @param maxDepth
+   */
+  void setMaxDepth(const std::size_t maxDepth);
+
   private:
-  std::shared_ptr<Environment> global;
+  friend class ClosureCompiler;
+
+  // Restores the captures of the caller however a call ends.
+  struct CapturesGuard {
+    std::shared_ptr<const Captures> &current;
+    std::shared_ptr<const Captures> saved;
+
+    ~CapturesGuard() { current = std::move(saved); }
+  };
+
+  // The procedure of closures over lambdas. Calls in tail position recognize
+  // it and run the lambda in place of the one making the call.
+  struct Subroutine {
+    Interpreter *interpreter;
+    const Expression::Lambda *lambda;
+    std::shared_ptr<const Captures> context;
+    // What the lambda compiled to, when the program was compiled into
+    // closures.
+    std::shared_ptr<const CompiledLambda> compiled;
 
-  std::any evaluate(Expression::Expression *expr, Environment *env);
+    std::optional<Value> operator()(const std::vector<Value> &args,
+                                    Environment *fnEnv) const;
+  };
 
-  std::optional<std::any> optEvaluate(Expression::Expression *expr,
-                                      Environment *env);
+  // A call in tail position, made once the subroutine making it returns.
+  struct TailCall {
+    Value callee;
+    std::vector<Value> args;
+  };
 
-  void execute(Statement::Statement *statement, Environment *env);
+  Mode mode;
+  // Declared before the environments so it outlives them.
+  EnvironmentPool pool{};
+  std::shared_ptr<GlobalEnvironment> global;
+  std::shared_ptr<const Captures> captures{};
+  // What the running return statement returned, until its call takes it.
+  std::optional<Value> returned{};
+  std::optional<TailCall> tailCall{};
+  std::unordered_map<const Expression::Lambda *, Value> closures{};
+  CallStack callStack{};
 
-  bool isTrue(const std::any &value);
+  std::shared_ptr<Environment>
+      makeEnvironment(std::shared_ptr<Environment> outer,
+                      const std::size_t slotCount = 0);
 
-  std::any stringOperation(const std::string &left,
-                           const Token::Type op,
-                           const std::string &right);
+  void makeClosure(const Expression::Lambda &lambda,
+                   Environment *env,
+                   Value &result,
+                   std::shared_ptr<const CompiledLambda> compiled = nullptr);
 
-  std::any
-      booleanOperation(const bool left, const Token::Type op, const bool right);
+  std::optional<Value> call(const Subroutine &subroutine,
+                            const std::vector<Value> &args,
+                            Environment *fnEnv);
 
-  std::any numericOperation(const long double left,
-                            const Token::Type op,
-                            const long double right);
+  std::optional<Value> run(const Subroutine &subroutine,
+                           const std::vector<Value> &args,
+                           Environment *fnEnv);
+
+  static void defineParam(const Expression::Lambda &lambda,
+                          Environment *scopedEnv,
+                          const std::size_t index,
+                          const Value &value);
+
+  Value lookUp(const Token &variable, const Binding &binding, Environment *env);
+
+  template <typename Body>
+  auto withFrame(const FrameLayout &layout, Environment *env, Body body);
+
+  Value evaluate(Expression::Expression *expr, Environment *env);
+
+  void evaluate(Expression::Expression *expr, Environment *env, Value &result);
+
+  Statement::Completion execute(Statement::Statement *statement,
+                                Environment *env);
+
+  Statement::Completion
+      execute(const std::vector<Statement::StatementUPtr> &statements,
+              Environment *env);
 };
+
+template <typename Body>
+auto Interpreter::withFrame(const FrameLayout &layout,
+                            Environment *env,
+                            Body body) {
+  if(layout.elided) return body(env);
+  // Frames no closure can capture live on the stack and allocate nothing.
+  if(layout.captured) {
+    std::shared_ptr<Environment> frame{
+        makeEnvironment(env->shared_from_this(), layout.slots)};
+    return body(frame.get());
+  }
+  Environment frame{env, layout.slots, &pool};
+  return body(&frame);
+}
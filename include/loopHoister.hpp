@@ -0,0 +1,83 @@
+#pragma once
+
+#include "effects.hpp"
+
+/**
+ * @brief Class responsible for moving loop invariant code out of loops. Parts
+ * of a loop condition that compute the same value on every iteration, because
+ * nothing the loop runs writes their inputs, are evaluated once into a
+ * constant before the loop and the condition reads the constant instead.
+ *
+ * Only the parts of a condition evaluated on every check, before anything
+ * else that could fail or have effects, are hoisted. Every loop checks its
+ * condition at least once, so hoisting never evaluates anything the loop would
+ * not have, and errors are still raised by the same expression.
+ *
+ */
+class LoopHoister : public TreeRewriter {
+  public:
+  /**
+   * @brief An expression moved out of a loop and the constant it now
+   * initializes.
+   *
+   */
+  struct Hoist {
+    std::string expression;
+    std::string temporary;
+  };
+
+  /**
+   * @brief Hoists the invariant code out of the loops of a program.
+   *
+   * @param statements
+   */
+  void rewrite(std::vector<Statement::StatementUPtr> &statements) override;
+
+  /**
+   * @brief Gives the expressions hoisted so far, in the order they were.
+   *
+   * @return const std::vector<Hoist>&
+   */
+  const std::vector<Hoist> &hoists() const;
+
+  /**
+   * @brief Leaves the loops within a prototype as they are, since the names
+   * they read may be inherited properties.
+   *
+   * @param prototype
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Prototype &prototype,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Hoists the invariant code out of the loops within a loop and then
+   * out of the loop itself. The loop is replaced by a scope that runs its
+   * initializer, declares the constants of what was hoisted and then runs the
+   * rest of the loop.
+   *
+   * @param forStmt
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::For &forStmt,
+                              Environment *env) override;
+
+  private:
+  using TreeRewriter::rewrite;
+
+  bool invariant(const Expression::Expression *expr, const Effects &loop) const;
+
+  void hoist(Expression::ExpressionUPtr &expr,
+             const Effects &loop,
+             bool &clean,
+             std::vector<Statement::StatementUPtr> &constants);
+
+  Effects program{};
+  int prototypeDepth{0};
+  std::vector<Hoist> hoisted{};
+};
@@ -1,14 +1,20 @@
 #pragma once
 
+#include "constantFolder.hpp"
+#include "deadCodeEliminator.hpp"
 #include "environment.hpp"
 #include "errorReporter.hpp"
 #include "expression.hpp"
+#include "inliner.hpp"
 #include "interpreter.hpp"
+#include "loopHoister.hpp"
 #include "native.hpp"
 #include "parser.hpp"
 #include "persistentMap.hpp"
+#include "resolver.hpp"
 #include "scanner.hpp"
 #include "statement.hpp"
 #include "token.hpp"
+#include "virtualMachine.hpp"
 #include <fstream>
 #include <iomanip>
\ No newline at end of file
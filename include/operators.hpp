@@ -0,0 +1,135 @@
+#pragma once
+
+#include "environment.hpp"
+#include "token.hpp"
+#include "value.hpp"
+
+/**
+ * @brief Contains the semantics of Wick's operators, calls, and property
+ * accesses on values that were already evaluated, shared by every engine that
+ * runs Wick programs so they always agree.
+ *
+ */
+namespace operators {
+/**
+ * @brief A binary operator specialized to the types of the operands it was
+ * chosen for. It combines operands of those types into the left one and
+ * returns true, and returns false, changing neither, for any others.
+ *
+ */
+using BinaryOperation = bool (*)(Value &left, const Value &right);
+
+/**
+ * @brief A unary operator specialized to the type of the operand it was
+ * chosen for. It applies to an operand of that type in place and returns true,
+ * and returns false, leaving it unchanged, for any other.
+ *
+ */
+using UnaryOperation = bool (*)(Value &operand);
+
+/**
+ * @brief Determines whether a value counts as true in a condition.
+ *
+ * @param value
+ * @return true
+ * @return false
+ */
+bool isTrue(const Value &value);
+
+/**
+ * @brief Gets the truth of an operand of a logical operator. Throws error if
+ * it is not a boolean.
+ *
+ * @param operand
+ * @return true
+ * @return false
+ */
+bool logical(const Value &operand);
+
+/**
+ * @brief Applies a unary operator. Throws error if the operator does not apply
+ * to the value.
+ *
+ * @param op
+ * @param right
+ * @return Value
+ */
+Value unary(const Token::Type op, const Value &right);
+
+/**
+ * @brief Applies a binary operator. Integers stay integers for as long as the
+ * result is exact, and are combined with other numbers as numbers. Throws
+ * error if the operator does not apply to the values.
+ *
+ * @param left
+ * @param op
+ * @param right
+ * @return Value
+ */
+Value binary(const Value &left, const Token::Type op, const Value &right);
+
+/**
+ * @brief Chooses the specialization of a binary operator to the types of the
+ * given operands.
+ *
+ * @param op
+ * @param left
+ * @param right
+ * @return BinaryOperation The specialization, or nullptr if the operator has
+ * none for those types.
+ */
+BinaryOperation
+    specialize(const Token::Type op, const Value &left, const Value &right);
+
+/**
+ * @brief Chooses the specialization of a unary operator to the type of the
+ * given operand.
+ *
+ * @param op
+ * @param right
+ * @return UnaryOperation The specialization, or nullptr if the operator has
+ * none for that type.
+ */
+UnaryOperation specialize(const Token::Type op, const Value &right);
+
+/**
+ * @brief Checks that a subroutine can be called with the given number of
+ * arguments. Throws error if it can not.
+ *
+ * @param callable
+ * @param count
+ */
+void checkArity(const Callable &callable, const std::size_t count);
+
+/**
+ * @brief Calls a subroutine, or instantiates a prototype and calls its
+ * constructor. Throws error if the value can not be called with that many
+ * arguments.
+ *
+ * @param callee
+ * @param args
+ * @return std::optional<Value>
+ */
+std::optional<Value> call(const Value &callee, const std::vector<Value> &args);
+
+/**
+ * @brief Gets a public property of a prototype. Methods are bound to the
+ * instance they were taken from. Throws error if the property is private or
+ * does not exist.
+ *
+ * @param object
+ * @param property
+ * @return Value
+ */
+Value get(const Value &object, const Token &property);
+
+/**
+ * @brief Sets a public property of a prototype. Throws error if the property
+ * is private or does not exist.
+ *
+ * @param object
+ * @param property
+ * @param value
+ */
+void set(const Value &object, const Token &property, const Value &value);
+} // namespace operators
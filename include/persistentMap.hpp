@@ -1,5 +1,9 @@
 #pragma once
 
+#include <bitset>
+#include <cstdint>
+#include <functional>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <string>
@@ -9,16 +13,29 @@
  * @brief A persistent data structure implementation of a hash map. Used within
  * memory environments to deal with scope issues while reducing memory usage.
  *
+ * Implemented as a hash array mapped trie: every node branches 32 ways on five
+ * bits of the key's hash and only stores the children that are present. An
+ * insertion copies the O(log32 n) nodes on the path to the key and shares every
+ * other node with the original map.
+ *
+ * Entries themselves are shared between maps as well, so assigning to an entry
+ * is visible from every map that holds it.
+ *
+ * Bulk operations go through a Builder, which edits the nodes it created
+ * itself in place rather than copying the path for every key.
+ *
  * @tparam KeyType
  * @tparam ValueType
- * @tparam N
+ * @tparam Hash
  */
-template <typename KeyType, typename ValueType, std::size_t N = 1024>
+template <typename KeyType,
+          typename ValueType,
+          typename Hash = std::hash<KeyType>>
 class PersistentMap {
   public:
   using Entry = std::shared_ptr<std::pair<KeyType, ValueType>>;
 
-  using Table = std::array<std::vector<Entry>, N>;
+  class Builder;
 
   /**
    * @brief Constructs a new PersistentMap.
@@ -26,28 +43,16 @@ class PersistentMap {
    */
   PersistentMap() = default;
 
-  /**
-   * @brief Constructs a new PersistentMap based off a table of values.
-   *
-   * @param iTable
-   */
-  PersistentMap(const Table &iTable) : table{iTable} {}
-
   /**
    * @brief Inserts a new key and value pair into the table and returns the new
-   * map.
+   * map. Replaces the entry for the key if one already exists.
    *
    * @param key
    * @param value
    * @return PersistentMap
    */
-  PersistentMap insert(const KeyType &key, const ValueType &value) {
-    Table newTable{table};
-    const std::size_t hashIndex{std::hash<KeyType>{}(key) % N};
-    newTable[hashIndex].push_back(
-        std::make_shared<std::pair<KeyType, ValueType>>(
-            std::make_pair(key, value)));
-    return PersistentMap{newTable};
+  PersistentMap insert(const KeyType &key, const ValueType &value) const {
+    return insert(std::make_shared<std::pair<KeyType, ValueType>>(key, value));
   }
 
   /**
@@ -59,15 +64,10 @@ class PersistentMap {
    */
   std::optional<PersistentMap> assign(const KeyType &key,
                                       const ValueType &value) {
-    Table newTable{table};
-    const std::size_t hashIndex{std::hash<KeyType>{}(key) % N};
-    for(std::size_t i{0}; i < newTable[hashIndex].size(); i++) {
-      if(newTable[hashIndex][i]->first == key) {
-        newTable[hashIndex][i]->second = value;
-        return PersistentMap{newTable};
-      }
-    }
-    return {};
+    Entry entry{getEntry(key)};
+    if(!entry) return {};
+    entry->second = value;
+    return *this;
   }
 
   /**
@@ -77,10 +77,8 @@ class PersistentMap {
    * @return std::optional<ValueType>
    */
   std::optional<ValueType> get(const KeyType &key) const {
-    const std::size_t hashIndex{std::hash<KeyType>{}(key) % N};
-    for(std::size_t i{0}; i < table[hashIndex].size(); i++) {
-      if(table[hashIndex][i]->first == key) return table[hashIndex][i]->second;
-    }
+    const Entry *entry{find(key)};
+    if(entry) return (*entry)->second;
     return {};
   }
 
@@ -91,10 +89,8 @@ class PersistentMap {
    * @return Entry
    */
   Entry getEntry(const KeyType &key) const {
-    const std::size_t hashIndex{std::hash<KeyType>{}(key) % N};
-    for(std::size_t i{0}; i < table[hashIndex].size(); i++) {
-      if(table[hashIndex][i]->first == key) return table[hashIndex][i];
-    }
+    const Entry *entry{find(key)};
+    if(entry) return *entry;
     return nullptr;
   }
 
@@ -105,31 +101,295 @@ class PersistentMap {
    * @param other
    * @return PersistentMap
    */
-  PersistentMap copyOver(const PersistentMap &other) {
-    PersistentMap newMap{table};
-    for(std::vector<Entry> entries : other.table) {
-      for(Entry entry : entries)
-        newMap = newMap.insert(entry->first, entry->second);
-    }
-    return newMap;
+  PersistentMap copyOver(const PersistentMap &other) const {
+    // Copying into an empty map keeps the other map's shape, so its nodes can
+    // be cloned without hashing a single key.
+    if(!root) return PersistentMap{other.root ? clone(*other.root) : nullptr,
+                                   other.count};
+    Builder builder{*this};
+    other.forEach([&builder](const Entry &entry) {
+      builder.insert(entry->first, entry->second);
+    });
+    return builder.build();
   }
 
   /**
-   * @brief Combines several maps into one new PersistentMap.
+   * @brief Combines several maps into one new PersistentMap. Entries are
+   * shared with the original maps and, for duplicate keys, the entry from the
+   * earliest map is kept.
    *
    * @param maps
    * @return PersistentMap
    */
   static PersistentMap unionize(const std::vector<PersistentMap> &maps) {
-    Table newTable{};
-    for(std::size_t i{0}; i < newTable.size(); i++) {
-      for(PersistentMap map : maps) {
-        for(Entry entry : map.table[i]) newTable[i].push_back(entry);
+    if(maps.empty()) return PersistentMap{};
+    // The last map loses every conflict, so the union can start out sharing
+    // all of its nodes.
+    Builder builder{maps.back()};
+    for(auto map{maps.rbegin() + 1}; map != maps.rend(); map++)
+      map->forEach([&builder](const Entry &entry) { builder.insert(entry); });
+    return builder.build();
+  }
+
+  /**
+   * @brief Gets the number of entries within the map.
+   *
+   * @return std::size_t
+   */
+  std::size_t size() const {
+    return count;
+  }
+
+  /**
+   * @brief Calls the given function with every entry within the map.
+   *
+   * @param fn
+   */
+  template <typename Function>
+  void forEach(Function fn) const {
+    if(root) forEach(*root, fn);
+  }
+
+  private:
+  static constexpr std::size_t bitsPerLevel{5};
+  static constexpr std::size_t hashBits{
+      std::numeric_limits<std::size_t>::digits};
+
+  struct Node;
+  using NodePtr = std::shared_ptr<Node>;
+
+  /**
+   * @brief A trie node. The entry map marks which of the 32 branches hold an
+   * entry directly and the node map marks which hold a child node. Once the
+   * hash bits run out the node becomes a plain list of colliding entries.
+   * Nodes are never modified once a map holds them; only the builder that
+   * owns a node may edit it.
+   *
+   */
+  struct Node {
+    std::uint32_t entryMap{0};
+    std::uint32_t nodeMap{0};
+    std::vector<Entry> entries;
+    std::vector<NodePtr> nodes;
+    std::size_t owner{0};
+  };
+
+  // Nodes owned by no builder, which are always copied before being edited.
+  static constexpr std::size_t persistent{0};
+
+  PersistentMap(NodePtr iRoot, const std::size_t iCount) :
+      root{std::move(iRoot)}, count{iCount} {}
+
+  PersistentMap insert(const Entry &entry) const {
+    bool added{false};
+    NodePtr newRoot{root};
+    insert(newRoot, 0, hash(entry->first), entry, added, persistent);
+    return PersistentMap{std::move(newRoot), count + (added ? 1 : 0)};
+  }
+
+  const Entry *find(const KeyType &key) const {
+    const Node *node{root.get()};
+    const std::size_t keyHash{hash(key)};
+    for(std::size_t shift{0}; node; shift += bitsPerLevel) {
+      if(shift >= hashBits) {
+        for(const Entry &entry : node->entries)
+          if(entry->first == key) return &entry;
+        return nullptr;
+      }
+      const std::uint32_t bit{branch(keyHash, shift)};
+      if(node->entryMap & bit) {
+        const Entry &entry{node->entries[index(node->entryMap, bit)]};
+        return entry->first == key ? &entry : nullptr;
       }
+      if(!(node->nodeMap & bit)) return nullptr;
+      node = node->nodes[index(node->nodeMap, bit)].get();
     }
-    return newTable;
+    return nullptr;
+  }
+
+  static void insert(NodePtr &node,
+                     const std::size_t shift,
+                     const std::size_t keyHash,
+                     const Entry &entry,
+                     bool &added,
+                     const std::size_t owner) {
+    Node &newNode{editable(node, owner)};
+    if(shift >= hashBits) {
+      for(Entry &existing : newNode.entries) {
+        if(existing->first == entry->first) {
+          existing = entry;
+          return;
+        }
+      }
+      newNode.entries.push_back(entry);
+      added = true;
+      return;
+    }
+    const std::uint32_t bit{branch(keyHash, shift)};
+    if(newNode.entryMap & bit) {
+      const std::size_t i{index(newNode.entryMap, bit)};
+      Entry existing{newNode.entries[i]};
+      if(existing->first == entry->first) {
+        newNode.entries[i] = entry;
+        return;
+      }
+      newNode.entries.erase(newNode.entries.begin() + i);
+      newNode.entryMap &= ~bit;
+      newNode.nodeMap |= bit;
+      newNode.nodes.insert(newNode.nodes.begin() + index(newNode.nodeMap, bit),
+                           merge(existing,
+                                 hash(existing->first),
+                                 entry,
+                                 keyHash,
+                                 shift + bitsPerLevel,
+                                 owner));
+      added = true;
+    } else if(newNode.nodeMap & bit) {
+      insert(newNode.nodes[index(newNode.nodeMap, bit)],
+             shift + bitsPerLevel,
+             keyHash,
+             entry,
+             added,
+             owner);
+    } else {
+      newNode.entryMap |= bit;
+      newNode.entries.insert(
+          newNode.entries.begin() + index(newNode.entryMap, bit), entry);
+      added = true;
+    }
+  }
+
+  static Node &editable(NodePtr &node, const std::size_t owner) {
+    if(node && owner != persistent && node->owner == owner) return *node;
+    node = node ? std::make_shared<Node>(*node) : std::make_shared<Node>();
+    node->owner = owner;
+    return *node;
+  }
+
+  static NodePtr clone(const Node &node) {
+    NodePtr newNode{std::make_shared<Node>()};
+    newNode->entryMap = node.entryMap;
+    newNode->nodeMap = node.nodeMap;
+    newNode->entries.reserve(node.entries.size());
+    for(const Entry &entry : node.entries)
+      newNode->entries.push_back(
+          std::make_shared<std::pair<KeyType, ValueType>>(*entry));
+    newNode->nodes.reserve(node.nodes.size());
+    for(const NodePtr &child : node.nodes)
+      newNode->nodes.push_back(clone(*child));
+    return newNode;
+  }
+
+  static std::size_t nextOwner() {
+    static std::size_t owners{persistent};
+    return ++owners;
+  }
+
+  static NodePtr merge(const Entry &first,
+                       const std::size_t firstHash,
+                       const Entry &second,
+                       const std::size_t secondHash,
+                       const std::size_t shift,
+                       const std::size_t owner) {
+    NodePtr node{std::make_shared<Node>()};
+    node->owner = owner;
+    if(shift >= hashBits) {
+      node->entries = {first, second};
+      return node;
+    }
+    const std::uint32_t firstBit{branch(firstHash, shift)};
+    const std::uint32_t secondBit{branch(secondHash, shift)};
+    if(firstBit == secondBit) {
+      node->nodeMap = firstBit;
+      node->nodes.push_back(merge(
+          first, firstHash, second, secondHash, shift + bitsPerLevel, owner));
+    } else {
+      node->entryMap = firstBit | secondBit;
+      node->entries = firstBit < secondBit ? std::vector<Entry>{first, second}
+                                           : std::vector<Entry>{second, first};
+    }
+    return node;
+  }
+
+  template <typename Function>
+  static void forEach(const Node &node, Function &fn) {
+    for(const Entry &entry : node.entries) fn(entry);
+    for(const NodePtr &child : node.nodes) forEach(*child, fn);
+  }
+
+  static std::size_t hash(const KeyType &key) {
+    return Hash{}(key);
+  }
+
+  static std::uint32_t branch(const std::size_t keyHash,
+                              const std::size_t shift) {
+    return std::uint32_t{1} << ((keyHash >> shift) & 0x1f);
+  }
+
+  static std::size_t index(const std::uint32_t map, const std::uint32_t bit) {
+    return std::bitset<32>{map & (bit - 1)}.count();
+  }
+
+  NodePtr root{nullptr};
+  std::size_t count{0};
+};
+
+/**
+ * @brief Builds a PersistentMap through a series of insertions. The builder
+ * edits the nodes it created in place, so inserting k keys allocates at most
+ * one node per level for each rather than copying a whole path every time. The
+ * map it was started from is left untouched.
+ *
+ * @tparam KeyType
+ * @tparam ValueType
+ * @tparam Hash
+ */
+template <typename KeyType, typename ValueType, typename Hash>
+class PersistentMap<KeyType, ValueType, Hash>::Builder {
+  public:
+  /**
+   * @brief Constructs a builder starting from the given map.
+   *
+   * @param map
+   */
+  explicit Builder(const PersistentMap &map = PersistentMap{}) :
+      root{map.root}, count{map.count}, owner{nextOwner()} {}
+
+  /**
+   * @brief Inserts a new entry for the key, replacing any existing one.
+   *
+   * @param key
+   * @param value
+   */
+  void insert(const KeyType &key, const ValueType &value) {
+    insert(std::make_shared<std::pair<KeyType, ValueType>>(key, value));
+  }
+
+  /**
+   * @brief Inserts an entry shared with another map, replacing any existing
+   * entry for its key.
+   *
+   * @param entry
+   */
+  void insert(const Entry &entry) {
+    bool added{false};
+    PersistentMap::insert(root, 0, hash(entry->first), entry, added, owner);
+    if(added) count++;
+  }
+
+  /**
+   * @brief Returns the map built so far. Later insertions copy the nodes the
+   * returned map holds rather than editing them.
+   *
+   * @return PersistentMap
+   */
+  PersistentMap build() {
+    owner = nextOwner();
+    return PersistentMap{root, count};
   }
 
   private:
-  Table table;
-};
\ No newline at end of file
+  NodePtr root;
+  std::size_t count;
+  std::size_t owner;
+};
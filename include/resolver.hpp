@@ -0,0 +1,328 @@
+#pragma once
+
+#include "errorReporter.hpp"
+#include "expression.hpp"
+#include "globalEnvironment.hpp"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+/**
+ * @brief Class responsible for the static pass between parsing and
+ * interpretation. Walks the parse tree once and binds every variable to the
+ * environment depth and slot it will live in at runtime, so the interpreter
+ * never has to search for variables by name. Undefined variables and
+ * assignments to constants are reported here rather than at runtime.
+ *
+ */
+class Resolver :
+    public Expression::Expression::Visitor,
+    public Statement::Statement::Visitor {
+  public:
+  /**
+   * @brief Constructs a resolver for programs that will run with the given
+   * global environment (which holds the native subroutines and constants).
+   * The program's globals are given their slots in it once it is resolved.
+   *
+   * @param iGlobals
+   * @param iErrorReporter
+   */
+  explicit Resolver(GlobalEnvironment *const iGlobals,
+                    ErrorReporter *const iErrorReporter = nullptr);
+
+  /**
+   * @brief Resolves every variable within a series of statements.
+   *
+   * @param statements
+   */
+  void resolve(const std::vector<Statement::StatementUPtr> &statements);
+
+  /**
+   * @brief Nothing to resolve within a literal.
+   *
+   * @param literal
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Literal &literal,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Resolves the operand of a unary expression.
+   *
+   * @param unary
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Unary &unary,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Resolves both operands of a binary expression.
+   *
+   * @param binary
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Binary &binary,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Resolves both operands of a logical expression.
+   *
+   * @param logical
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Logical &logical,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Resolves the expression within a group.
+   *
+   * @param group
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Group &group,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Resolves each part of a ternary expression.
+   *
+   * @param ternary
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Ternary &ternary,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Binds a variable expression to where the variable lives.
+   *
+   * @param variable
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Variable &variable,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Binds an assignment to where the variable lives and makes sure it
+   * is not a constant.
+   *
+   * @param assignment
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Assignment &assignment,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Resolves the callee and arguments of a call expression.
+   *
+   * @param call
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Call &call,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Resolves the parameters and body of a lambda in a new scope. A
+   * lambda without parameters needs no scope of its own. Outside of prototypes
+   * the variables a lambda uses from enclosing scopes are captured one by one;
+   * within them it closes over its whole scope, which dynamic lookups need.
+   *
+   * @param lambda
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Lambda &lambda,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Resolves a prototype. Its properties are only known by name at
+   * runtime (they may be inherited), so they are looked up dynamically.
+   *
+   * @param prototype
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Prototype &prototype,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Resolves the object and value of a set expression.
+   *
+   * @param set
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Set &set,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Resolves the object of a get expression.
+   *
+   * @param get
+   * @param env
+   * @param result
+   * @return true
+   * @return false
+   */
+  bool visit(const Expression::Get &get,
+             Environment *env,
+             Value &result) override;
+
+  /**
+   * @brief Resolves an expression statement.
+   *
+   * @param expr
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::Expression &expr,
+                              Environment *env) override;
+
+  /**
+   * @brief Declares a variable in the current scope and resolves its
+   * initializer.
+   *
+   * @param variable
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::Variable &variable,
+                              Environment *env) override;
+
+  /**
+   * @brief Resolves the statements of a scope in a new scope, unless the scope
+   * declares nothing and can share the enclosing one.
+   *
+   * @param scope
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::Scope &scope,
+                              Environment *env) override;
+
+  /**
+   * @brief Resolves the condition and branches of an if statement.
+   *
+   * @param ifStmt
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::If &ifStmt,
+                              Environment *env) override;
+
+  /**
+   * @brief Resolves a for statement in a new scope when it declares a loop
+   * variable.
+   *
+   * @param forStmt
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::For &forStmt,
+                              Environment *env) override;
+
+  /**
+   * @brief Resolves the returned expression.
+   *
+   * @param returnStmt
+   * @param env
+   * @return Statement::Completion
+   */
+  Statement::Completion visit(const Statement::Return &returnStmt,
+                              Environment *env) override;
+
+  private:
+  struct Declaration {
+    std::size_t slot;
+    bool constant;
+    bool boxed{false};
+    std::vector<Binding *> uses{};
+  };
+
+  struct GlobalDeclaration {
+    std::size_t slot;
+    bool constant;
+  };
+
+  struct Scope {
+    bool dynamic{false};
+    bool captured{false};
+    std::unordered_map<SymbolId, Declaration> declarations{};
+  };
+
+  // A lambda that captures its free variables rather than its whole scope.
+  struct Function {
+    std::size_t base;
+    std::vector<Binding> *captures;
+    std::unordered_map<const Declaration *, std::size_t> indices{};
+  };
+
+  void resolve(Expression::Expression *expr);
+
+  void resolve(Statement::Statement *statement);
+
+  void beginScope(const bool dynamic = false);
+
+  FrameLayout endScope();
+
+  void captureScopes();
+
+  void declare(const Token &variable, Binding &binding);
+
+  void bind(const Token &variable, const bool assigning, Binding &binding);
+
+  void use(Declaration &declaration, const std::size_t index, Binding &binding);
+
+  void box(Declaration &declaration);
+
+  GlobalEnvironment *const globals;
+  ErrorReporter *const errorReporter;
+  std::vector<Scope> scopes{};
+  std::vector<Function> functions{};
+  std::unordered_map<SymbolId, GlobalDeclaration> globalDeclarations{};
+  std::unordered_set<SymbolId> definedGlobals{};
+  std::size_t functionDepth{0};
+};
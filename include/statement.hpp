@@ -9,7 +9,8 @@ using ExpressionUPtr = std::unique_ptr<Expression>;
 } // namespace Expression
 
 /**
- * @brief Contains the grammar rules for Wick statements.
+ * @brief Contains the grammar rules for Wick statements. The children of
+ * nodes are mutable so optimization passes can rewrite the tree in place.
  *
  */
 namespace Statement {
@@ -21,6 +22,14 @@ struct If;
 struct For;
 struct Return;
 
+/**
+ * @brief How running a statement ended. Returns are passed up through every
+ * enclosing statement as a completion rather than thrown, until the call they
+ * return from sees it.
+ *
+ */
+enum class Completion { Normal, Return };
+
 /**
  * @brief Parent class of all statements. Enforces accept method.
  *
@@ -37,48 +46,54 @@ struct Statement {
      *
      * @param expr
      * @param env
+     * @return Completion
      */
-    virtual void visit(const Expression &expr, Environment *env) = 0;
+    virtual Completion visit(const Expression &expr, Environment *env) = 0;
 
     /**
      * @brief Visits a variable declaration/definition.
      *
      * @param var
      * @param env
+     * @return Completion
      */
-    virtual void visit(const Variable &var, Environment *env) = 0;
+    virtual Completion visit(const Variable &var, Environment *env) = 0;
 
     /**
      * @brief Visits a scope (code block surrounded by '{' and '}').
      *
      * @param scope
      * @param env
+     * @return Completion
      */
-    virtual void visit(const Scope &scope, Environment *env) = 0;
+    virtual Completion visit(const Scope &scope, Environment *env) = 0;
 
     /**
      * @brief Visits an if-then statement.
      *
      * @param ifStmt
      * @param env
+     * @return Completion
      */
-    virtual void visit(const If &ifStmt, Environment *env) = 0;
+    virtual Completion visit(const If &ifStmt, Environment *env) = 0;
 
     /**
      * @brief Visits a for loop statement.
      *
      * @param forStmt
      * @param env
+     * @return Completion
      */
-    virtual void visit(const For &forStmt, Environment *env) = 0;
+    virtual Completion visit(const For &forStmt, Environment *env) = 0;
 
     /**
      * @brief Visits a return statement.
      *
      * @param returnStmt
      * @param env
+     * @return Completion
      */
-    virtual void visit(const Return &returnStmt, Environment *env) = 0;
+    virtual Completion visit(const Return &returnStmt, Environment *env) = 0;
   };
 
   /**
@@ -86,9 +101,9 @@ struct Statement {
    *
    * @param visitor
    * @param env
-   * @return std::optional<std::any>
+   * @return Completion
    */
-  virtual void accept(Visitor *visitor, Environment *env) = 0;
+  virtual Completion accept(Visitor *visitor, Environment *env) = 0;
 
   // Needed to free memory in children.
   virtual ~Statement() = default;
@@ -109,9 +124,9 @@ struct Expression : Statement {
    */
   explicit Expression(::Expression::ExpressionUPtr iExpr);
 
-  const ::Expression::ExpressionUPtr expr;
+  mutable ::Expression::ExpressionUPtr expr;
 
-  void accept(Visitor *visitor, Environment *env) override;
+  Completion accept(Visitor *visitor, Environment *env) override;
 };
 
 /**
@@ -128,9 +143,10 @@ struct Variable : Statement {
   Variable(const Token &iVariable, ::Expression::ExpressionUPtr iInitializer);
 
   const Token variable;
-  const ::Expression::ExpressionUPtr initializer;
+  mutable ::Expression::ExpressionUPtr initializer;
+  mutable Binding binding{}; // Filled in by the resolver.
 
-  void accept(Visitor *visitor, Environment *env) override;
+  Completion accept(Visitor *visitor, Environment *env) override;
 };
 
 /**
@@ -145,9 +161,10 @@ struct Scope : Statement {
    */
   Scope(std::vector<StatementUPtr> iStatements);
 
-  const std::vector<StatementUPtr> statements;
+  mutable std::vector<StatementUPtr> statements;
+  mutable FrameLayout layout{}; // Filled in by the resolver.
 
-  void accept(Visitor *visitor, Environment *env) override;
+  Completion accept(Visitor *visitor, Environment *env) override;
 };
 
 /**
@@ -167,11 +184,11 @@ struct If : Statement {
      StatementUPtr iThen,
      StatementUPtr iElse);
 
-  const ::Expression::ExpressionUPtr condition;
-  const StatementUPtr thenStmt;
-  const StatementUPtr elseStmt;
+  mutable ::Expression::ExpressionUPtr condition;
+  mutable StatementUPtr thenStmt;
+  mutable StatementUPtr elseStmt;
 
-  void accept(Visitor *visitor, Environment *env) override;
+  Completion accept(Visitor *visitor, Environment *env) override;
 };
 
 /**
@@ -193,12 +210,13 @@ struct For : Statement {
       StatementUPtr iBody,
       StatementUPtr iUpdate);
 
-  const StatementUPtr initializer;
-  const ::Expression::ExpressionUPtr condition;
-  const StatementUPtr body;
-  const StatementUPtr update;
+  mutable StatementUPtr initializer;
+  mutable ::Expression::ExpressionUPtr condition;
+  mutable StatementUPtr body;
+  mutable StatementUPtr update;
+  mutable FrameLayout layout{}; // Filled in by the resolver.
 
-  void accept(Visitor *visitor, Environment *env) override;
+  Completion accept(Visitor *visitor, Environment *env) override;
 };
 
 /**
@@ -215,9 +233,9 @@ struct Return : Statement {
   Return(const Token &iKeyword, ::Expression::ExpressionUPtr iExpr);
 
   const Token keyword; // Used for providing better error messages.
-  const ::Expression::ExpressionUPtr expr;
+  mutable ::Expression::ExpressionUPtr expr;
 
-  void accept(Visitor *visitor, Environment *env) override;
+  Completion accept(Visitor *visitor, Environment *env) override;
 };
 
 } // namespace Statement
\ No newline at end of file
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+class Value;
+
+/**
+ * @brief The contents of a Wick string. Strings are immutable and shared by
+ * every value holding them, so passing one around never copies its bytes. The
+ * hash is computed once and cached, and strings interned through
+ * Value::interned (like every string literal) exist once per contents, so two
+ * of them are equal only if they are the same object.
+ *
+ * Concatenating long strings makes a rope that refers to both operands instead
+ * of copying them, and is flattened into contiguous bytes only once something
+ * reads them. Building a string piece by piece in a loop is then linear rather
+ * than quadratic in its length.
+ *
+ */
+class String {
+  public:
+  /**
+   * @brief The combined length from which concatenations make a rope rather
+   * than copying their operands.
+   *
+   */
+  static constexpr std::size_t ropeLength{256};
+
+  /**
+   * @brief Constructs a string with the given contents.
+   *
+   * @param iContents
+   * @param iInterned
+   */
+  explicit String(std::string iContents, const bool iInterned = false);
+
+  /**
+   * @brief Constructs the rope concatenating two string values.
+   *
+   * @param left
+   * @param right
+   */
+  String(const Value &left, const Value &right);
+
+  String(String &&other) noexcept;
+
+  String &operator=(String &&other) = delete;
+
+  ~String();
+
+  /**
+   * @brief Gets the bytes of the string, flattening it if it is a rope.
+   *
+   * @return const std::string&
+   */
+  const std::string &text() const {
+    if(parts) flatten();
+    return contents;
+  }
+
+  /**
+   * @brief Gets the length of the string in bytes.
+   *
+   * @return std::size_t
+   */
+  std::size_t length() const noexcept { return size; }
+
+  /**
+   * @brief Checks whether the bytes of the string are contiguous, which they
+   * are unless it is a rope that was not read yet.
+   *
+   * @return true
+   * @return false
+   */
+  bool flat() const noexcept { return !parts; }
+
+  /**
+   * @brief Gets the hash of the string, computing it on first use.
+   *
+   * @return std::size_t
+   */
+  std::size_t hash() const;
+
+  /**
+   * @brief Checks whether the string is the interned copy of its contents.
+   *
+   * @return true
+   * @return false
+   */
+  bool interned() const noexcept { return isInterned; }
+
+  /**
+   * @brief Compares the contents of two strings, comparing as little of them
+   * as possible.
+   *
+   * @param other
+   * @return true
+   * @return false
+   */
+  bool operator==(const String &other) const;
+
+  bool operator!=(const String &other) const { return !(*this == other); }
+
+  private:
+  struct Concatenation;
+
+  void flatten() const;
+
+  static void release(std::unique_ptr<Concatenation> rope) noexcept;
+
+  mutable std::string contents;
+  mutable std::unique_ptr<Concatenation> parts{nullptr};
+  std::size_t size;
+  mutable std::size_t hashValue{0};
+  mutable bool hashed{false};
+  bool isInterned{false};
+};
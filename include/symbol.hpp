@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief A dense integer standing in for an identifier. Identifiers with the
+ * same name always have the same id, so they can be hashed and compared as a
+ * single word.
+ *
+ */
+using SymbolId = std::uint32_t;
+
+/**
+ * @brief The process-wide table of interned identifiers. Ids are handed out in
+ * order and never released, so an identifier keeps its id across every script
+ * run in the same process.
+ *
+ */
+class Symbols {
+  public:
+  /**
+   * @brief The id of tokens that are not identifiers.
+   *
+   */
+  static constexpr SymbolId none{0};
+
+  /**
+   * @brief Returns the id of the given name, giving it the next id if it has
+   * not been seen before.
+   *
+   * @param name
+   * @return SymbolId
+   */
+  static SymbolId intern(const std::string &name);
+
+  /**
+   * @brief Returns the name an id was interned from.
+   *
+   * @param symbol
+   * @return const std::string&
+   */
+  static const std::string &name(const SymbolId symbol);
+
+  /**
+   * @brief Returns how many names have been interned.
+   *
+   * @return std::size_t
+   */
+  static std::size_t size();
+
+  private:
+  struct Table {
+    std::unordered_map<std::string, SymbolId> ids{};
+    std::vector<const std::string *> names{nullptr};
+  };
+
+  static Table &table();
+};
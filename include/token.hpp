@@ -1,11 +1,13 @@
 #pragma once
 
+#include "symbol.hpp"
 #include <array>
 #include <iostream>
 #include <vector>
 
 /**
- * @brief Structure for representing Wick tokens.
+ * @brief Structure for representing Wick tokens. Identifiers are interned when
+ * they are constructed so they can be hashed and compared by their symbol.
  *
  */
 struct Token {
@@ -59,10 +61,33 @@ struct Token {
     Private,
     Colon,
     Error // Error needs to always be at the bottom of the list!
-  } type;
+  } type{Type::Error};
   bool constant{true};
   int line{-1};
   int col{-1};
+  SymbolId symbol{Symbols::none};
+
+  /**
+   * @brief Constructs an empty token.
+   *
+   */
+  Token() = default;
+
+  /**
+   * @brief Constructs a new token, interning its lexeme if it is an
+   * identifier.
+   *
+   * @param iLexeme
+   * @param iType
+   * @param iConstant
+   * @param iLine
+   * @param iCol
+   */
+  Token(std::string iLexeme,
+        const Type iType,
+        const bool iConstant = true,
+        const int iLine = -1,
+        const int iCol = -1);
 
   /**
    * @brief Returns true if the type matches the tokens type.
@@ -74,7 +99,8 @@ struct Token {
   bool operator==(const Type rhs) const;
 
   /**
-   * @brief Returns true if the lexeme and types are the same.
+   * @brief Returns true if the lexeme and types are the same. Identifiers only
+   * compare their symbols.
    *
    * @param rhs
    * @return true
@@ -84,13 +110,15 @@ struct Token {
 };
 
 /**
- * @brief Used to hash tokens for the PersistentMap implementation.
+ * @brief Used to hash tokens for the PersistentMap implementation. Identifiers
+ * hash their symbol rather than their lexeme.
  *
  * @tparam
  */
 template <>
 struct std::hash<Token> {
   std::size_t operator()(const Token &token) const noexcept {
+    if(token.symbol != Symbols::none) return std::hash<SymbolId>{}(token.symbol);
     return std::hash<std::string>{}(token.lexeme);
   }
 };
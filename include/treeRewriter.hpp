@@ -0,0 +1,293 @@
+#pragma once
+
+#include "expression.hpp"
+#include <unordered_map>
+
+/**
+ * @brief Base of the passes that rewrite parsed trees before they are
+ * resolved. By default every visit rewrites the children of its node in the
+ * order they run and changes nothing else, so a pass only overrides the visits
+ * of the nodes it changes or learns from.
+ *
+ * A visit replaces its own node by calling replace(), and expression visits
+ * return whatever the pass wants to tell the node's parent about it.
+ *
+ */
+class TreeRewriter :
+    public Expression::Expression::Visitor,
+    public Statement::Statement::Visitor {
+  public:
+  /**
+   * @brief Rewrites every statement of a program.
+   *
+   * @param statements
+   */
+  virtual void rewrite(std::vector<Statement::StatementUPtr> &statements);
+
+  bool visit(const Expression::Literal &literal,
+             Environment *env,
+             Value &result) override;
+
+  bool visit(const Expression::Unary &unary,
+             Environment *env,
+             Value &result) override;
+
+  bool visit(const Expression::Binary &binary,
+             Environment *env,
+             Value &result) override;
+
+  bool visit(const Expression::Logical &logical,
+             Environment *env,
+             Value &result) override;
+
+  bool visit(const Expression::Group &group,
+             Environment *env,
+             Value &result) override;
+
+  bool visit(const Expression::Ternary &ternary,
+             Environment *env,
+             Value &result) override;
+
+  bool visit(const Expression::Variable &variable,
+             Environment *env,
+             Value &result) override;
+
+  bool visit(const Expression::Assignment &assignment,
+             Environment *env,
+             Value &result) override;
+
+  bool visit(const Expression::Call &call,
+             Environment *env,
+             Value &result) override;
+
+  bool visit(const Expression::Lambda &lambda,
+             Environment *env,
+             Value &result) override;
+
+  bool visit(const Expression::Prototype &prototype,
+             Environment *env,
+             Value &result) override;
+
+  bool visit(const Expression::Set &set,
+             Environment *env,
+             Value &result) override;
+
+  bool visit(const Expression::Get &get,
+             Environment *env,
+             Value &result) override;
+
+  Statement::Completion visit(const Statement::Expression &expr,
+                              Environment *env) override;
+
+  Statement::Completion visit(const Statement::Variable &variable,
+                              Environment *env) override;
+
+  Statement::Completion visit(const Statement::Scope &scope,
+                              Environment *env) override;
+
+  Statement::Completion visit(const Statement::If &ifStmt,
+                              Environment *env) override;
+
+  Statement::Completion visit(const Statement::For &forStmt,
+                              Environment *env) override;
+
+  Statement::Completion visit(const Statement::Return &returnStmt,
+                              Environment *env) override;
+
+  virtual ~TreeRewriter() = default;
+
+  protected:
+  /**
+   * @brief Visits an expression, putting what replaced it in its place.
+   *
+   * @param expr
+   * @param result
+   * @return true
+   * @return false What the visit returned, or false if there is no
+   * expression.
+   */
+  bool rewrite(Expression::ExpressionUPtr &expr, Value &result);
+
+  /**
+   * @brief Visits an expression, putting what replaced it in its place.
+   *
+   * @param expr
+   * @return true
+   * @return false What the visit returned, or false if there is no
+   * expression.
+   */
+  bool rewrite(Expression::ExpressionUPtr &expr);
+
+  /**
+   * @brief Visits a statement, putting what replaced it in its place.
+   *
+   * @param statement
+   */
+  void rewrite(Statement::StatementUPtr &statement);
+
+  /**
+   * @brief Visits each statement of a series in order, removing those replaced
+   * by nothing.
+   *
+   * @param statements
+   */
+  void rewriteEach(std::vector<Statement::StatementUPtr> &statements);
+
+  /**
+   * @brief Replaces the expression being visited. Visits replace their node
+   * once they are done rewriting its children.
+   *
+   * @param replacement
+   */
+  void replace(Expression::ExpressionUPtr replacement);
+
+  /**
+   * @brief Replaces the statement being visited, or removes it if the
+   * replacement is null. Visits replace their node once they are done
+   * rewriting its children.
+   *
+   * @param replacement
+   */
+  void replace(Statement::StatementUPtr replacement);
+
+  /**
+   * @brief The kinds of scope a pass can be within. Blocks are the scopes of
+   * braced statements, and names within prototypes may refer to inherited
+   * properties no scope declares.
+   *
+   */
+  enum class ScopeKind { Plain, Block, Prototype };
+
+  /**
+   * @brief The lexical scopes a pass is within, innermost last, with what the
+   * pass knows of each name they declare.
+   *
+   * @tparam Declaration
+   */
+  template <typename Declaration>
+  class Scopes {
+    public:
+    /**
+     * @brief Enters a scope that declares nothing yet.
+     *
+     * @param kind
+     */
+    void push(const ScopeKind kind = ScopeKind::Plain);
+
+    /**
+     * @brief Leaves the innermost scope.
+     *
+     */
+    void pop();
+
+    /**
+     * @brief Gets the kind of the innermost scope.
+     *
+     * @return ScopeKind
+     */
+    ScopeKind innermost() const;
+
+    /**
+     * @brief Declares a name in the innermost scope, replacing what was known
+     * of any earlier declaration of it there.
+     *
+     * @param symbol
+     * @param declaration
+     */
+    void declare(const SymbolId symbol, Declaration declaration);
+
+    /**
+     * @brief Finds what the innermost scope declaring a name knows of it.
+     * Within a prototype a name it does not declare may be inherited, which
+     * sets inherited and finds nothing.
+     *
+     * @param symbol
+     * @param inherited
+     * @return const Declaration* Nothing if no scope declares the name.
+     */
+    const Declaration *lookup(const SymbolId symbol, bool &inherited) const;
+
+    /**
+     * @brief Finds what the innermost scope declaring a name knows of it.
+     *
+     * @param symbol
+     * @return const Declaration* Nothing if no scope declares the name, or it
+     * may be inherited.
+     */
+    const Declaration *lookup(const SymbolId symbol) const;
+
+    /**
+     * @brief Finds what the outermost scope knows of a name it declares.
+     *
+     * @param symbol
+     * @return const Declaration* Nothing if it does not declare the name.
+     */
+    const Declaration *outermost(const SymbolId symbol) const;
+
+    private:
+    struct Scope {
+      ScopeKind kind;
+      std::unordered_map<SymbolId, Declaration> declarations{};
+    };
+
+    std::vector<Scope> scopes{};
+  };
+
+  private:
+  Expression::ExpressionUPtr replacedExpression{};
+  std::optional<Statement::StatementUPtr> replacedStatement{};
+};
+
+template <typename Declaration>
+void TreeRewriter::Scopes<Declaration>::push(const ScopeKind kind) {
+  scopes.push_back(Scope{kind});
+}
+
+template <typename Declaration>
+void TreeRewriter::Scopes<Declaration>::pop() {
+  scopes.pop_back();
+}
+
+template <typename Declaration>
+TreeRewriter::ScopeKind TreeRewriter::Scopes<Declaration>::innermost() const {
+  return scopes.back().kind;
+}
+
+template <typename Declaration>
+void TreeRewriter::Scopes<Declaration>::declare(const SymbolId symbol,
+                                                Declaration declaration) {
+  scopes.back().declarations[symbol] = std::move(declaration);
+}
+
+template <typename Declaration>
+const Declaration *
+    TreeRewriter::Scopes<Declaration>::lookup(const SymbolId symbol,
+                                              bool &inherited) const {
+  inherited = false;
+  for(auto scope{scopes.rbegin()}; scope != scopes.rend(); scope++) {
+    auto declaration{scope->declarations.find(symbol)};
+    if(declaration != scope->declarations.end()) return &declaration->second;
+    // Within prototypes unknown names may be inherited properties.
+    if(scope->kind == ScopeKind::Prototype) {
+      inherited = true;
+      return nullptr;
+    }
+  }
+  return nullptr;
+}
+
+template <typename Declaration>
+const Declaration *
+    TreeRewriter::Scopes<Declaration>::lookup(const SymbolId symbol) const {
+  bool inherited{false};
+  return lookup(symbol, inherited);
+}
+
+template <typename Declaration>
+const Declaration *
+    TreeRewriter::Scopes<Declaration>::outermost(const SymbolId symbol) const {
+  auto declaration{scopes.front().declarations.find(symbol)};
+  return declaration == scopes.front().declarations.end()
+             ? nullptr
+             : &declaration->second;
+}
@@ -0,0 +1,432 @@
+#pragma once
+
+#include "string.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+class Environment;
+class Value;
+
+/**
+ * @brief The type all non-integral numbers in Wick have. Extended precision by
+ * default; configuring with WICK_DOUBLE_NUMBERS trades the precision for
+ * doubles, which are faster for the math natives and can be vectorized.
+ *
+ */
+#ifdef WICK_DOUBLE_NUMBERS
+using Number = double;
+#else
+using Number = long double;
+#endif
+
+/**
+ * @brief A subroutine's implementation. Receives the arguments it was called
+ * with and the environment it runs in.
+ *
+ */
+using Procedure = std::function<std::optional<Value>(
+    const std::vector<Value> &args, Environment *fnEnv)>;
+
+/**
+ * @brief The structure for callable objects in Wick. Has a minimum and maximum
+ * arity (the number of allowed parameters) as well as the environment at the
+ * point it was defined.
+ *
+ */
+struct Callable {
+  std::size_t minArity;
+  std::size_t maxArity;
+  Procedure procedure;
+  std::shared_ptr<Environment> fnEnv;
+};
+
+/**
+ * @brief The structure of the prototypes in Wick. Contains the appropriate
+ * environments and constructor.
+ *
+ */
+struct Prototypable {
+  Callable constructor;
+  std::shared_ptr<Environment> surroundingEnv;
+  std::shared_ptr<Environment> publicEnv;
+  std::shared_ptr<Environment> privateEnv;
+  std::shared_ptr<Environment> methodEnv;
+  Prototypable copy() const;
+};
+
+/**
+ * @brief A value of any type in Wick, in 16 bytes. Numbers and booleans are
+ * held directly while strings, subroutines, and prototypes are held by
+ * reference counted pointers, so copying a value never copies what it refers
+ * to. Strings are immutable, so sharing them is safe. Operations dispatch on
+ * the value's type with a switch rather than by casting.
+ *
+ * Wick has one number type with two representations: integral numbers are
+ * held exactly as 64-bit integers for as long as they fit in one, and every
+ * other number as a Number.
+ *
+ * Cells are the shared storage of variables captured by closures. They never
+ * escape to programs, which only ever see the value held in a cell.
+ *
+ */
+class Value {
+  public:
+  enum class Type : std::uint8_t {
+    Nil,
+    Boolean,
+    Integer,
+    Number,
+    String,
+    Callable,
+    Prototype,
+    Cell
+  };
+
+  /**
+   * @brief Constructs a nil value.
+   *
+   */
+  Value() noexcept : payload{}, kind{Type::Nil} {}
+
+  /**
+   * @brief Constructs a boolean value. Only accepts booleans, so that numbers
+   * and pointers are never silently converted to one.
+   *
+   * @param iBoolean
+   */
+  template <typename T,
+            std::enable_if_t<std::is_same_v<T, bool>, int> = 0>
+  Value(const T iBoolean) noexcept : kind{Type::Boolean} {
+    payload[0] = iBoolean;
+  }
+
+  /**
+   * @brief Constructs an integer value. Accepts any integral type but bool.
+   *
+   * @param iInteger
+   */
+  template <typename T,
+            std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>,
+                             int> = 0>
+  Value(const T iInteger) noexcept : kind{Type::Integer} {
+    const auto integer{static_cast<std::int64_t>(iInteger)};
+    std::memcpy(payload, &integer, sizeof(integer));
+  }
+
+  /**
+   * @brief Constructs a number value.
+   *
+   * @param iNumber
+   */
+  Value(const Number iNumber) noexcept : kind{Type::Number} {
+    std::memcpy(payload, &iNumber, numberBytes);
+  }
+
+  /**
+   * @brief Constructs a string value.
+   *
+   * @param iString
+   */
+  Value(std::string iString);
+
+  /**
+   * @brief Constructs a string value.
+   *
+   * @param iString
+   */
+  Value(const char *iString);
+
+  /**
+   * @brief Constructs a subroutine value.
+   *
+   * @param iCallable
+   */
+  Value(Callable iCallable);
+
+  /**
+   * @brief Constructs a prototype value.
+   *
+   * @param iPrototype
+   */
+  Value(Prototypable iPrototype);
+
+  Value(const Value &other) noexcept;
+
+  Value(Value &&other) noexcept;
+
+  Value &operator=(const Value &other) noexcept;
+
+  Value &operator=(Value &&other) noexcept;
+
+  ~Value();
+
+  /**
+   * @brief Creates an integer value if the number is integral and fits in one,
+   * or a number value otherwise.
+   *
+   * @param number
+   * @return Value
+   */
+  static Value integral(const Number number) noexcept;
+
+  /**
+   * @brief Creates a new cell holding the given value.
+   *
+   * @param contents
+   * @return Value
+   */
+  static Value cell(Value contents = {});
+
+  /**
+   * @brief Gets the interned string value with the given contents, creating it
+   * the first time. Interned strings live as long as the program and compare
+   * by pointer with each other.
+   *
+   * @param text
+   * @return Value
+   */
+  static Value interned(const std::string &text);
+
+  /**
+   * @brief Concatenates two string values. Long results are ropes sharing the
+   * operands, and an empty operand just gives the other one back. Throws error
+   * if either value is not a string.
+   *
+   * @param left
+   * @param right
+   * @return Value
+   */
+  static Value concatenate(const Value &left, const Value &right);
+
+  /**
+   * @brief Gets the type of the value.
+   *
+   * @return Type
+   */
+  Type type() const noexcept { return kind; }
+
+  /**
+   * @brief Checks whether the value is nil.
+   *
+   * @return true
+   * @return false
+   */
+  bool isNil() const noexcept { return kind == Type::Nil; }
+
+  /**
+   * @brief Checks whether the value is a number in either representation.
+   *
+   * @return true
+   * @return false
+   */
+  bool isNumber() const noexcept {
+    return kind == Type::Integer || kind == Type::Number;
+  }
+
+  /**
+   * @brief Gets the boolean held. Throws error if the value is not a boolean.
+   *
+   * @return bool
+   */
+  bool asBoolean() const;
+
+  /**
+   * @brief Gets the integer held. Throws error if the value is not an integer.
+   *
+   * @return std::int64_t
+   */
+  std::int64_t asInteger() const;
+
+  /**
+   * @brief Gets the number held, converting integers. Throws error if the value
+   * is not a number.
+   *
+   * @return Number
+   */
+  Number asNumber() const;
+
+  /**
+   * @brief Gets the string held. Throws error if the value is not a string.
+   *
+   * @return const String&
+   */
+  const String &asString() const;
+
+  /**
+   * @brief Gets the subroutine held. Throws error if the value is not a
+   * subroutine.
+   *
+   * @return const Callable&
+   */
+  const Callable &asCallable() const;
+
+  /**
+   * @brief Gets the prototype held. Throws error if the value is not a
+   * prototype.
+   *
+   * @return const Prototypable&
+   */
+  const Prototypable &asPrototype() const;
+
+  /**
+   * @brief Gets the value held in a cell, which every holder of the cell
+   * shares.
+   *
+   * @return Value&
+   */
+  Value &contents() const;
+
+  private:
+  friend class String;
+
+  struct Object {
+    std::size_t references{1};
+    virtual ~Object() = default;
+  };
+
+  // Extended precision numbers only use 10 of their 16 bytes, so only those
+  // are stored and the type fits in the bytes left over.
+  static constexpr std::size_t numberBytes{
+      std::numeric_limits<Number>::digits == 64 ? 10 : sizeof(Number)};
+
+  static constexpr std::size_t payloadBytes{
+      std::max({numberBytes, sizeof(std::int64_t), sizeof(Object *)})};
+
+  template <typename T>
+  struct Boxed : Object {
+    template <typename... Args>
+    explicit Boxed(Args &&...args) : value{std::forward<Args>(args)...} {}
+    T value;
+  };
+
+  template <typename T>
+  T &unbox(const Type expected, const char *name) const;
+
+  bool counted() const noexcept { return kind >= Type::String; }
+
+  Object *object() const noexcept;
+
+  void hold(Object *const held) noexcept;
+
+  void share(const Value &other) noexcept;
+
+  void release() noexcept;
+
+  alignas(Object *) unsigned char payload[payloadBytes];
+  Type kind;
+};
+
+inline Value::Value(const Value &other) noexcept {
+  share(other);
+  if(counted()) object()->references++;
+}
+
+inline Value::Value(Value &&other) noexcept {
+  share(other);
+  other.kind = Type::Nil;
+}
+
+inline Value &Value::operator=(const Value &other) noexcept {
+  if(other.counted()) other.object()->references++;
+  release();
+  share(other);
+  return *this;
+}
+
+inline Value &Value::operator=(Value &&other) noexcept {
+  if(this == &other) return *this;
+  release();
+  share(other);
+  other.kind = Type::Nil;
+  return *this;
+}
+
+inline Value::~Value() {
+  release();
+}
+
+inline void Value::share(const Value &other) noexcept {
+  // Leaves reference counts to the caller.
+  std::memcpy(payload, other.payload, payloadBytes);
+  kind = other.kind;
+}
+
+inline void Value::release() noexcept {
+  if(!counted()) return;
+  // The object is loaded once, so nothing reads the payload after it is freed.
+  Object *const held{object()};
+  if(--held->references == 0) delete held;
+}
+
+inline Value::Object *Value::object() const noexcept {
+  Object *held;
+  std::memcpy(&held, payload, sizeof(held));
+  return held;
+}
+
+inline void Value::hold(Object *const held) noexcept {
+  std::memcpy(payload, &held, sizeof(held));
+}
+
+template <typename T>
+inline T &Value::unbox(const Type expected, const char *name) const {
+  if(kind != expected)
+    throw std::runtime_error{std::string{"Expected "} + name + "!"};
+  return static_cast<Boxed<T> *>(object())->value;
+}
+
+inline bool Value::asBoolean() const {
+  if(kind != Type::Boolean) throw std::runtime_error{"Expected a boolean!"};
+  return payload[0] != 0;
+}
+
+inline std::int64_t Value::asInteger() const {
+  if(kind != Type::Integer) throw std::runtime_error{"Expected an integer!"};
+  std::int64_t integer;
+  std::memcpy(&integer, payload, sizeof(integer));
+  return integer;
+}
+
+inline Number Value::asNumber() const {
+  if(kind == Type::Integer) return static_cast<Number>(asInteger());
+  if(kind != Type::Number) throw std::runtime_error{"Expected a number!"};
+  Number number{};
+  std::memcpy(&number, payload, numberBytes);
+  return number;
+}
+
+inline Value Value::integral(const Number number) noexcept {
+  // Both bounds are powers of two, so they convert exactly.
+  constexpr Number lowest{
+      static_cast<Number>(std::numeric_limits<std::int64_t>::min())};
+  if(number >= lowest && number < -lowest && std::trunc(number) == number)
+    return static_cast<std::int64_t>(number);
+  return number;
+}
+
+inline const String &Value::asString() const {
+  return unbox<String>(Type::String, "a string");
+}
+
+inline const Callable &Value::asCallable() const {
+  return unbox<Callable>(Type::Callable, "a subroutine");
+}
+
+inline const Prototypable &Value::asPrototype() const {
+  return unbox<Prototypable>(Type::Prototype, "a prototype");
+}
+
+inline Value &Value::contents() const {
+  return unbox<Value>(Type::Cell, "a cell");
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "bytecode.hpp"
+#include "compiler.hpp"
+#include "interpreter.hpp"
+#include <unordered_map>
+
+/**
+ * @brief Runs programs compiled to bytecode, as an alternative to walking
+ * their trees. Every call of a compiled subroutine runs in the same dispatch
+ * loop, with its registers and operands on one stack, rather than recursing
+ * through visit methods.
+ *
+ * The machine shares the global environment and natives of a tree walking
+ * interpreter, which it also hands prototypes to, so closures, natives, and
+ * methods call each other freely whichever engine created them. Programs must
+ * be resolved against globals() before they are interpreted.
+ *
+ */
+class VirtualMachine {
+  public:
+  /**
+   * @brief How many calls may be running at once unless set otherwise. Each
+   * frame takes about 100 bytes of heap, so calls nested this deeply take
+   * about 200 MB. Calls made by the tree walker the machine hands prototypes
+   * to keep its own, lower maximum.
+   *
+   */
+  static constexpr std::size_t defaultMaxDepth{2000000};
+
+  /**
+   * @brief Compiles and runs a series of statements. The statements must
+   * outlive the machine, as closures created by them keep referring to them.
+   *
+   * @param statements
+   */
+  void interpret(const std::vector<Statement::StatementUPtr> &statements);
+
+  /**
+   * @brief Gets the global environment programs are run within.
+   *
+   * @return GlobalEnvironment*
+   */
+  GlobalEnvironment *globals() const;
+
+  /**
+   * @brief Sets how many calls may be running at once before a call fails
+   * with a stack overflow.
+   *
+   * @param iMaxDepth
+   */
+  void setMaxDepth(const std::size_t iMaxDepth);
+
+  private:
+  // The procedure of closures over compiled functions. Calls from within the
+  // machine recognize it and run the function without leaving the loop.
+  struct ClosureCall {
+    VirtualMachine *machine;
+    const Bytecode::Program *program;
+    const Bytecode::Function *function;
+    std::shared_ptr<const Captures> captures;
+
+    std::optional<Value> operator()(const std::vector<Value> &args,
+                                    Environment *fnEnv) const;
+  };
+
+  // A running call. Its registers start at base, right after the callee.
+  struct Frame {
+    const Bytecode::Program *program;
+    const Bytecode::Function *function;
+    const Bytecode::Instruction *ip;
+    std::size_t base;
+    std::size_t argCount;
+    const Captures *captures;
+  };
+
+  Interpreter interpreter{};
+  std::vector<std::unique_ptr<Bytecode::Program>> programs{};
+  std::vector<Value> stack{};
+  std::vector<Frame> frames{};
+  std::unordered_map<const Bytecode::Function *, Value> closures{};
+  std::size_t maxDepth{defaultMaxDepth};
+
+  Value call(const ClosureCall &closure, const std::vector<Value> &args);
+
+  void enter(const ClosureCall &closure,
+             const std::size_t base,
+             const std::size_t argCount);
+
+  void run(const std::size_t exitDepth);
+
+  Value closure(const Frame &frame, const Bytecode::Function &function);
+};
@@ -0,0 +1,79 @@
+#include "callStack.hpp"
+#include <algorithm>
+#include <exception>
+#include <pthread.h>
+#include <stdexcept>
+#include <sys/resource.h>
+
+namespace {
+// The size of the stack segments calls continue on.
+constexpr std::size_t segmentSize{std::size_t{64} << 20};
+// What is left of a stack once it counts as nearly used up, for natives and
+// whatever runs between two calls.
+constexpr std::size_t reserve{std::size_t{256} << 10};
+
+// Below where the stack of this thread counts as nearly used up. Stacks are
+// assumed to grow down.
+thread_local const char *stackLimit{nullptr};
+
+const char *stackTop() {
+  return static_cast<const char *>(__builtin_frame_address(0));
+}
+
+struct Segment {
+  const std::function<void()> *body;
+  std::exception_ptr error{};
+};
+
+void *runSegment(void *argument) {
+  Segment &segment{*static_cast<Segment *>(argument)};
+  stackLimit = stackTop() - (segmentSize - reserve);
+  try {
+    (*segment.body)();
+  } catch(...) {
+    segment.error = std::current_exception();
+  }
+  return nullptr;
+}
+} // namespace
+
+CallStack::CallStack(const std::size_t iMaxDepth) : limit{iMaxDepth} {}
+
+void CallStack::setMaxDepth(const std::size_t iMaxDepth) {
+  limit = iMaxDepth;
+}
+
+std::size_t CallStack::maxDepth() const { return limit; }
+
+void CallStack::overflow() {
+  throw std::runtime_error{"Stack overflow! Calls are nested too deeply."};
+}
+
+bool CallStack::low() {
+  if(!stackLimit) {
+    // Stacks not started here are only counted on for half of their limit,
+    // as some of it may be in use already.
+    std::size_t size{std::size_t{8} << 20};
+    rlimit stackRlimit{};
+    if(getrlimit(RLIMIT_STACK, &stackRlimit) == 0 &&
+       stackRlimit.rlim_cur != RLIM_INFINITY)
+      size = std::min<std::size_t>(size, stackRlimit.rlim_cur);
+    stackLimit = stackTop() - size / 2;
+  }
+  return stackTop() < stackLimit;
+}
+
+void CallStack::onNewSegment(const std::function<void()> &body) {
+  Segment segment{&body};
+  pthread_attr_t attributes{};
+  pthread_attr_init(&attributes);
+  pthread_attr_setstacksize(&attributes, segmentSize);
+  pthread_t thread{};
+  const int failed{pthread_create(&thread, &attributes, runSegment, &segment)};
+  pthread_attr_destroy(&attributes);
+  if(failed) overflow();
+  // The segment runs the body while this thread waits on it, so the body runs
+  // as if it had been called here.
+  pthread_join(thread, nullptr);
+  if(segment.error) std::rethrow_exception(segment.error);
+}
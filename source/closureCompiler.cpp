@@ -0,0 +1,735 @@
+#include "closureCompiler.hpp"
+
+namespace {
+using Evaluate = ClosureCompiler::Evaluate;
+using Execute = ClosureCompiler::Execute;
+using Test = ClosureCompiler::Test;
+
+// Evaluates an expression that must have a value.
+void evaluate(const Evaluate &expr, Environment *env, Value &result) {
+  if(!expr(env, result)) throw std::runtime_error{"Expected a non-null value!"};
+}
+
+// Gets the slot of a variable of the running scope, if that is what the
+// expression is.
+std::optional<std::size_t> localSlot(const Expression::Expression *expr) {
+  const auto *variable{dynamic_cast<const Expression::Variable *>(expr)};
+  if(!variable || variable->binding.kind != Binding::Kind::Local ||
+     variable->binding.depth != 0)
+    return {};
+  return variable->binding.slot;
+}
+
+// Operands of binary operators. Each gives the operand in place where it can,
+// and only evaluates into the scratch value when it has to be computed.
+struct Slot {
+  std::size_t slot;
+
+  const Value &operator()(Environment *env, Value &scratch) const {
+    return env->cellAt(0, slot);
+  }
+};
+
+struct Constant {
+  Value constant;
+
+  const Value &operator()(Environment *env, Value &scratch) const {
+    return constant;
+  }
+};
+
+struct Computed {
+  Evaluate expr;
+
+  const Value &operator()(Environment *env, Value &scratch) const {
+    evaluate(expr, env, scratch);
+    return scratch;
+  }
+};
+
+// Binary operators, with how they combine two integers. Returning false
+// leaves the operation to operators::binary.
+template <Token::Type Op, bool (*overflows)(std::int64_t,
+                                            std::int64_t,
+                                            std::int64_t *)>
+struct Arithmetic {
+  static constexpr Token::Type type{Op};
+
+  static bool integers(const std::int64_t left,
+                       const std::int64_t right,
+                       Value &result) {
+    std::int64_t combined{0};
+    if(overflows(left, right, &combined)) return false;
+    result = combined;
+    return true;
+  }
+};
+
+bool addOverflows(std::int64_t left, std::int64_t right, std::int64_t *result) {
+  return __builtin_add_overflow(left, right, result);
+}
+
+bool subtractOverflows(std::int64_t left,
+                       std::int64_t right,
+                       std::int64_t *result) {
+  return __builtin_sub_overflow(left, right, result);
+}
+
+bool multiplyOverflows(std::int64_t left,
+                       std::int64_t right,
+                       std::int64_t *result) {
+  return __builtin_mul_overflow(left, right, result);
+}
+
+template <Token::Type Op, typename Compare>
+struct Comparison {
+  static constexpr Token::Type type{Op};
+
+  static bool holds(const std::int64_t left, const std::int64_t right) {
+    return Compare{}(left, right);
+  }
+
+  static bool integers(const std::int64_t left,
+                       const std::int64_t right,
+                       Value &result) {
+    result = Compare{}(left, right);
+    return true;
+  }
+};
+
+template <Token::Type Op>
+struct Other {
+  static constexpr Token::Type type{Op};
+
+  static bool integers(const std::int64_t left,
+                       const std::int64_t right,
+                       Value &result) {
+    return false;
+  }
+};
+
+template <typename Operator, typename Left, typename Right>
+Evaluate binaryOf(Left left, Right right) {
+  return [left, right](Environment *env, Value &result) {
+    // A computed left operand is evaluated straight into the result.
+    Value scratch{};
+    const Value &leftVal{left(env, result)};
+    const Value &rightVal{right(env, scratch)};
+    if(leftVal.type() == Value::Type::Integer &&
+       rightVal.type() == Value::Type::Integer &&
+       Operator::integers(leftVal.asInteger(), rightVal.asInteger(), result))
+      return true;
+    result = operators::binary(leftVal, Operator::type, rightVal);
+    return true;
+  };
+}
+
+// Tests whether a comparison holds, without making a boolean value of it.
+template <typename Operator, typename Left, typename Right>
+Test testOf(Left left, Right right) {
+  return [left, right](Environment *env) {
+    Value leftScratch{};
+    Value rightScratch{};
+    const Value &leftVal{left(env, leftScratch)};
+    const Value &rightVal{right(env, rightScratch)};
+    if(leftVal.type() == Value::Type::Integer &&
+       rightVal.type() == Value::Type::Integer)
+      return Operator::holds(leftVal.asInteger(), rightVal.asInteger());
+    return operators::binary(leftVal, Operator::type, rightVal).asBoolean();
+  };
+}
+
+template <typename Operator, typename Closure, typename Left, typename Right>
+Closure combine(Left left, Right right) {
+  if constexpr(std::is_same_v<Closure, Test>)
+    return testOf<Operator>(left, right);
+  else
+    return binaryOf<Operator>(left, right);
+}
+
+template <typename Operator, typename Closure, typename Left>
+Closure withRight(const Expression::Binary &binary,
+                  Left left,
+                  Evaluate right) {
+  if(const std::optional<std::size_t> slot{localSlot(binary.right.get())})
+    return combine<Operator, Closure>(left, Slot{slot.value()});
+  if(const auto *literal{
+         dynamic_cast<const Expression::Literal *>(binary.right.get())})
+    return combine<Operator, Closure>(left, Constant{literal->value});
+  return combine<Operator, Closure>(left, Computed{std::move(right)});
+}
+
+template <typename Operator, typename Closure = Evaluate>
+Closure specialize(const Expression::Binary &binary,
+                   Evaluate left,
+                   Evaluate right) {
+  // The left variable is only read in place when evaluating the right operand
+  // can not assign it.
+  const std::optional<std::size_t> leftSlot{localSlot(binary.left.get())};
+  if(leftSlot && (localSlot(binary.right.get()) ||
+                  dynamic_cast<const Expression::Literal *>(
+                      binary.right.get())))
+    return withRight<Operator, Closure>(
+        binary, Slot{leftSlot.value()}, std::move(right));
+  return withRight<Operator, Closure>(
+      binary, Computed{std::move(left)}, std::move(right));
+}
+
+bool isComparison(const Token::Type op) {
+  switch(op) {
+    case Token::Type::EqualTo:
+    case Token::Type::NotEqualTo:
+    case Token::Type::LessThan:
+    case Token::Type::LessThanOrEqualTo:
+    case Token::Type::GreaterThan:
+    case Token::Type::GreaterThanOrEqualTo: return true;
+    default: return false;
+  }
+}
+
+// Specializes a comparison into a closure giving its value or, as a test,
+// whether it holds.
+template <typename Closure>
+Closure comparison(const Expression::Binary &binary,
+                   Evaluate left,
+                   Evaluate right) {
+  using Type = Token::Type;
+  switch(binary.op.type) {
+    case Type::EqualTo:
+      return specialize<Comparison<Type::EqualTo, std::equal_to<std::int64_t>>,
+                        Closure>(binary, std::move(left), std::move(right));
+    case Type::NotEqualTo:
+      return specialize<
+          Comparison<Type::NotEqualTo, std::not_equal_to<std::int64_t>>,
+          Closure>(binary, std::move(left), std::move(right));
+    case Type::LessThan:
+      return specialize<Comparison<Type::LessThan, std::less<std::int64_t>>,
+                        Closure>(binary, std::move(left), std::move(right));
+    case Type::LessThanOrEqualTo:
+      return specialize<
+          Comparison<Type::LessThanOrEqualTo, std::less_equal<std::int64_t>>,
+          Closure>(binary, std::move(left), std::move(right));
+    case Type::GreaterThan:
+      return specialize<
+          Comparison<Type::GreaterThan, std::greater<std::int64_t>>,
+          Closure>(binary, std::move(left), std::move(right));
+    default:
+      return specialize<Comparison<Type::GreaterThanOrEqualTo,
+                                   std::greater_equal<std::int64_t>>,
+                        Closure>(binary, std::move(left), std::move(right));
+  }
+}
+} // namespace
+
+ClosureCompiler::ClosureCompiler(Interpreter *iInterpreter) :
+    interpreter{iInterpreter} {}
+
+std::vector<Execute> ClosureCompiler::compile(
+    const std::vector<Statement::StatementUPtr> &statements) {
+  std::vector<Execute> compiled{};
+  compiled.reserve(statements.size());
+  for(const Statement::StatementUPtr &statement : statements)
+    compiled.push_back(compile(statement.get()));
+  return compiled;
+}
+
+bool ClosureCompiler::visit(const Expression::Literal &literal,
+                            Environment *env,
+                            Value &result) {
+  evaluated = [value = literal.value](Environment *env, Value &result) {
+    result = value;
+    return true;
+  };
+  return false;
+}
+
+bool ClosureCompiler::visit(const Expression::Unary &unary,
+                            Environment *env,
+                            Value &result) {
+  Evaluate right{compile(unary.right.get())};
+  if(unary.op.type == Token::Type::Exclamation) {
+    evaluated = [right](Environment *env, Value &result) {
+      evaluate(right, env, result);
+      result = !result.asBoolean();
+      return true;
+    };
+    return false;
+  }
+  evaluated = [right, op = unary.op.type](Environment *env, Value &result) {
+    evaluate(right, env, result);
+    result = operators::unary(op, result);
+    return true;
+  };
+  return false;
+}
+
+bool ClosureCompiler::visit(const Expression::Binary &binary,
+                            Environment *env,
+                            Value &result) {
+  using Type = Token::Type;
+  Evaluate left{compile(binary.left.get())};
+  Evaluate right{compile(binary.right.get())};
+  switch(binary.op.type) {
+    case Type::Plus:
+      evaluated = specialize<Arithmetic<Type::Plus, addOverflows>>(
+          binary, std::move(left), std::move(right));
+      break;
+    case Type::Dash:
+      evaluated = specialize<Arithmetic<Type::Dash, subtractOverflows>>(
+          binary, std::move(left), std::move(right));
+      break;
+    case Type::Asterisk:
+      evaluated = specialize<Arithmetic<Type::Asterisk, multiplyOverflows>>(
+          binary, std::move(left), std::move(right));
+      break;
+    case Type::EqualTo:
+    case Type::NotEqualTo:
+    case Type::LessThan:
+    case Type::LessThanOrEqualTo:
+    case Type::GreaterThan:
+    case Type::GreaterThanOrEqualTo:
+      evaluated =
+          comparison<Evaluate>(binary, std::move(left), std::move(right));
+      break;
+    case Type::ForwardSlash:
+      evaluated = specialize<Other<Type::ForwardSlash>>(
+          binary, std::move(left), std::move(right));
+      break;
+    case Type::Modulus:
+      evaluated = specialize<Other<Type::Modulus>>(
+          binary, std::move(left), std::move(right));
+      break;
+    default:
+      evaluated = [left, right, op = binary.op.type](Environment *env,
+                                                     Value &result) {
+        Value rightVal{};
+        evaluate(left, env, result);
+        evaluate(right, env, rightVal);
+        result = operators::binary(result, op, rightVal);
+        return true;
+      };
+      break;
+  }
+  return false;
+}
+
+bool ClosureCompiler::visit(const Expression::Logical &logical,
+                            Environment *env,
+                            Value &result) {
+  evaluated = [left = compile(logical.left.get()),
+               right = compile(logical.right.get()),
+               decidedBy = logical.op.type == Token::Type::Or](
+                  Environment *env, Value &result) {
+    evaluate(left, env, result);
+    if(operators::logical(result) == decidedBy) return true;
+    evaluate(right, env, result);
+    operators::logical(result);
+    return true;
+  };
+  return false;
+}
+
+bool ClosureCompiler::visit(const Expression::Group &group,
+                            Environment *env,
+                            Value &result) {
+  evaluated = compile(group.expr.get());
+  return false;
+}
+
+bool ClosureCompiler::visit(const Expression::Ternary &ternary,
+                            Environment *env,
+                            Value &result) {
+  evaluated = [condition = test(ternary.condition.get()),
+               thenExpr = compile(ternary.thenExpr.get()),
+               elseExpr = compile(ternary.elseExpr.get())](Environment *env,
+                                                           Value &result) {
+    if(condition(env)) return thenExpr(env, result);
+    return elseExpr(env, result);
+  };
+  return false;
+}
+
+bool ClosureCompiler::visit(const Expression::Variable &variable,
+                            Environment *env,
+                            Value &result) {
+  const Binding &binding{variable.binding};
+  Interpreter *const interp{interpreter};
+  switch(binding.kind) {
+    case Binding::Kind::Local:
+      evaluated = [depth = binding.depth, slot = binding.slot](
+                      Environment *env, Value &result) {
+        result = env->cellAt(depth, slot);
+        return true;
+      };
+      break;
+    case Binding::Kind::Boxed:
+      evaluated = [depth = binding.depth, slot = binding.slot](
+                      Environment *env, Value &result) {
+        result = env->cellAt(depth, slot).contents();
+        return true;
+      };
+      break;
+    case Binding::Kind::Captured:
+      evaluated = [interp, slot = binding.slot](Environment *env,
+                                                Value &result) {
+        result = (*interp->captures)[slot].contents();
+        return true;
+      };
+      break;
+    case Binding::Kind::Global:
+      evaluated = [global = interp->globals(), slot = binding.slot](
+                      Environment *env, Value &result) {
+        result = global->getSlot(slot);
+        return true;
+      };
+      break;
+    default:
+      evaluated = [token = variable.variable](Environment *env, Value &result) {
+        result = env->get(token);
+        return true;
+      };
+      break;
+  }
+  return false;
+}
+
+bool ClosureCompiler::visit(const Expression::Assignment &assignment,
+                            Environment *env,
+                            Value &result) {
+  const Binding &binding{assignment.binding};
+  Interpreter *const interp{interpreter};
+  Evaluate value{compile(assignment.value.get())};
+  switch(binding.kind) {
+    case Binding::Kind::Local:
+      evaluated = [value, depth = binding.depth, slot = binding.slot](
+                      Environment *env, Value &result) {
+        evaluate(value, env, result);
+        env->assignAt(depth, slot, result);
+        return true;
+      };
+      break;
+    case Binding::Kind::Boxed:
+      evaluated = [value, depth = binding.depth, slot = binding.slot](
+                      Environment *env, Value &result) {
+        evaluate(value, env, result);
+        env->cellAt(depth, slot).contents() = result;
+        return true;
+      };
+      break;
+    case Binding::Kind::Captured:
+      evaluated = [value, interp, slot = binding.slot](Environment *env,
+                                                       Value &result) {
+        evaluate(value, env, result);
+        (*interp->captures)[slot].contents() = result;
+        return true;
+      };
+      break;
+    case Binding::Kind::Global:
+      evaluated = [value, global = interp->globals(), slot = binding.slot](
+                      Environment *env, Value &result) {
+        evaluate(value, env, result);
+        global->assignSlot(slot, result);
+        return true;
+      };
+      break;
+    default:
+      evaluated = [value, token = assignment.variable](Environment *env,
+                                                       Value &result) {
+        evaluate(value, env, result);
+        env->assign(token, result);
+        return true;
+      };
+      break;
+  }
+  return false;
+}
+
+bool ClosureCompiler::visit(const Expression::Call &call,
+                            Environment *env,
+                            Value &result) {
+  std::vector<Evaluate> args{};
+  args.reserve(call.args.size());
+  for(const Expression::ExpressionUPtr &arg : call.args)
+    args.push_back(compile(arg.get()));
+  Interpreter *const interp{interpreter};
+  evaluated = [interp,
+               callee = compile(call.callee.get()),
+               args,
+               tail = call.tail](Environment *env, Value &result) {
+    Value calleeVal{};
+    evaluate(callee, env, calleeVal);
+    std::vector<Value> argVals(args.size());
+    for(std::size_t i{0}; i < args.size(); i++)
+      evaluate(args[i], env, argVals[i]);
+    if(tail) {
+      // Made by the subroutine returning it, as in the tree walker.
+      interp->tailCall.emplace(
+          Interpreter::TailCall{std::move(calleeVal), std::move(argVals)});
+      result = Value{};
+      return true;
+    }
+    std::optional<Value> returned{operators::call(calleeVal, argVals)};
+    if(!returned) return false;
+    result = std::move(returned.value());
+    return true;
+  };
+  return false;
+}
+
+bool ClosureCompiler::visit(const Expression::Lambda &lambda,
+                            Environment *env,
+                            Value &result) {
+  // The body is compiled once and shared by every closure created from it.
+  auto compiled{std::make_shared<CompiledLambda>()};
+  for(const auto &param : lambda.defaultParams)
+    compiled->defaultParams.push_back(compile(param.second.get()));
+  compiled->body = compile(lambda.body.get());
+  evaluated = [interp = interpreter, &lambda, compiled](Environment *env,
+                                                        Value &result) {
+    interp->makeClosure(lambda, env, result, compiled);
+    return true;
+  };
+  return false;
+}
+
+bool ClosureCompiler::visit(const Expression::Prototype &prototype,
+                            Environment *env,
+                            Value &result) {
+  evaluated = [interp = interpreter, &prototype](Environment *env,
+                                                 Value &result) {
+    return interp->visit(prototype, env, result);
+  };
+  return false;
+}
+
+bool ClosureCompiler::visit(const Expression::Set &set,
+                            Environment *env,
+                            Value &result) {
+  evaluated = [object = compile(set.object.get()),
+               value = compile(set.value.get()),
+               property = set.property](Environment *env, Value &result) {
+    Value objectVal{};
+    evaluate(object, env, objectVal);
+    if(objectVal.type() != Value::Type::Prototype)
+      throw std::runtime_error{"Can only set properties of prototypes."};
+    Value valueVal{};
+    evaluate(value, env, valueVal);
+    operators::set(objectVal, property, valueVal);
+    return false;
+  };
+  return false;
+}
+
+bool ClosureCompiler::visit(const Expression::Get &get,
+                            Environment *env,
+                            Value &result) {
+  evaluated = [object = compile(get.object.get()), property = get.property](
+                  Environment *env, Value &result) {
+    Value objectVal{};
+    evaluate(object, env, objectVal);
+    result = operators::get(objectVal, property);
+    return true;
+  };
+  return false;
+}
+
+Statement::Completion ClosureCompiler::visit(const Statement::Expression &expr,
+                                             Environment *env) {
+  executed = [expr = compile(expr.expr.get())](Environment *env,
+                                               std::optional<Value> &returned) {
+    Value unused{};
+    expr(env, unused);
+    return false;
+  };
+  return Statement::Completion::Normal;
+}
+
+Statement::Completion
+    ClosureCompiler::visit(const Statement::Variable &variable,
+                           Environment *env) {
+  const Binding &binding{variable.binding};
+  Evaluate initializer{compile(variable.initializer.get())};
+  switch(binding.kind) {
+    case Binding::Kind::Boxed:
+      executed = [initializer, slot = binding.slot](
+                     Environment *env, std::optional<Value> &returned) {
+        // The cell exists before the initializer runs so subroutines can
+        // capture themselves.
+        const Cell cell{Value::cell()};
+        env->defineAt(slot, cell);
+        if(initializer) {
+          Value value{};
+          evaluate(initializer, env, value);
+          cell.contents() = std::move(value);
+        }
+        return false;
+      };
+      break;
+    case Binding::Kind::Local:
+      executed = [initializer, slot = binding.slot](
+                     Environment *env, std::optional<Value> &returned) {
+        Value value{};
+        if(initializer) evaluate(initializer, env, value);
+        env->defineAt(slot, value);
+        return false;
+      };
+      break;
+    case Binding::Kind::Global:
+      executed = [initializer,
+                  global = interpreter->globals(),
+                  slot = binding.slot](Environment *env,
+                                       std::optional<Value> &returned) {
+        Value value{};
+        if(initializer) evaluate(initializer, env, value);
+        global->defineSlot(slot, value);
+        return false;
+      };
+      break;
+    default:
+      executed = [initializer, token = variable.variable](
+                     Environment *env, std::optional<Value> &returned) {
+        Value value{};
+        if(initializer) evaluate(initializer, env, value);
+        env->define(token, value);
+        return false;
+      };
+      break;
+  }
+  return Statement::Completion::Normal;
+}
+
+Statement::Completion ClosureCompiler::visit(const Statement::Scope &scope,
+                                             Environment *env) {
+  executed = [interp = interpreter,
+              layout = scope.layout,
+              statements = compile(scope.statements)](
+                 Environment *env, std::optional<Value> &returned) {
+    return interp->withFrame(layout, env, [&](Environment *scopedEnv) {
+      for(const Execute &statement : statements)
+        if(statement(scopedEnv, returned)) return true;
+      return false;
+    });
+  };
+  return Statement::Completion::Normal;
+}
+
+Statement::Completion ClosureCompiler::visit(const Statement::If &ifStmt,
+                                             Environment *env) {
+  executed = [condition = test(ifStmt.condition.get()),
+              thenStmt = compile(ifStmt.thenStmt.get()),
+              elseStmt = compile(ifStmt.elseStmt.get())](
+                 Environment *env, std::optional<Value> &returned) {
+    if(condition(env)) return thenStmt(env, returned);
+    if(elseStmt) return elseStmt(env, returned);
+    return false;
+  };
+  return Statement::Completion::Normal;
+}
+
+Statement::Completion ClosureCompiler::visit(const Statement::For &forStmt,
+                                             Environment *env) {
+  Interpreter *const interp{interpreter};
+  Execute initializer{compile(forStmt.initializer.get())};
+  Test condition{test(forStmt.condition.get())};
+  Execute update{compile(forStmt.update.get())};
+  // A body no closure can capture keeps one frame for every iteration, as it
+  // does for the tree walker.
+  const auto *body{dynamic_cast<const Statement::Scope *>(forStmt.body.get())};
+  if(body && !body->layout.captured) {
+    executed = [interp,
+                layout = forStmt.layout,
+                bodyLayout = body->layout,
+                initializer,
+                condition,
+                statements = compile(body->statements),
+                update](Environment *env, std::optional<Value> &returned) {
+      return interp->withFrame(layout, env, [&](Environment *forEnv) {
+        if(initializer && initializer(forEnv, returned)) return true;
+        return interp->withFrame(
+            bodyLayout, forEnv, [&](Environment *bodyEnv) {
+              for(;;) {
+                if(!condition(forEnv)) return false;
+                for(const Execute &statement : statements)
+                  if(statement(bodyEnv, returned)) return true;
+                if(update && update(forEnv, returned)) return true;
+              }
+            });
+      });
+    };
+    return Statement::Completion::Normal;
+  }
+  executed = [interp,
+              layout = forStmt.layout,
+              initializer,
+              condition,
+              body = compile(forStmt.body.get()),
+              update](Environment *env, std::optional<Value> &returned) {
+    return interp->withFrame(layout, env, [&](Environment *forEnv) {
+      if(initializer && initializer(forEnv, returned)) return true;
+      for(;;) {
+        if(!condition(forEnv)) return false;
+        if(body && body(forEnv, returned)) return true;
+        if(update && update(forEnv, returned)) return true;
+      }
+    });
+  };
+  return Statement::Completion::Normal;
+}
+
+Statement::Completion
+    ClosureCompiler::visit(const Statement::Return &returnStmt,
+                           Environment *env) {
+  executed = [expr = compile(returnStmt.expr.get())](
+                 Environment *env, std::optional<Value> &returned) {
+    returned.emplace();
+    if(expr && !expr(env, returned.value())) returned.reset();
+    return true;
+  };
+  return Statement::Completion::Normal;
+}
+
+Evaluate ClosureCompiler::compile(Expression::Expression *expr) {
+  Value unused{};
+  evaluated = nullptr;
+  if(expr) expr->accept(this, nullptr, unused);
+  return std::move(evaluated);
+}
+
+Test ClosureCompiler::test(Expression::Expression *condition,
+                           const bool logicalOperand) {
+  if(const auto *group{dynamic_cast<const Expression::Group *>(condition)})
+    return test(group->expr.get(), logicalOperand);
+  if(const auto *logical{
+         dynamic_cast<const Expression::Logical *>(condition)}) {
+    Test left{test(logical->left.get(), true)};
+    Test right{test(logical->right.get(), true)};
+    if(logical->op.type == Token::Type::Or)
+      return [left, right](Environment *env) {
+        return left(env) || right(env);
+      };
+    return [left, right](Environment *env) { return left(env) && right(env); };
+  }
+  const auto *binary{dynamic_cast<const Expression::Binary *>(condition)};
+  if(binary && isComparison(binary->op.type))
+    return comparison<Test>(*binary,
+                            compile(binary->left.get()),
+                            compile(binary->right.get()));
+  Evaluate value{compile(condition)};
+  if(logicalOperand)
+    return [value](Environment *env) {
+      Value result{};
+      evaluate(value, env, result);
+      return operators::logical(result);
+    };
+  return [value](Environment *env) {
+    Value result{};
+    evaluate(value, env, result);
+    return operators::isTrue(result);
+  };
+}
+
+Execute ClosureCompiler::compile(Statement::Statement *statement) {
+  executed = nullptr;
+  if(statement) statement->accept(this, nullptr);
+  return std::move(executed);
+}
@@ -0,0 +1,410 @@
+#include "compiler.hpp"
+
+using Bytecode::OpCode;
+
+namespace {
+// Gets the operation of a comparison operator, if it is one.
+std::optional<OpCode> comparison(const Token::Type op) {
+  switch(op) {
+    case Token::Type::EqualTo: return OpCode::Equal;
+    case Token::Type::NotEqualTo: return OpCode::NotEqual;
+    case Token::Type::LessThan: return OpCode::Less;
+    case Token::Type::LessThanOrEqualTo: return OpCode::LessEqual;
+    case Token::Type::GreaterThan: return OpCode::Greater;
+    case Token::Type::GreaterThanOrEqualTo: return OpCode::GreaterEqual;
+    default: return {};
+  }
+}
+} // namespace
+
+Bytecode::Program
+    Compiler::compile(const std::vector<Statement::StatementUPtr> &statements) {
+  program = Bytecode::Program{};
+  program.functions.push_back(std::make_unique<Bytecode::Function>());
+  states.assign(1, FunctionState{program.functions.front().get()});
+  for(const Statement::StatementUPtr &statement : statements)
+    compile(statement.get());
+  emit(OpCode::Nil);
+  emit(OpCode::Return);
+  states.clear();
+  return std::move(program);
+}
+
+bool Compiler::visit(const Expression::Literal &literal,
+                     Environment *env,
+                     Value &result) {
+  std::vector<Value> &constants{states.back().function->constants};
+  emit(OpCode::Constant, constants.size());
+  constants.push_back(literal.value);
+  return false;
+}
+
+bool Compiler::visit(const Expression::Unary &unary,
+                     Environment *env,
+                     Value &result) {
+  compile(unary.right.get());
+  switch(unary.op.type) {
+    case Token::Type::Exclamation: emit(OpCode::Not); break;
+    case Token::Type::Dash: emit(OpCode::Negate); break;
+    default: throw std::runtime_error("Not a supported unary operator");
+  }
+  return false;
+}
+
+bool Compiler::visit(const Expression::Binary &binary,
+                     Environment *env,
+                     Value &result) {
+  compile(binary.left.get());
+  compile(binary.right.get());
+  switch(binary.op.type) {
+    case Token::Type::Plus: emit(OpCode::Add); break;
+    case Token::Type::Dash: emit(OpCode::Subtract); break;
+    case Token::Type::Asterisk: emit(OpCode::Multiply); break;
+    case Token::Type::ForwardSlash: emit(OpCode::Divide); break;
+    case Token::Type::Modulus: emit(OpCode::Modulus); break;
+    case Token::Type::EqualTo: emit(OpCode::Equal); break;
+    case Token::Type::NotEqualTo: emit(OpCode::NotEqual); break;
+    case Token::Type::LessThan: emit(OpCode::Less); break;
+    case Token::Type::LessThanOrEqualTo: emit(OpCode::LessEqual); break;
+    case Token::Type::GreaterThan: emit(OpCode::Greater); break;
+    case Token::Type::GreaterThanOrEqualTo: emit(OpCode::GreaterEqual); break;
+    default: throw std::runtime_error("Not a supported binary operator.");
+  }
+  return false;
+}
+
+bool Compiler::visit(const Expression::Logical &logical,
+                     Environment *env,
+                     Value &result) {
+  compile(logical.left.get());
+  const std::size_t decided{
+      emit(OpCode::ShortCircuit, 0, logical.op.type == Token::Type::Or)};
+  compile(logical.right.get());
+  emit(OpCode::CheckBoolean);
+  patch(decided);
+  return false;
+}
+
+bool Compiler::visit(const Expression::Group &group,
+                     Environment *env,
+                     Value &result) {
+  compile(group.expr.get());
+  return false;
+}
+
+bool Compiler::visit(const Expression::Ternary &ternary,
+                     Environment *env,
+                     Value &result) {
+  std::vector<std::size_t> otherwise{};
+  branch(ternary.condition.get(), false, otherwise);
+  compile(ternary.thenExpr.get());
+  const std::size_t end{emit(OpCode::Jump)};
+  patch(otherwise);
+  compile(ternary.elseExpr.get());
+  patch(end);
+  return false;
+}
+
+bool Compiler::visit(const Expression::Variable &variable,
+                     Environment *env,
+                     Value &result) {
+  load(variable.binding);
+  return false;
+}
+
+bool Compiler::visit(const Expression::Assignment &assignment,
+                     Environment *env,
+                     Value &result) {
+  compile(assignment.value.get());
+  store(assignment.binding);
+  return false;
+}
+
+bool Compiler::visit(const Expression::Call &call,
+                     Environment *env,
+                     Value &result) {
+  compile(call.callee.get());
+  for(const Expression::ExpressionUPtr &arg : call.args) compile(arg.get());
+  // Like the tree walker, only calls whose value is used need one.
+  emit(call.tail ? OpCode::TailCall : OpCode::Call,
+       call.args.size(),
+       call.tail || &call == discarded);
+  return false;
+}
+
+bool Compiler::visit(const Expression::Lambda &lambda,
+                     Environment *env,
+                     Value &result) {
+  if(!lambda.captures)
+    throw Unsupported{
+        "The virtual machine can not compile lambdas within prototypes."};
+  auto function{std::make_unique<Bytecode::Function>()};
+  function->index = program.functions.size();
+  function->minArity = lambda.params.size();
+  function->maxArity = lambda.params.size() + lambda.defaultParams.size();
+  // Captures are found relative to the subroutine creating the closure.
+  for(const Binding &capture : lambda.captures.value())
+    function->captures.push_back(
+        capture.kind == Binding::Kind::Boxed
+            ? Bytecode::Capture{true, registerOf(capture)}
+            : Bytecode::Capture{false,
+                                static_cast<std::uint32_t>(capture.slot)});
+  states.push_back(FunctionState{function.get()});
+  program.functions.push_back(std::move(function));
+  // Parameters take the first registers, as they take the first slots.
+  beginFrame(lambda.layout);
+  for(std::size_t i{0}; i < lambda.paramBindings.size(); i++) {
+    const Binding &param{lambda.paramBindings[i]};
+    if(i >= lambda.params.size()) {
+      const std::size_t passed{emit(OpCode::JumpIfPassed, 0, i)};
+      compile(lambda.defaultParams[i - lambda.params.size()].second.get());
+      emit(OpCode::DefineLocal, registerOf(param));
+      patch(passed);
+    }
+    if(param.kind == Binding::Kind::Boxed) emit(OpCode::Box, registerOf(param));
+  }
+  compile(lambda.body.get());
+  emit(OpCode::Nil);
+  emit(OpCode::Return);
+  const std::size_t index{states.back().function->index};
+  states.pop_back();
+  emit(OpCode::Closure, index);
+  return false;
+}
+
+bool Compiler::visit(const Expression::Prototype &prototype,
+                     Environment *env,
+                     Value &result) {
+  if(states.size() != 1 || !states.back().frames.empty())
+    throw Unsupported{"The virtual machine can only compile prototypes "
+                      "declared at the top level."};
+  emit(OpCode::Prototype, program.prototypes.size());
+  program.prototypes.push_back(&prototype);
+  return false;
+}
+
+bool Compiler::visit(const Expression::Set &set,
+                     Environment *env,
+                     Value &result) {
+  std::vector<Token> &names{states.back().function->names};
+  compile(set.object.get());
+  compile(set.value.get());
+  emit(OpCode::SetProperty, names.size());
+  names.push_back(set.property);
+  return false;
+}
+
+bool Compiler::visit(const Expression::Get &get,
+                     Environment *env,
+                     Value &result) {
+  std::vector<Token> &names{states.back().function->names};
+  compile(get.object.get());
+  emit(OpCode::GetProperty, names.size());
+  names.push_back(get.property);
+  return false;
+}
+
+Statement::Completion Compiler::visit(const Statement::Expression &expr,
+                                      Environment *env) {
+  discarded = expr.expr.get();
+  compile(expr.expr.get());
+  emit(OpCode::Pop);
+  return Statement::Completion::Normal;
+}
+
+Statement::Completion Compiler::visit(const Statement::Variable &variable,
+                                      Environment *env) {
+  const Binding &binding{variable.binding};
+  if(binding.kind == Binding::Kind::Boxed) {
+    // The cell exists before the initializer runs so subroutines can capture
+    // themselves.
+    emit(OpCode::NewCell, registerOf(binding));
+    if(variable.initializer) {
+      compile(variable.initializer.get());
+      emit(OpCode::SetCell, registerOf(binding));
+      emit(OpCode::Pop);
+    }
+    return Statement::Completion::Normal;
+  }
+  if(variable.initializer)
+    compile(variable.initializer.get());
+  else
+    emit(OpCode::Nil);
+  switch(binding.kind) {
+    case Binding::Kind::Local:
+      emit(OpCode::DefineLocal, registerOf(binding));
+      break;
+    case Binding::Kind::Global:
+      emit(OpCode::DefineGlobal, binding.slot);
+      break;
+    default:
+      throw Unsupported{
+          "The virtual machine can not compile variables found by name."};
+  }
+  return Statement::Completion::Normal;
+}
+
+Statement::Completion Compiler::visit(const Statement::Scope &scope,
+                                      Environment *env) {
+  const bool framed{beginFrame(scope.layout)};
+  for(const Statement::StatementUPtr &statement : scope.statements)
+    compile(statement.get());
+  if(framed) endFrame();
+  return Statement::Completion::Normal;
+}
+
+Statement::Completion Compiler::visit(const Statement::If &ifStmt,
+                                      Environment *env) {
+  std::vector<std::size_t> otherwise{};
+  branch(ifStmt.condition.get(), false, otherwise);
+  compile(ifStmt.thenStmt.get());
+  if(!ifStmt.elseStmt) {
+    patch(otherwise);
+    return Statement::Completion::Normal;
+  }
+  const std::size_t end{emit(OpCode::Jump)};
+  patch(otherwise);
+  compile(ifStmt.elseStmt.get());
+  patch(end);
+  return Statement::Completion::Normal;
+}
+
+Statement::Completion Compiler::visit(const Statement::For &forStmt,
+                                      Environment *env) {
+  const bool framed{beginFrame(forStmt.layout)};
+  compile(forStmt.initializer.get());
+  const std::size_t loop{states.back().function->code.size()};
+  std::vector<std::size_t> exit{};
+  branch(forStmt.condition.get(), false, exit);
+  compile(forStmt.body.get());
+  compile(forStmt.update.get());
+  emit(OpCode::Jump, loop);
+  patch(exit);
+  if(framed) endFrame();
+  return Statement::Completion::Normal;
+}
+
+Statement::Completion Compiler::visit(const Statement::Return &returnStmt,
+                                      Environment *env) {
+  if(returnStmt.expr)
+    compile(returnStmt.expr.get());
+  else
+    emit(OpCode::Nil);
+  emit(OpCode::Return);
+  return Statement::Completion::Normal;
+}
+
+void Compiler::compile(Expression::Expression *expr) {
+  Value unused{};
+  if(expr) expr->accept(this, nullptr, unused);
+}
+
+void Compiler::compile(Statement::Statement *statement) {
+  if(statement) statement->accept(this, nullptr);
+}
+
+std::size_t
+    Compiler::emit(const OpCode op, const std::size_t a, const std::size_t b) {
+  std::vector<Bytecode::Instruction> &code{states.back().function->code};
+  code.push_back(Bytecode::Instruction{op,
+                                       static_cast<std::uint16_t>(b),
+                                       static_cast<std::uint32_t>(a)});
+  return code.size() - 1;
+}
+
+void Compiler::patch(const std::size_t jump) {
+  std::vector<Bytecode::Instruction> &code{states.back().function->code};
+  code[jump].a = static_cast<std::uint32_t>(code.size());
+}
+
+void Compiler::patch(const std::vector<std::size_t> &jumps) {
+  for(const std::size_t jump : jumps) patch(jump);
+}
+
+void Compiler::branch(Expression::Expression *condition,
+                      const bool when,
+                      std::vector<std::size_t> &jumps,
+                      const bool logicalOperand) {
+  if(const auto *group{dynamic_cast<const Expression::Group *>(condition)}) {
+    branch(group->expr.get(), when, jumps, logicalOperand);
+    return;
+  }
+  if(const auto *logical{dynamic_cast<const Expression::Logical *>(condition)}) {
+    // And is decided by a false operand, or by a true one. Deciding the other
+    // way takes both operands.
+    const bool decidedBy{logical->op.type == Token::Type::Or};
+    if(when == decidedBy) {
+      branch(logical->left.get(), when, jumps, true);
+      branch(logical->right.get(), when, jumps, true);
+      return;
+    }
+    std::vector<std::size_t> decided{};
+    branch(logical->left.get(), decidedBy, decided, true);
+    branch(logical->right.get(), when, jumps, true);
+    patch(decided);
+    return;
+  }
+  // Comparisons test their operands and branch in one operation.
+  const auto *binary{dynamic_cast<const Expression::Binary *>(condition)};
+  if(const std::optional<OpCode> compare{
+         binary ? comparison(binary->op.type) : std::nullopt}) {
+    compile(binary->left.get());
+    compile(binary->right.get());
+    jumps.push_back(emit(when ? OpCode::JumpIfHolds : OpCode::JumpUnless,
+                         0,
+                         static_cast<std::size_t>(compare.value())));
+    return;
+  }
+  compile(condition);
+  if(logicalOperand) emit(OpCode::CheckBoolean);
+  jumps.push_back(emit(when ? OpCode::JumpIfTrue : OpCode::JumpIfFalse));
+}
+
+bool Compiler::beginFrame(const FrameLayout &layout) {
+  if(layout.elided) return false;
+  FunctionState &state{states.back()};
+  state.frames.push_back(state.nextRegister);
+  state.nextRegister += layout.slots;
+  state.function->registers =
+      std::max(state.function->registers, state.nextRegister);
+  return true;
+}
+
+void Compiler::endFrame() {
+  FunctionState &state{states.back()};
+  state.nextRegister = state.frames.back();
+  state.frames.pop_back();
+}
+
+std::uint32_t Compiler::registerOf(const Binding &binding) const {
+  const std::vector<std::size_t> &frames{states.back().frames};
+  if(binding.depth >= frames.size())
+    throw Unsupported{"The virtual machine can only compile variables "
+                      "of the running subroutine as registers."};
+  return static_cast<std::uint32_t>(frames[frames.size() - 1 - binding.depth] +
+                                    binding.slot);
+}
+
+void Compiler::load(const Binding &binding) {
+  switch(binding.kind) {
+    case Binding::Kind::Local: emit(OpCode::GetLocal, registerOf(binding)); break;
+    case Binding::Kind::Boxed: emit(OpCode::GetCell, registerOf(binding)); break;
+    case Binding::Kind::Captured: emit(OpCode::GetCaptured, binding.slot); break;
+    case Binding::Kind::Global: emit(OpCode::GetGlobal, binding.slot); break;
+    default:
+      throw Unsupported{
+          "The virtual machine can not compile variables found by name."};
+  }
+}
+
+void Compiler::store(const Binding &binding) {
+  switch(binding.kind) {
+    case Binding::Kind::Local: emit(OpCode::SetLocal, registerOf(binding)); break;
+    case Binding::Kind::Boxed: emit(OpCode::SetCell, registerOf(binding)); break;
+    case Binding::Kind::Captured: emit(OpCode::SetCaptured, binding.slot); break;
+    case Binding::Kind::Global: emit(OpCode::SetGlobal, binding.slot); break;
+    default:
+      throw Unsupported{
+          "The virtual machine can not compile variables found by name."};
+  }
+}
@@ -0,0 +1,228 @@
+#include "constantFolder.hpp"
+
+namespace {
+// Determines whether a value can stand in the tree as a literal.
+bool isLiteral(const Value &value) {
+  switch(value.type()) {
+    case Value::Type::Nil:
+    case Value::Type::Boolean:
+    case Value::Type::Integer:
+    case Value::Type::Number:
+    case Value::Type::String: return true;
+    default: return false;
+  }
+}
+} // namespace
+
+ConstantFolder::ConstantFolder(GlobalEnvironment *const iGlobals) :
+    globals{iGlobals} {}
+
+void ConstantFolder::rewrite(
+    std::vector<Statement::StatementUPtr> &statements) {
+  // Globals may be used by subroutines before they are declared, so the names
+  // of every global are known up front.
+  for(const Statement::StatementUPtr &statement : statements)
+    if(auto *variable{dynamic_cast<Statement::Variable *>(statement.get())})
+      declaredGlobals.insert(variable->variable.symbol);
+  scopes.push();
+  rewriteEach(statements);
+  scopes.pop();
+}
+
+bool ConstantFolder::visit(const Expression::Literal &literal,
+                           Environment *env,
+                           Value &result) {
+  result = literal.value;
+  return true;
+}
+
+bool ConstantFolder::visit(const Expression::Unary &unary,
+                           Environment *env,
+                           Value &result) {
+  if(!rewrite(unary.right, result)) return false;
+  try {
+    return known(operators::unary(unary.op.type, result), result);
+  } catch(std::runtime_error &e) {
+    return false;
+  }
+}
+
+bool ConstantFolder::visit(const Expression::Binary &binary,
+                           Environment *env,
+                           Value &result) {
+  Value rightVal{};
+  Value leftVal{};
+  const bool leftKnown{rewrite(binary.left, leftVal)};
+  if(!rewrite(binary.right, rightVal) || !leftKnown) return false;
+  try {
+    return known(operators::binary(leftVal, binary.op.type, rightVal),
+                 result);
+  } catch(std::runtime_error &e) {
+    return false;
+  }
+}
+
+bool ConstantFolder::visit(const Expression::Logical &logical,
+                           Environment *env,
+                           Value &result) {
+  Value leftVal{};
+  Value rightVal{};
+  const bool leftKnown{rewrite(logical.left, leftVal)};
+  const bool rightKnown{rewrite(logical.right, rightVal)};
+  // Operands that are not booleans are left to fail when the program runs.
+  if(!leftKnown || leftVal.type() != Value::Type::Boolean) return false;
+  if(leftVal.asBoolean() == (logical.op.type == Token::Type::Or))
+    return known(leftVal, result);
+  if(!rightKnown || rightVal.type() != Value::Type::Boolean) return false;
+  return known(rightVal, result);
+}
+
+bool ConstantFolder::visit(const Expression::Group &group,
+                           Environment *env,
+                           Value &result) {
+  Value value{};
+  return rewrite(group.expr, value) && known(value, result);
+}
+
+bool ConstantFolder::visit(const Expression::Ternary &ternary,
+                           Environment *env,
+                           Value &result) {
+  Value condition{};
+  const bool conditionKnown{rewrite(ternary.condition, condition)};
+  Value thenVal{};
+  const bool thenKnown{rewrite(ternary.thenExpr, thenVal)};
+  Value elseVal{};
+  const bool elseKnown{rewrite(ternary.elseExpr, elseVal)};
+  if(!conditionKnown) return false;
+  const bool taken{operators::isTrue(condition)};
+  if(taken ? thenKnown : elseKnown)
+    return known(taken ? thenVal : elseVal, result);
+  replace(std::move(taken ? ternary.thenExpr : ternary.elseExpr));
+  return false;
+}
+
+bool ConstantFolder::visit(const Expression::Variable &variable,
+                           Environment *env,
+                           Value &result) {
+  std::optional<Value> value{constant(variable.variable)};
+  if(!value || !isLiteral(value.value())) return false;
+  return known(value.value(), result);
+}
+
+bool ConstantFolder::visit(const Expression::Call &call,
+                           Environment *env,
+                           Value &result) {
+  rewrite(call.callee);
+  bool argsKnown{true};
+  std::vector<Value> args(call.args.size());
+  for(std::size_t i{0}; i < call.args.size(); i++)
+    argsKnown = rewrite(call.args[i], args[i]) && argsKnown;
+  const auto *name{
+      dynamic_cast<const Expression::Variable *>(call.callee.get())};
+  if(!argsKnown || !name || !native::isPure(name->variable.lexeme)) return false;
+  const std::optional<Value> native{constant(name->variable)};
+  if(!native || native->type() != Value::Type::Callable) return false;
+  try {
+    std::optional<Value> returned{operators::call(native.value(), args)};
+    if(!returned || !isLiteral(returned.value())) return false;
+    return known(returned.value(), result);
+  } catch(std::runtime_error &e) {
+    return false;
+  }
+}
+
+bool ConstantFolder::visit(const Expression::Lambda &lambda,
+                           Environment *env,
+                           Value &result) {
+  scopes.push();
+  for(const Token &param : lambda.params) declare(param, std::nullopt);
+  for(auto &param : lambda.defaultParams) {
+    rewrite(param.second);
+    declare(param.first, std::nullopt);
+  }
+  rewrite(lambda.body);
+  scopes.pop();
+  return false;
+}
+
+bool ConstantFolder::visit(const Expression::Prototype &prototype,
+                           Environment *env,
+                           Value &result) {
+  scopes.push(ScopeKind::Prototype);
+  rewriteEach(prototype.publicProperties);
+  rewriteEach(prototype.privateProperties);
+  rewrite(prototype.constructor);
+  scopes.pop();
+  return false;
+}
+
+Statement::Completion ConstantFolder::visit(const Statement::Variable &variable,
+                                            Environment *env) {
+  // Subroutines are declared before their body so they may call themselves.
+  if(dynamic_cast<Expression::Lambda *>(variable.initializer.get()))
+    declare(variable.variable, std::nullopt);
+  Value value{};
+  const bool initializerKnown{rewrite(variable.initializer, value)};
+  declare(variable.variable,
+          initializerKnown && variable.variable.constant ? std::make_optional(value)
+                                              : std::nullopt);
+  return Statement::Completion::Normal;
+}
+
+Statement::Completion ConstantFolder::visit(const Statement::Scope &scope,
+                                            Environment *env) {
+  scopes.push(ScopeKind::Block);
+  rewriteEach(scope.statements);
+  scopes.pop();
+  return Statement::Completion::Normal;
+}
+
+Statement::Completion ConstantFolder::visit(const Statement::If &ifStmt,
+                                            Environment *env) {
+  Value condition{};
+  const bool conditionKnown{rewrite(ifStmt.condition, condition)};
+  rewrite(ifStmt.thenStmt);
+  rewrite(ifStmt.elseStmt);
+  if(conditionKnown)
+    replace(std::move(operators::isTrue(condition) ? ifStmt.thenStmt
+                                                   : ifStmt.elseStmt));
+  return Statement::Completion::Normal;
+}
+
+Statement::Completion ConstantFolder::visit(const Statement::For &forStmt,
+                                            Environment *env) {
+  scopes.push();
+  rewrite(forStmt.initializer);
+  rewrite(forStmt.condition);
+  rewrite(forStmt.body);
+  rewrite(forStmt.update);
+  scopes.pop();
+  return Statement::Completion::Normal;
+}
+
+bool ConstantFolder::known(const Value &value, Value &result) {
+  result = value;
+  replace(std::make_unique<Expression::Literal>(value));
+  return true;
+}
+
+void ConstantFolder::declare(const Token &variable,
+                             const std::optional<Value> &value) {
+  scopes.declare(variable.symbol,
+                 scopes.innermost() == ScopeKind::Prototype || !value ||
+                         !isLiteral(value.value())
+                     ? std::nullopt
+                     : value);
+}
+
+std::optional<Value> ConstantFolder::constant(const Token &variable) const {
+  bool inherited{false};
+  if(const auto *declaration{scopes.lookup(variable.symbol, inherited)})
+    return *declaration;
+  // Globals the program declares are only known once their declaration is.
+  if(inherited || !globals || declaredGlobals.count(variable.symbol))
+    return std::nullopt;
+  const std::optional<Token> declaration{globals->declaration(variable)};
+  if(!declaration || !declaration->constant) return std::nullopt;
+  return globals->find(variable);
+}
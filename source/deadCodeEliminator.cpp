@@ -0,0 +1,401 @@
+#include "deadCodeEliminator.hpp"
+#include "operators.hpp"
+#include <algorithm>
+
+namespace {
+// Determines whether an expression may give no value, as calls to subroutines
+// that return nothing do.
+bool mayBeMissing(const Expression::Expression *expr) {
+  if(dynamic_cast<const Expression::Call *>(expr)) return true;
+  if(const auto *group{dynamic_cast<const Expression::Group *>(expr)})
+    return mayBeMissing(group->expr.get());
+  if(const auto *ternary{dynamic_cast<const Expression::Ternary *>(expr)})
+    return mayBeMissing(ternary->thenExpr.get()) ||
+           mayBeMissing(ternary->elseExpr.get());
+  return false;
+}
+
+// Gathers the names a program reads, assigns, or mentions as properties,
+// changing nothing.
+class Uses : public TreeRewriter {
+  public:
+  Uses(std::unordered_set<SymbolId> &iRead,
+       std::unordered_set<SymbolId> &iAssigned,
+       std::unordered_set<SymbolId> &iProperties,
+       std::unordered_set<SymbolId> &iAssignedInPrototypes,
+       std::unordered_set<SymbolId> &iAssignedMissing) :
+      read{iRead},
+      assigned{iAssigned},
+      properties{iProperties},
+      assignedInPrototypes{iAssignedInPrototypes},
+      assignedMissing{iAssignedMissing} {}
+
+  bool visit(const Expression::Variable &variable,
+             Environment *env,
+             Value &result) override {
+    read.insert(variable.variable.symbol);
+    return false;
+  }
+
+  bool visit(const Expression::Assignment &assignment,
+             Environment *env,
+             Value &result) override {
+    assigned.insert(assignment.variable.symbol);
+    if(prototypeDepth) assignedInPrototypes.insert(assignment.variable.symbol);
+    if(mayBeMissing(assignment.value.get()))
+      assignedMissing.insert(assignment.variable.symbol);
+    return TreeRewriter::visit(assignment, env, result);
+  }
+
+  bool visit(const Expression::Prototype &prototype,
+             Environment *env,
+             Value &result) override {
+    if(prototype.parent) read.insert(prototype.parent->symbol);
+    prototypeDepth++;
+    TreeRewriter::visit(prototype, env, result);
+    prototypeDepth--;
+    return false;
+  }
+
+  bool visit(const Expression::Set &set,
+             Environment *env,
+             Value &result) override {
+    properties.insert(set.property.symbol);
+    return TreeRewriter::visit(set, env, result);
+  }
+
+  bool visit(const Expression::Get &get,
+             Environment *env,
+             Value &result) override {
+    properties.insert(get.property.symbol);
+    return TreeRewriter::visit(get, env, result);
+  }
+
+  private:
+  std::unordered_set<SymbolId> &read;
+  std::unordered_set<SymbolId> &assigned;
+  std::unordered_set<SymbolId> &properties;
+  std::unordered_set<SymbolId> &assignedInPrototypes;
+  std::unordered_set<SymbolId> &assignedMissing;
+  int prototypeDepth{0};
+};
+
+// Counts the nodes of a tree, changing nothing.
+class Nodes : public TreeRewriter {
+  public:
+  std::size_t of(Statement::StatementUPtr &statement) {
+    count = 0;
+    rewrite(statement);
+    return count;
+  }
+
+  std::size_t of(Expression::ExpressionUPtr &expr) {
+    count = 0;
+    rewrite(expr);
+    return count;
+  }
+
+  bool visit(const Expression::Literal &literal,
+             Environment *env,
+             Value &result) override {
+    count++;
+    return TreeRewriter::visit(literal, env, result);
+  }
+
+  bool visit(const Expression::Unary &unary,
+             Environment *env,
+             Value &result) override {
+    count++;
+    return TreeRewriter::visit(unary, env, result);
+  }
+
+  bool visit(const Expression::Binary &binary,
+             Environment *env,
+             Value &result) override {
+    count++;
+    return TreeRewriter::visit(binary, env, result);
+  }
+
+  bool visit(const Expression::Logical &logical,
+             Environment *env,
+             Value &result) override {
+    count++;
+    return TreeRewriter::visit(logical, env, result);
+  }
+
+  bool visit(const Expression::Group &group,
+             Environment *env,
+             Value &result) override {
+    count++;
+    return TreeRewriter::visit(group, env, result);
+  }
+
+  bool visit(const Expression::Ternary &ternary,
+             Environment *env,
+             Value &result) override {
+    count++;
+    return TreeRewriter::visit(ternary, env, result);
+  }
+
+  bool visit(const Expression::Variable &variable,
+             Environment *env,
+             Value &result) override {
+    count++;
+    return TreeRewriter::visit(variable, env, result);
+  }
+
+  bool visit(const Expression::Assignment &assignment,
+             Environment *env,
+             Value &result) override {
+    count++;
+    return TreeRewriter::visit(assignment, env, result);
+  }
+
+  bool visit(const Expression::Call &call,
+             Environment *env,
+             Value &result) override {
+    count++;
+    return TreeRewriter::visit(call, env, result);
+  }
+
+  bool visit(const Expression::Lambda &lambda,
+             Environment *env,
+             Value &result) override {
+    count++;
+    return TreeRewriter::visit(lambda, env, result);
+  }
+
+  bool visit(const Expression::Prototype &prototype,
+             Environment *env,
+             Value &result) override {
+    count++;
+    return TreeRewriter::visit(prototype, env, result);
+  }
+
+  bool visit(const Expression::Set &set,
+             Environment *env,
+             Value &result) override {
+    count++;
+    return TreeRewriter::visit(set, env, result);
+  }
+
+  bool visit(const Expression::Get &get,
+             Environment *env,
+             Value &result) override {
+    count++;
+    return TreeRewriter::visit(get, env, result);
+  }
+
+  Statement::Completion visit(const Statement::Expression &expr,
+                              Environment *env) override {
+    count++;
+    return TreeRewriter::visit(expr, env);
+  }
+
+  Statement::Completion visit(const Statement::Variable &variable,
+                              Environment *env) override {
+    count++;
+    return TreeRewriter::visit(variable, env);
+  }
+
+  Statement::Completion visit(const Statement::Scope &scope,
+                              Environment *env) override {
+    count++;
+    return TreeRewriter::visit(scope, env);
+  }
+
+  Statement::Completion visit(const Statement::If &ifStmt,
+                              Environment *env) override {
+    count++;
+    return TreeRewriter::visit(ifStmt, env);
+  }
+
+  Statement::Completion visit(const Statement::For &forStmt,
+                              Environment *env) override {
+    count++;
+    return TreeRewriter::visit(forStmt, env);
+  }
+
+  Statement::Completion visit(const Statement::Return &returnStmt,
+                              Environment *env) override {
+    count++;
+    return TreeRewriter::visit(returnStmt, env);
+  }
+
+  private:
+  std::size_t count{0};
+};
+
+// Determines whether running a statement always ends in a return.
+bool returns(const Statement::Statement *statement) {
+  if(dynamic_cast<const Statement::Return *>(statement)) return true;
+  if(const auto *scope{dynamic_cast<const Statement::Scope *>(statement)})
+    return std::any_of(scope->statements.begin(),
+                       scope->statements.end(),
+                       [](const Statement::StatementUPtr &inner) {
+                         return returns(inner.get());
+                       });
+  if(const auto *ifStmt{dynamic_cast<const Statement::If *>(statement)})
+    return returns(ifStmt->thenStmt.get()) && returns(ifStmt->elseStmt.get());
+  return false;
+}
+} // namespace
+
+DeadCodeEliminator::DeadCodeEliminator() :
+    removedCode{{"unreachable statements"},
+                {"unused bindings"},
+                {"loops that never run"},
+                {"private helpers"}} {}
+
+void DeadCodeEliminator::rewrite(
+    std::vector<Statement::StatementUPtr> &statements) {
+  Uses{read, assigned, properties, assignedInPrototypes, assignedMissing}
+      .rewrite(statements);
+  scopes.push();
+  rewriteEach(statements);
+  scopes.pop();
+}
+
+const std::vector<DeadCodeEliminator::Removal> &
+    DeadCodeEliminator::removals() const {
+  return removedCode;
+}
+
+bool DeadCodeEliminator::visit(const Expression::Assignment &assignment,
+                               Environment *env,
+                               Value &result) {
+  TreeRewriter::visit(assignment, env, result);
+  const bool *removedDeclaration{scopes.lookup(assignment.variable.symbol)};
+  if(!removedDeclaration || !*removedDeclaration) return false;
+  removedCode[Unused].nodes++;
+  replace(std::move(assignment.value));
+  return false;
+}
+
+bool DeadCodeEliminator::visit(const Expression::Lambda &lambda,
+                               Environment *env,
+                               Value &result) {
+  scopes.push();
+  for(const Token &param : lambda.params) scopes.declare(param.symbol, false);
+  for(auto &param : lambda.defaultParams) {
+    rewrite(param.second);
+    scopes.declare(param.first.symbol, false);
+  }
+  rewrite(lambda.body);
+  scopes.pop();
+  return false;
+}
+
+bool DeadCodeEliminator::visit(const Expression::Prototype &prototype,
+                               Environment *env,
+                               Value &result) {
+  scopes.push(ScopeKind::Prototype);
+  rewrite(prototype.constructor);
+  rewriteEach(prototype.publicProperties);
+  for(Statement::StatementUPtr &property : prototype.privateProperties) {
+    rewrite(property);
+    const auto *helper{
+        dynamic_cast<const Statement::Variable *>(property.get())};
+    if(!helper ||
+       !dynamic_cast<const Expression::Lambda *>(helper->initializer.get()))
+      continue;
+    const SymbolId name{helper->variable.symbol};
+    if(read.count(name) || assigned.count(name) || properties.count(name))
+      continue;
+    removed(Helper, Nodes{}.of(property));
+    property.reset();
+  }
+  prototype.privateProperties.erase(
+      std::remove(prototype.privateProperties.begin(),
+                  prototype.privateProperties.end(),
+                  nullptr),
+      prototype.privateProperties.end());
+  scopes.pop();
+  return false;
+}
+
+Statement::Completion
+    DeadCodeEliminator::visit(const Statement::Variable &variable,
+                              Environment *env) {
+  rewrite(variable.initializer);
+  const Token &name{variable.variable};
+  // Constants stay declared so assigning them is still reported, and names
+  // given values that may be missing so that it is still an error.
+  const bool unused{scopes.innermost() == ScopeKind::Block &&
+                    !read.count(name.symbol) &&
+                    !assignedInPrototypes.count(name.symbol) &&
+                    !(name.constant && assigned.count(name.symbol)) &&
+                    !mayBeMissing(variable.initializer.get()) &&
+                    !assignedMissing.count(name.symbol)};
+  scopes.declare(name.symbol, unused);
+  if(!unused) return Statement::Completion::Normal;
+  Nodes nodes{};
+  if(!variable.initializer || inert(variable.initializer.get())) {
+    removed(Unused, 1 + nodes.of(variable.initializer));
+    replace(Statement::StatementUPtr{});
+  } else {
+    // Only the binding is removed, as the initializer still has to run.
+    removed(Unused, 1);
+    replace(std::make_unique<Statement::Expression>(
+        std::move(variable.initializer)));
+  }
+  return Statement::Completion::Normal;
+}
+
+Statement::Completion DeadCodeEliminator::visit(const Statement::Scope &scope,
+                                                Environment *env) {
+  scopes.push(ScopeKind::Block);
+  std::vector<Statement::StatementUPtr> &statements{scope.statements};
+  for(std::size_t i{0}; i < statements.size(); i++) {
+    rewrite(statements[i]);
+    if(!returns(statements[i].get())) continue;
+    for(std::size_t j{i + 1}; j < statements.size(); j++)
+      removed(Unreachable, Nodes{}.of(statements[j]));
+    statements.resize(i + 1);
+  }
+  statements.erase(std::remove(statements.begin(), statements.end(), nullptr),
+                   statements.end());
+  scopes.pop();
+  return Statement::Completion::Normal;
+}
+
+Statement::Completion DeadCodeEliminator::visit(const Statement::For &forStmt,
+                                                Environment *env) {
+  scopes.push();
+  TreeRewriter::visit(forStmt, env);
+  scopes.pop();
+  const auto *condition{
+      dynamic_cast<const Expression::Literal *>(forStmt.condition.get())};
+  if(!condition || operators::isTrue(condition->value))
+    return Statement::Completion::Normal;
+  Nodes nodes{};
+  removed(Loop,
+          1 + nodes.of(forStmt.condition) + nodes.of(forStmt.body) +
+              nodes.of(forStmt.update));
+  // The initializer still runs, within a scope of its own as before.
+  if(!forStmt.initializer) {
+    replace(Statement::StatementUPtr{});
+    return Statement::Completion::Normal;
+  }
+  std::vector<Statement::StatementUPtr> initializer{};
+  initializer.push_back(std::move(forStmt.initializer));
+  replace(std::make_unique<Statement::Scope>(std::move(initializer)));
+  return Statement::Completion::Normal;
+}
+
+bool DeadCodeEliminator::inert(const Expression::Expression *expr) const {
+  if(dynamic_cast<const Expression::Literal *>(expr) ||
+     dynamic_cast<const Expression::Lambda *>(expr))
+    return true;
+  if(const auto *group{dynamic_cast<const Expression::Group *>(expr)})
+    return inert(group->expr.get());
+  // Reading a name can only fail if nothing declares it.
+  if(const auto *variable{dynamic_cast<const Expression::Variable *>(expr)})
+    return scopes.lookup(variable->variable.symbol) != nullptr;
+  return false;
+}
+
+void DeadCodeEliminator::removed(const Kind kind, const std::size_t nodes) {
+  removedCode[kind].count++;
+  removedCode[kind].nodes += nodes;
+}
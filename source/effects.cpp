@@ -0,0 +1,91 @@
+#include "effects.hpp"
+#include "native.hpp"
+
+void Effects::analyze(Statement::StatementUPtr &statement) {
+  rewrite(statement);
+}
+
+void Effects::analyze(Expression::ExpressionUPtr &expr) { rewrite(expr); }
+
+bool Effects::writes(const Token &variable) const {
+  return assigned.count(variable.symbol) || declared.count(variable.symbol);
+}
+
+bool Effects::writesFromCalls(const Token &variable) const {
+  return assignedFromCalls.count(variable.symbol);
+}
+
+bool Effects::declares(const Token &variable) const {
+  return declared.count(variable.symbol);
+}
+
+bool Effects::rebinds(const Token &variable) const {
+  return assigned.count(variable.symbol) || redeclared.count(variable.symbol);
+}
+
+bool Effects::callsImpure(const Effects &program) const {
+  if(impureCalls) return true;
+  for(const SymbolId callee : nativeCallees)
+    if(program.declared.count(callee)) return true;
+  return false;
+}
+
+bool Effects::setsProperties() const { return sets; }
+
+bool Effects::visit(const Expression::Assignment &assignment,
+                    Environment *env,
+                    Value &result) {
+  assigned.insert(assignment.variable.symbol);
+  if(callableDepth) assignedFromCalls.insert(assignment.variable.symbol);
+  return TreeRewriter::visit(assignment, env, result);
+}
+
+bool Effects::visit(const Expression::Call &call,
+                    Environment *env,
+                    Value &result) {
+  const auto *name{
+      dynamic_cast<const Expression::Variable *>(call.callee.get())};
+  if(name && native::isPure(name->variable.lexeme))
+    nativeCallees.insert(name->variable.symbol);
+  else
+    impureCalls = true;
+  return TreeRewriter::visit(call, env, result);
+}
+
+bool Effects::visit(const Expression::Lambda &lambda,
+                    Environment *env,
+                    Value &result) {
+  for(const Token &param : lambda.params) declare(param);
+  for(const auto &param : lambda.defaultParams) declare(param.first);
+  callableDepth++;
+  TreeRewriter::visit(lambda, env, result);
+  callableDepth--;
+  return false;
+}
+
+bool Effects::visit(const Expression::Prototype &prototype,
+                    Environment *env,
+                    Value &result) {
+  callableDepth++;
+  TreeRewriter::visit(prototype, env, result);
+  callableDepth--;
+  return false;
+}
+
+bool Effects::visit(const Expression::Set &set,
+                    Environment *env,
+                    Value &result) {
+  sets = true;
+  return TreeRewriter::visit(set, env, result);
+}
+
+Statement::Completion Effects::visit(const Statement::Variable &variable,
+                                     Environment *env) {
+  declare(variable.variable);
+  return TreeRewriter::visit(variable, env);
+}
+
+void Effects::declare(const Token &variable) {
+  if(!declared.insert(variable.symbol).second)
+    redeclared.insert(variable.symbol);
+}
@@ -1,56 +1,111 @@
 #include "environment.hpp"
 
-Environment::Environment(const SymbolTable &iTable) : table{iTable} {}
+Environment::Environment(const SymbolTable &iTable,
+                         std::shared_ptr<Environment> iOuter) :
+    outer{iOuter.get()}, outerOwner{std::move(iOuter)}, table{iTable} {}
 
 Environment::Environment(const Environment &iEnv) :
-    outer{iEnv.outer}, table{iEnv.table} {}
+    outer{iEnv.outer}, outerOwner{iEnv.outerOwner}, table{iEnv.table} {
+  allocateSlots(iEnv.slotCount);
+  std::copy(iEnv.slots, iEnv.slots + slotCount, slots);
+}
 
-Environment::Environment(Environment *iEnv, const bool persist) {
-  outer = iEnv;
-  if(persist) {
-    outer = outer->outer;
-    table = iEnv->table;
-  }
+Environment::Environment(std::shared_ptr<Environment> iOuter,
+                         const std::size_t slotCount,
+                         EnvironmentPool *iPool) :
+    outer{iOuter.get()}, outerOwner{std::move(iOuter)}, pool{iPool} {
+  allocateSlots(slotCount);
 }
 
-void Environment::define(const Token &variable, const std::any &value) {
-  if(allowAssign) {
-    try {
-      assign(variable, value);
-    } catch(std::runtime_error) {
-      table = table.insert(variable, value);
-    }
-  } else
+Environment::Environment(Environment *iOuter,
+                         const std::size_t slotCount,
+                         EnvironmentPool *iPool) :
+    outer{iOuter}, pool{iPool} {
+  allocateSlots(slotCount);
+}
+
+Environment::~Environment() {
+  if(pool && slotCount > inlineSlotCount)
+    pool->deallocateSlots(slots, slotCount);
+}
+
+void Environment::define(const Token &variable, const Value &value) {
+  if(!allowAssign || tryAssign(variable, value) != AssignStatus::Assigned)
     table = table.insert(variable, value);
 }
 
-void Environment::assign(const Token &variable, const std::any &value) {
+void Environment::defineAt(const std::size_t slot, const Value &value) {
+  slots[slot] = value;
+}
+
+void Environment::assign(const Token &variable, const Value &value) {
+  switch(tryAssign(variable, value)) {
+    case AssignStatus::Constant:
+      throw std::runtime_error{"Can not assign to the constant " +
+                               variable.lexeme + "!"};
+    case AssignStatus::Undefined:
+      throw std::runtime_error{"Undefined variable \"" + variable.lexeme +
+                               "\"!"};
+    default: return;
+  }
+}
+
+Environment::AssignStatus Environment::tryAssign(const Token &variable,
+                                                 const Value &value) {
   auto entry = table.getEntry(variable);
-  if(entry && entry->first.constant)
-    throw std::runtime_error{"Can not assign to the constant " +
-                             variable.lexeme + "!"};
+  if(entry && entry->first.constant) return AssignStatus::Constant;
   if(entry) {
     table = table.assign(variable, value).value();
-    return;
+    return AssignStatus::Assigned;
   }
-  if(outer) {
-    outer->assign(variable, value);
-    return;
-  }
-  throw std::runtime_error{"Undefined variable \"" + variable.lexeme + "\"!"};
+  if(outer) return outer->tryAssign(variable, value);
+  return AssignStatus::Undefined;
+}
+
+void Environment::assignAt(const std::size_t depth,
+                           const std::size_t slot,
+                           const Value &value) {
+  ancestor(depth)->slots[slot] = value;
 }
 
-std::any Environment::get(const Token &variable) {
-  std::optional<std::any> value{table.get(variable)};
-  if(!value && outer) value = outer->get(variable);
+Value Environment::get(const Token &variable) {
+  std::optional<Value> value{find(variable)};
   if(value) return value.value();
   throw std::runtime_error{"Undefined variable!"};
 }
 
+std::optional<Value> Environment::find(const Token &variable) {
+  std::optional<Value> value{table.get(variable)};
+  if(!value && outer) return outer->find(variable);
+  return value;
+}
+
+Value Environment::getAt(const std::size_t depth, const std::size_t slot) {
+  return ancestor(depth)->slots[slot];
+}
+
+Cell &Environment::cellAt(const std::size_t depth, const std::size_t slot) {
+  return ancestor(depth)->slots[slot];
+}
+
+std::optional<Token> Environment::declaration(const Token &variable) const {
+  auto entry = table.getEntry(variable);
+  if(entry) return entry->first;
+  return {};
+}
+
 void Environment::copyOver(Environment *other) {
   table = table.copyOver(other->table);
 }
 
+std::shared_ptr<Environment> Environment::copy() {
+  std::shared_ptr<Environment> newEnv{
+      std::make_shared<Environment>(outerOwner, slotCount)};
+  newEnv->copyOver(this);
+  std::copy(slots, slots + slotCount, newEnv->slots);
+  return newEnv;
+}
+
 void Environment::defineOrAssign(const bool iAllowAssign) {
   allowAssign = iAllowAssign;
 }
@@ -59,5 +114,37 @@ std::shared_ptr<Environment>
     Environment::unionize(const std::vector<Environment *> &envs) {
   std::vector<SymbolTable> tables{};
   for(Environment *env : envs) tables.push_back(env->table);
-  return std::make_shared<Environment>(SymbolTable::unionize(tables));
-}
\ No newline at end of file
+  return std::make_shared<Environment>(
+      SymbolTable::unionize(tables),
+      envs.empty() ? nullptr : envs.front()->outerOwner);
+}
+
+void Environment::reserveSlots(const std::size_t count) {
+  if(count <= slotCount) return;
+  std::unique_ptr<Value[]> oldExtraSlots{std::move(extraSlots)};
+  Value *const oldSlots{slots};
+  const std::size_t oldCount{slotCount};
+  // Doubling keeps declaring globals one at a time linear overall.
+  allocateSlots(std::max(count, 2 * oldCount));
+  if(slots == oldSlots) return;
+  std::move(oldSlots, oldSlots + oldCount, slots);
+  if(pool && oldCount > inlineSlotCount)
+    pool->deallocateSlots(oldSlots, oldCount);
+}
+
+Environment *Environment::ancestor(const std::size_t depth) {
+  Environment *env{this};
+  for(std::size_t i{0}; i < depth; i++) env = env->outer;
+  return env;
+}
+
+void Environment::allocateSlots(const std::size_t count) {
+  slotCount = count;
+  if(count <= inlineSlotCount) return;
+  if(pool)
+    slots = pool->allocateSlots(count);
+  else {
+    extraSlots = std::make_unique<Value[]>(count);
+    slots = extraSlots.get();
+  }
+}
@@ -0,0 +1,54 @@
+#include "environmentPool.hpp"
+
+void *EnvironmentPool::allocate(const std::size_t bytes) {
+  const std::size_t size{units(bytes)};
+  counts.allocations++;
+  if(size > classCount) {
+    counts.oversized++;
+    return ::operator new(size * sizeof(Unit));
+  }
+  if(FreeBlock *block{freeLists[size - 1]}) {
+    freeLists[size - 1] = block->next;
+    counts.reused++;
+    return block;
+  }
+  if(static_cast<std::size_t>(end - next) < size) {
+    chunks.push_back(std::make_unique<Unit[]>(chunkUnits));
+    counts.chunks++;
+    next = chunks.back().get();
+    end = next + chunkUnits;
+  }
+  Unit *block{next};
+  next += size;
+  return block;
+}
+
+void EnvironmentPool::deallocate(void *block,
+                                 const std::size_t bytes) noexcept {
+  const std::size_t size{units(bytes)};
+  if(size > classCount) {
+    ::operator delete(block);
+    return;
+  }
+  freeLists[size - 1] = new(block) FreeBlock{freeLists[size - 1]};
+}
+
+Value *EnvironmentPool::allocateSlots(const std::size_t count) {
+  auto *slots{static_cast<Value *>(allocate(count * sizeof(Value)))};
+  std::uninitialized_default_construct_n(slots, count);
+  return slots;
+}
+
+void EnvironmentPool::deallocateSlots(Value *slots,
+                                      const std::size_t count) noexcept {
+  std::destroy_n(slots, count);
+  deallocate(slots, count * sizeof(Value));
+}
+
+const EnvironmentPool::Stats &EnvironmentPool::stats() const {
+  return counts;
+}
+
+std::size_t EnvironmentPool::units(const std::size_t bytes) {
+  return bytes == 0 ? 1 : (bytes + sizeof(Unit) - 1) / sizeof(Unit);
+}
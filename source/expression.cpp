@@ -1,17 +1,17 @@
 #include "expression.hpp"
 
 namespace Expression {
-Literal::Literal(const std::any &iValue) : value{iValue} {}
+Literal::Literal(const Value &iValue) : value{iValue} {}
 
-std::optional<std::any> Literal::accept(Visitor *visitor, Environment *env) {
-  return visitor->visit(*this, env);
+bool Literal::accept(Visitor *visitor, Environment *env, Value &result) {
+  return visitor->visit(*this, env, result);
 }
 
 Unary::Unary(const ::Token &iOp, ExpressionUPtr iRight) :
     op{iOp}, right{std::move(iRight)} {}
 
-std::optional<std::any> Unary::accept(Visitor *visitor, Environment *env) {
-  return visitor->visit(*this, env);
+bool Unary::accept(Visitor *visitor, Environment *env, Value &result) {
+  return visitor->visit(*this, env, result);
 }
 
 Binary::Binary(ExpressionUPtr iLeft,
@@ -19,14 +19,23 @@ Binary::Binary(ExpressionUPtr iLeft,
                ExpressionUPtr iRight) :
     left{std::move(iLeft)}, op{iOp}, right{std::move(iRight)} {}
 
-std::optional<std::any> Binary::accept(Visitor *visitor, Environment *env) {
-  return visitor->visit(*this, env);
+bool Binary::accept(Visitor *visitor, Environment *env, Value &result) {
+  return visitor->visit(*this, env, result);
+}
+
+Logical::Logical(ExpressionUPtr iLeft,
+                 const ::Token &iOp,
+                 ExpressionUPtr iRight) :
+    left{std::move(iLeft)}, op{iOp}, right{std::move(iRight)} {}
+
+bool Logical::accept(Visitor *visitor, Environment *env, Value &result) {
+  return visitor->visit(*this, env, result);
 }
 
 Group::Group(ExpressionUPtr iExpr) : expr{std::move(iExpr)} {}
 
-std::optional<std::any> Group::accept(Visitor *visitor, Environment *env) {
-  return visitor->visit(*this, env);
+bool Group::accept(Visitor *visitor, Environment *env, Value &result) {
+  return visitor->visit(*this, env, result);
 }
 
 Ternary::Ternary(ExpressionUPtr iThenExpr,
@@ -36,21 +45,21 @@ Ternary::Ternary(ExpressionUPtr iThenExpr,
     condition{std::move(iCondition)},
     elseExpr{std::move(iElseExpr)} {}
 
-std::optional<std::any> Ternary::accept(Visitor *visitor, Environment *env) {
-  return visitor->visit(*this, env);
+bool Ternary::accept(Visitor *visitor, Environment *env, Value &result) {
+  return visitor->visit(*this, env, result);
 }
 
 Variable::Variable(const ::Token &iVariable) : variable{iVariable} {}
 
-std::optional<std::any> Variable::accept(Visitor *visitor, Environment *env) {
-  return visitor->visit(*this, env);
+bool Variable::accept(Visitor *visitor, Environment *env, Value &result) {
+  return visitor->visit(*this, env, result);
 }
 
 Assignment::Assignment(const ::Token &iVariable, ExpressionUPtr iValue) :
     variable{iVariable}, value{std::move(iValue)} {}
 
-std::optional<std::any> Assignment::accept(Visitor *visitor, Environment *env) {
-  return visitor->visit(*this, env);
+bool Assignment::accept(Visitor *visitor, Environment *env, Value &result) {
+  return visitor->visit(*this, env, result);
 }
 
 Call::Call(ExpressionUPtr iCallee,
@@ -60,8 +69,8 @@ Call::Call(ExpressionUPtr iCallee,
     args{std::move(iArgs)},
     closingParen{iClosingParen} {}
 
-std::optional<std::any> Call::accept(Visitor *visitor, Environment *env) {
-  return visitor->visit(*this, env);
+bool Call::accept(Visitor *visitor, Environment *env, Value &result) {
+  return visitor->visit(*this, env, result);
 }
 
 Lambda::Lambda(const std::vector<::Token> &iParams,
@@ -71,8 +80,8 @@ Lambda::Lambda(const std::vector<::Token> &iParams,
     defaultParams{std::move(iDefaultParams)},
     body{std::move(iBody)} {}
 
-std::optional<std::any> Lambda::accept(Visitor *visitor, Environment *env) {
-  return visitor->visit(*this, env);
+bool Lambda::accept(Visitor *visitor, Environment *env, Value &result) {
+  return visitor->visit(*this, env, result);
 }
 
 Prototype::Prototype(ExpressionUPtr iConstructor,
@@ -84,8 +93,8 @@ Prototype::Prototype(ExpressionUPtr iConstructor,
     publicProperties{std::move(iPublicProperties)},
     privateProperties{std::move(iPrivateProperties)} {}
 
-std::optional<std::any> Prototype::accept(Visitor *visitor, Environment *env) {
-  return visitor->visit(*this, env);
+bool Prototype::accept(Visitor *visitor, Environment *env, Value &result) {
+  return visitor->visit(*this, env, result);
 }
 
 Set::Set(ExpressionUPtr iObject,
@@ -93,15 +102,15 @@ Set::Set(ExpressionUPtr iObject,
          ExpressionUPtr iValue) :
     object{std::move(iObject)}, property{iProperty}, value{std::move(iValue)} {}
 
-std::optional<std::any> Set::accept(Visitor *visitor, Environment *env) {
-  return visitor->visit(*this, env);
+bool Set::accept(Visitor *visitor, Environment *env, Value &result) {
+  return visitor->visit(*this, env, result);
 }
 
 Get::Get(ExpressionUPtr iObject, const ::Token &iProperty) :
     object{std::move(iObject)}, property{iProperty} {}
 
-std::optional<std::any> Get::accept(Visitor *visitor, Environment *env) {
-  return visitor->visit(*this, env);
+bool Get::accept(Visitor *visitor, Environment *env, Value &result) {
+  return visitor->visit(*this, env, result);
 }
 
 } // namespace Expression
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include "globalEnvironment.hpp"
+
+std::size_t GlobalEnvironment::declare(const Token &variable) {
+  auto [index, inserted] =
+      indices.try_emplace(variable.symbol, declarations.size());
+  if(inserted) {
+    declarations.push_back(variable);
+    defined.push_back(false);
+    reserveSlots(declarations.size());
+  } else
+    declarations[index->second] = variable;
+  return index->second;
+}
+
+std::optional<std::size_t>
+    GlobalEnvironment::slot(const Token &variable) const {
+  auto index{indices.find(variable.symbol)};
+  if(index == indices.end()) return {};
+  return index->second;
+}
+
+std::size_t GlobalEnvironment::size() const {
+  return declarations.size();
+}
+
+void GlobalEnvironment::define(const Token &variable, const Value &value) {
+  defineSlot(declare(variable), value);
+}
+
+void GlobalEnvironment::defineSlot(const std::size_t slot, const Value &value) {
+  defineAt(slot, value);
+  defined[slot] = true;
+}
+
+Value GlobalEnvironment::getSlot(const std::size_t slot) {
+  if(!defined[slot]) throw std::runtime_error{"Undefined variable!"};
+  return getAt(0, slot);
+}
+
+void GlobalEnvironment::assignSlot(const std::size_t slot, const Value &value) {
+  if(!defined[slot])
+    throw std::runtime_error{"Undefined variable \"" +
+                             declarations[slot].lexeme + "\"!"};
+  assignAt(0, slot, value);
+}
+
+GlobalEnvironment::AssignStatus
+    GlobalEnvironment::tryAssign(const Token &variable, const Value &value) {
+  std::optional<std::size_t> index{slot(variable)};
+  if(!index || !defined[index.value()]) return AssignStatus::Undefined;
+  if(declarations[index.value()].constant) return AssignStatus::Constant;
+  assignAt(0, index.value(), value);
+  return AssignStatus::Assigned;
+}
+
+std::optional<Value> GlobalEnvironment::find(const Token &variable) {
+  std::optional<std::size_t> index{slot(variable)};
+  if(!index || !defined[index.value()]) return {};
+  return getAt(0, index.value());
+}
+
+std::optional<Token>
+    GlobalEnvironment::declaration(const Token &variable) const {
+  std::optional<std::size_t> index{slot(variable)};
+  if(!index) return {};
+  return declarations[index.value()];
+}
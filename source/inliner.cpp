@@ -0,0 +1,399 @@
+#include "inliner.hpp"
+#include "native.hpp"
+#include <functional>
+
+namespace {
+using Order = std::unordered_map<SymbolId, std::size_t>;
+using Substitute =
+    std::function<Expression::ExpressionUPtr(const Expression::Variable &)>;
+
+// Gets the expression a lambda returns if returning it is all the lambda does.
+const Expression::Expression *returned(const Expression::Lambda &lambda) {
+  const auto *body{dynamic_cast<const Statement::Scope *>(lambda.body.get())};
+  if(!body || body->statements.size() != 1) return nullptr;
+  const auto *returnStmt{
+      dynamic_cast<const Statement::Return *>(body->statements[0].get())};
+  return returnStmt ? returnStmt->expr.get() : nullptr;
+}
+
+// Counts the nodes of an expression.
+std::size_t size(const Expression::Expression *expr) {
+  if(!expr) return 0;
+  if(const auto *unary{dynamic_cast<const Expression::Unary *>(expr)})
+    return 1 + size(unary->right.get());
+  if(const auto *binary{dynamic_cast<const Expression::Binary *>(expr)})
+    return 1 + size(binary->left.get()) + size(binary->right.get());
+  if(const auto *logical{dynamic_cast<const Expression::Logical *>(expr)})
+    return 1 + size(logical->left.get()) + size(logical->right.get());
+  if(const auto *group{dynamic_cast<const Expression::Group *>(expr)})
+    return 1 + size(group->expr.get());
+  if(const auto *ternary{dynamic_cast<const Expression::Ternary *>(expr)})
+    return 1 + size(ternary->condition.get()) + size(ternary->thenExpr.get()) +
+           size(ternary->elseExpr.get());
+  if(const auto *call{dynamic_cast<const Expression::Call *>(expr)}) {
+    std::size_t nodes{1 + size(call->callee.get())};
+    for(const Expression::ExpressionUPtr &arg : call->args)
+      nodes += size(arg.get());
+    return nodes;
+  }
+  if(const auto *get{dynamic_cast<const Expression::Get *>(expr)})
+    return 1 + size(get->object.get());
+  return 1;
+}
+
+// Determines whether an expression reads any of the given parameters.
+bool mentions(const Expression::Expression *expr, const Order &params) {
+  if(const auto *variable{dynamic_cast<const Expression::Variable *>(expr)})
+    return params.count(variable->variable.symbol);
+  if(const auto *unary{dynamic_cast<const Expression::Unary *>(expr)})
+    return mentions(unary->right.get(), params);
+  if(const auto *binary{dynamic_cast<const Expression::Binary *>(expr)})
+    return mentions(binary->left.get(), params) ||
+           mentions(binary->right.get(), params);
+  if(const auto *logical{dynamic_cast<const Expression::Logical *>(expr)})
+    return mentions(logical->left.get(), params) ||
+           mentions(logical->right.get(), params);
+  if(const auto *group{dynamic_cast<const Expression::Group *>(expr)})
+    return mentions(group->expr.get(), params);
+  if(const auto *ternary{dynamic_cast<const Expression::Ternary *>(expr)})
+    return mentions(ternary->condition.get(), params) ||
+           mentions(ternary->thenExpr.get(), params) ||
+           mentions(ternary->elseExpr.get(), params);
+  if(const auto *call{dynamic_cast<const Expression::Call *>(expr)}) {
+    if(mentions(call->callee.get(), params)) return true;
+    for(const Expression::ExpressionUPtr &arg : call->args)
+      if(mentions(arg.get(), params)) return true;
+    return false;
+  }
+  if(const auto *get{dynamic_cast<const Expression::Get *>(expr)})
+    return mentions(get->object.get(), params);
+  return false;
+}
+
+// Determines whether the given parameters are each read once, in order, where
+// their argument would have been evaluated: ahead of anything else in the body
+// that could fail, and not only on some paths through it.
+bool inOrder(const Expression::Expression *expr,
+             const Order &params,
+             std::size_t &next,
+             bool &clean) {
+  if(const auto *variable{dynamic_cast<const Expression::Variable *>(expr)}) {
+    auto param{params.find(variable->variable.symbol)};
+    if(param == params.end()) return true;
+    if(!clean || param->second != next) return false;
+    next++;
+    return true;
+  }
+  bool ordered{true};
+  if(const auto *unary{dynamic_cast<const Expression::Unary *>(expr)}) {
+    ordered = inOrder(unary->right.get(), params, next, clean);
+  } else if(const auto *binary{
+                dynamic_cast<const Expression::Binary *>(expr)}) {
+    ordered = inOrder(binary->left.get(), params, next, clean) &&
+              inOrder(binary->right.get(), params, next, clean);
+  } else if(const auto *logical{
+                dynamic_cast<const Expression::Logical *>(expr)}) {
+    ordered = inOrder(logical->left.get(), params, next, clean) &&
+              !mentions(logical->right.get(), params);
+  } else if(const auto *group{
+                dynamic_cast<const Expression::Group *>(expr)}) {
+    return inOrder(group->expr.get(), params, next, clean);
+  } else if(const auto *ternary{
+                dynamic_cast<const Expression::Ternary *>(expr)}) {
+    ordered = inOrder(ternary->condition.get(), params, next, clean) &&
+              !mentions(ternary->thenExpr.get(), params) &&
+              !mentions(ternary->elseExpr.get(), params);
+  } else if(const auto *call{
+                dynamic_cast<const Expression::Call *>(expr)}) {
+    ordered = inOrder(call->callee.get(), params, next, clean);
+    for(const Expression::ExpressionUPtr &arg : call->args)
+      ordered = ordered && inOrder(arg.get(), params, next, clean);
+  } else if(const auto *get{dynamic_cast<const Expression::Get *>(expr)}) {
+    ordered = inOrder(get->object.get(), params, next, clean);
+  } else {
+    return true;
+  }
+  clean = false;
+  return ordered;
+}
+
+// Copies an expression, putting whatever the given function gives in place of
+// each variable.
+Expression::ExpressionUPtr clone(const Expression::Expression *expr,
+                                 const Substitute &substitute) {
+  if(const auto *literal{dynamic_cast<const Expression::Literal *>(expr)})
+    return std::make_unique<Expression::Literal>(literal->value);
+  if(const auto *variable{dynamic_cast<const Expression::Variable *>(expr)})
+    return substitute(*variable);
+  if(const auto *unary{dynamic_cast<const Expression::Unary *>(expr)})
+    return std::make_unique<Expression::Unary>(
+        unary->op, clone(unary->right.get(), substitute));
+  if(const auto *binary{dynamic_cast<const Expression::Binary *>(expr)})
+    return std::make_unique<Expression::Binary>(
+        clone(binary->left.get(), substitute),
+        binary->op,
+        clone(binary->right.get(), substitute));
+  if(const auto *logical{dynamic_cast<const Expression::Logical *>(expr)})
+    return std::make_unique<Expression::Logical>(
+        clone(logical->left.get(), substitute),
+        logical->op,
+        clone(logical->right.get(), substitute));
+  if(const auto *group{dynamic_cast<const Expression::Group *>(expr)})
+    return std::make_unique<Expression::Group>(
+        clone(group->expr.get(), substitute));
+  if(const auto *ternary{dynamic_cast<const Expression::Ternary *>(expr)})
+    return std::make_unique<Expression::Ternary>(
+        clone(ternary->thenExpr.get(), substitute),
+        clone(ternary->condition.get(), substitute),
+        clone(ternary->elseExpr.get(), substitute));
+  if(const auto *call{dynamic_cast<const Expression::Call *>(expr)}) {
+    std::vector<Expression::ExpressionUPtr> args{};
+    for(const Expression::ExpressionUPtr &arg : call->args)
+      args.push_back(clone(arg.get(), substitute));
+    return std::make_unique<Expression::Call>(
+        clone(call->callee.get(), substitute),
+        std::move(args),
+        call->closingParen);
+  }
+  const auto *get{dynamic_cast<const Expression::Get *>(expr)};
+  return std::make_unique<Expression::Get>(clone(get->object.get(), substitute),
+                                           get->property);
+}
+} // namespace
+
+Inliner::Inliner(const std::size_t iBudget) : budget{iBudget} {}
+
+void Inliner::rewrite(std::vector<Statement::StatementUPtr> &statements) {
+  program.rewrite(statements);
+  for(const Statement::StatementUPtr &statement : statements)
+    if(auto *variable{dynamic_cast<Statement::Variable *>(statement.get())})
+      declaredGlobals.insert(variable->variable.symbol);
+  scopes.push();
+  rewriteEach(statements);
+  scopes.pop();
+}
+
+const std::vector<Inliner::Inline> &Inliner::inlines() const {
+  return inlinedCalls;
+}
+
+bool Inliner::visit(const Expression::Call &call,
+                    Environment *env,
+                    Value &result) {
+  TreeRewriter::visit(call, env, result);
+  const auto *name{
+      dynamic_cast<const Expression::Variable *>(call.callee.get())};
+  if(!name || program.rebinds(name->variable)) return false;
+  const std::optional<Declaration> declaration{
+      lookup(name->variable.symbol)};
+  if(!declaration || !declaration.value()) return false;
+  auto subroutine{subroutines.find(declaration.value())};
+  if(subroutine == subroutines.end()) return false;
+  Expression::ExpressionUPtr body{inlined(call, subroutine->second)};
+  if(!body) return false;
+  inlinedCalls.push_back(
+      Inline{name->variable.lexeme, call.closingParen.line});
+  replace(std::move(body));
+  return false;
+}
+
+bool Inliner::visit(const Expression::Lambda &lambda,
+                    Environment *env,
+                    Value &result) {
+  scopes.push();
+  for(const Token &param : lambda.params) scopes.declare(param.symbol, &param);
+  for(auto &param : lambda.defaultParams) {
+    rewrite(param.second);
+    scopes.declare(param.first.symbol, &param.first);
+  }
+  rewrite(lambda.body);
+  scopes.pop();
+  return false;
+}
+
+bool Inliner::visit(const Expression::Prototype &prototype,
+                    Environment *env,
+                    Value &result) {
+  scopes.push(ScopeKind::Prototype);
+  TreeRewriter::visit(prototype, env, result);
+  scopes.pop();
+  return false;
+}
+
+Statement::Completion Inliner::visit(const Statement::Variable &variable,
+                                     Environment *env) {
+  scopes.declare(variable.variable.symbol, &variable.variable);
+  rewrite(variable.initializer);
+  const auto *lambda{
+      dynamic_cast<const Expression::Lambda *>(variable.initializer.get())};
+  if(!lambda || scopes.innermost() == ScopeKind::Prototype)
+    return Statement::Completion::Normal;
+  Subroutine subroutine{lambda, returned(*lambda)};
+  if(subroutine.returned && size(subroutine.returned) <= budget &&
+     inlinable(subroutine.returned, subroutine))
+    subroutines.emplace(&variable.variable, std::move(subroutine));
+  return Statement::Completion::Normal;
+}
+
+Statement::Completion Inliner::visit(const Statement::Scope &scope,
+                                     Environment *env) {
+  scopes.push(ScopeKind::Block);
+  TreeRewriter::visit(scope, env);
+  scopes.pop();
+  return Statement::Completion::Normal;
+}
+
+Statement::Completion Inliner::visit(const Statement::For &forStmt,
+                                     Environment *env) {
+  scopes.push();
+  TreeRewriter::visit(forStmt, env);
+  scopes.pop();
+  return Statement::Completion::Normal;
+}
+
+std::optional<Inliner::Declaration> Inliner::lookup(
+    const SymbolId variable) const {
+  bool inherited{false};
+  const Declaration *declaration{scopes.lookup(variable, inherited)};
+  if(inherited) return std::nullopt;
+  return declaration ? *declaration : nullptr;
+}
+
+bool Inliner::inlinable(const Expression::Expression *expr,
+                        Subroutine &subroutine) const {
+  if(dynamic_cast<const Expression::Literal *>(expr)) return true;
+  if(const auto *variable{dynamic_cast<const Expression::Variable *>(expr)}) {
+    const Expression::Lambda &lambda{*subroutine.lambda};
+    const SymbolId symbol{variable->variable.symbol};
+    for(const Token &param : lambda.params)
+      if(param.symbol == symbol) return true;
+    for(const auto &param : lambda.defaultParams)
+      if(param.first.symbol == symbol) return true;
+    const std::optional<Declaration> declaration{lookup(symbol)};
+    if(!declaration) return false;
+    if(!declaration.value() && declaredGlobals.count(symbol))
+      subroutine.laterGlobals.insert(symbol);
+    else
+      subroutine.names[symbol] = declaration.value();
+    return true;
+  }
+  if(const auto *unary{dynamic_cast<const Expression::Unary *>(expr)})
+    return inlinable(unary->right.get(), subroutine);
+  if(const auto *binary{dynamic_cast<const Expression::Binary *>(expr)})
+    return inlinable(binary->left.get(), subroutine) &&
+           inlinable(binary->right.get(), subroutine);
+  if(const auto *logical{dynamic_cast<const Expression::Logical *>(expr)})
+    return inlinable(logical->left.get(), subroutine) &&
+           inlinable(logical->right.get(), subroutine);
+  if(const auto *group{dynamic_cast<const Expression::Group *>(expr)})
+    return inlinable(group->expr.get(), subroutine);
+  if(const auto *ternary{dynamic_cast<const Expression::Ternary *>(expr)})
+    return inlinable(ternary->condition.get(), subroutine) &&
+           inlinable(ternary->thenExpr.get(), subroutine) &&
+           inlinable(ternary->elseExpr.get(), subroutine);
+  if(const auto *call{dynamic_cast<const Expression::Call *>(expr)}) {
+    // Only natives may be called, which no program declares.
+    const auto *callee{
+        dynamic_cast<const Expression::Variable *>(call->callee.get())};
+    if(!callee || program.declares(callee->variable) ||
+       !inlinable(callee, subroutine))
+      return false;
+    for(const Expression::ExpressionUPtr &arg : call->args)
+      if(!inlinable(arg.get(), subroutine)) return false;
+    return true;
+  }
+  if(const auto *get{dynamic_cast<const Expression::Get *>(expr)})
+    return inlinable(get->object.get(), subroutine);
+  return false;
+}
+
+bool Inliner::pure(const Expression::Expression *expr) const {
+  if(dynamic_cast<const Expression::Literal *>(expr) ||
+     dynamic_cast<const Expression::Variable *>(expr))
+    return true;
+  if(const auto *unary{dynamic_cast<const Expression::Unary *>(expr)})
+    return pure(unary->right.get());
+  if(const auto *binary{dynamic_cast<const Expression::Binary *>(expr)})
+    return pure(binary->left.get()) && pure(binary->right.get());
+  if(const auto *logical{dynamic_cast<const Expression::Logical *>(expr)})
+    return pure(logical->left.get()) && pure(logical->right.get());
+  if(const auto *group{dynamic_cast<const Expression::Group *>(expr)})
+    return pure(group->expr.get());
+  if(const auto *ternary{dynamic_cast<const Expression::Ternary *>(expr)})
+    return pure(ternary->condition.get()) && pure(ternary->thenExpr.get()) &&
+           pure(ternary->elseExpr.get());
+  if(const auto *call{dynamic_cast<const Expression::Call *>(expr)}) {
+    const auto *callee{
+        dynamic_cast<const Expression::Variable *>(call->callee.get())};
+    if(!callee || !native::isPure(callee->variable.lexeme) ||
+       program.declares(callee->variable))
+      return false;
+    for(const Expression::ExpressionUPtr &arg : call->args)
+      if(!pure(arg.get())) return false;
+    return true;
+  }
+  if(const auto *get{dynamic_cast<const Expression::Get *>(expr)})
+    return pure(get->object.get());
+  return false;
+}
+
+Expression::ExpressionUPtr Inliner::inlined(
+    const Expression::Call &call,
+    const Subroutine &subroutine) const {
+  const Expression::Lambda &lambda{*subroutine.lambda};
+  const std::size_t arity{lambda.params.size() + lambda.defaultParams.size()};
+  if(call.args.size() < lambda.params.size() || call.args.size() > arity)
+    return nullptr;
+  for(const auto &[symbol, declaration] : subroutine.names) {
+    const std::optional<Declaration> atCall{lookup(symbol)};
+    if(!atCall || atCall.value() != declaration) return nullptr;
+  }
+  // Globals declared after the subroutine are only read in its place once
+  // they are declared and nothing closer hides them.
+  for(const SymbolId symbol : subroutine.laterGlobals) {
+    const Declaration *global{scopes.outermost(symbol)};
+    if(!global || lookup(symbol) != std::optional<Declaration>{*global})
+      return nullptr;
+  }
+  // Each parameter takes its argument, or its default if there is none.
+  // Arguments that compute anything are moved into the body rather than
+  // copied, so they must be evaluated exactly once.
+  std::unordered_map<SymbolId, Expression::ExpressionUPtr *> moved{};
+  std::unordered_map<SymbolId, const Expression::Expression *> copied{};
+  Order order{};
+  for(std::size_t i{0}; i < arity; i++) {
+    const Token &param{i < lambda.params.size()
+                           ? lambda.params[i]
+                           : lambda.defaultParams[i - lambda.params.size()]
+                                 .first};
+    if(i >= call.args.size()) {
+      const Expression::Expression *fallback{
+          lambda.defaultParams[i - lambda.params.size()].second.get()};
+      if(!dynamic_cast<const Expression::Literal *>(fallback)) return nullptr;
+      copied[param.symbol] = fallback;
+    } else if(dynamic_cast<const Expression::Literal *>(call.args[i].get()) ||
+              dynamic_cast<const Expression::Variable *>(call.args[i].get())) {
+      copied[param.symbol] = call.args[i].get();
+    } else if(pure(call.args[i].get())) {
+      order.emplace(param.symbol, order.size());
+      moved[param.symbol] = &call.args[i];
+    } else {
+      return nullptr;
+    }
+  }
+  std::size_t next{0};
+  bool clean{true};
+  if(!inOrder(subroutine.returned, order, next, clean) || next != order.size())
+    return nullptr;
+  return clone(
+      subroutine.returned,
+      [&](const Expression::Variable &variable) -> Expression::ExpressionUPtr {
+        const SymbolId symbol{variable.variable.symbol};
+        if(moved.count(symbol)) return std::move(*moved[symbol]);
+        if(copied.count(symbol))
+          return clone(copied[symbol], [](const Expression::Variable &copy) {
+            return std::make_unique<Expression::Variable>(copy.variable);
+          });
+        return std::make_unique<Expression::Variable>(variable.variable);
+      });
+}
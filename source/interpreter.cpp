@@ -1,6 +1,32 @@
 #include "interpreter.hpp"
+#include "closureCompiler.hpp"
+
+namespace {
+// Applies the operation an operator was specialized to, specializing it to
+// the operands first if it has not been. Returns false when the generic
+// operator has to be applied instead.
+template <typename Operation, typename... Operands>
+bool specialized(Expression::Specialization<Operation> &specialization,
+                 const Token::Type op,
+                 Value &operand,
+                 const Operands &...others) {
+  using State = typename Expression::Specialization<Operation>::State;
+  if(specialization.state == State::Unspecialized) {
+    specialization.operation = operators::specialize(op, operand, others...);
+    specialization.state =
+        specialization.operation ? State::Specialized : State::Generic;
+  }
+  if(specialization.state != State::Specialized) return false;
+  if(specialization.operation(operand, others...)) return true;
+  // Operators that see more than one kind of operand stay generic.
+  specialization.state = State::Generic;
+  return false;
+}
+} // namespace
 
-Interpreter::Interpreter() : global{std::make_shared<Environment>()} {
+Interpreter::Interpreter(const Mode iMode) :
+    mode{iMode}, global{std::make_shared<GlobalEnvironment>()} {
+  // Natives are defined first so they always take the same slots.
   using namespace std::placeholders;
   global->define(Token{"doNothing", Token::Type::Identifier},
                  Callable{0, 0, std::bind(native::doNothing, _1, _2), global});
@@ -80,156 +106,138 @@ Interpreter::Interpreter() : global{std::make_shared<Environment>()} {
   global->define(Token{"NaN", Token::Type::Identifier}, native::NaN);
 }
 
-std::optional<std::any> Interpreter::visit(const Expression::Literal &literal,
-                                           Environment *env) {
-  return literal.value;
+bool Interpreter::visit(const Expression::Literal &literal,
+                        Environment *env,
+                        Value &result) {
+  result = literal.value;
+  return true;
 }
 
-std::optional<std::any> Interpreter::visit(const Expression::Unary &unary,
-                                           Environment *env) {
-  std::any rightVal = evaluate(unary.right.get(), env);
-  switch(unary.op.type) {
-    case Token::Type::Exclamation: return !std::any_cast<bool>(rightVal);
-    case Token::Type::Dash: return -std::any_cast<long double>(rightVal);
-    default: throw std::runtime_error("Not a supported unary operator");
-  }
+bool Interpreter::visit(const Expression::Unary &unary,
+                        Environment *env,
+                        Value &result) {
+  evaluate(unary.right.get(), env, result);
+  if(!specialized(unary.specialization, unary.op.type, result))
+    result = operators::unary(unary.op.type, result);
+  return true;
 }
 
-std::optional<std::any> Interpreter::visit(const Expression::Binary &binary,
-                                           Environment *env) {
-  std::any leftVal = evaluate(binary.left.get(), env);
-  std::any rightVal = evaluate(binary.right.get(), env);
-  try {
-    if(leftVal.type() == typeid(std::string))
-      return stringOperation(std::any_cast<std::string>(leftVal),
-                             binary.op.type,
-                             std::any_cast<std::string>(rightVal));
-    else if(leftVal.type() == typeid(bool))
-      return booleanOperation(std::any_cast<bool>(leftVal),
-                              binary.op.type,
-                              std::any_cast<bool>(rightVal));
-    else
-      return numericOperation(std::any_cast<long double>(leftVal),
-                              binary.op.type,
-                              std::any_cast<long double>(rightVal));
-  } catch(std::bad_any_cast) {
-    throw std::runtime_error("Type mismatch between operator!");
-  }
+bool Interpreter::visit(const Expression::Binary &binary,
+                        Environment *env,
+                        Value &result) {
+  // The left operand is evaluated straight into the result it is replaced by.
+  evaluate(binary.left.get(), env, result);
+  Value rightVal{};
+  evaluate(binary.right.get(), env, rightVal);
+  if(!specialized(binary.specialization, binary.op.type, result, rightVal))
+    result = operators::binary(result, binary.op.type, rightVal);
+  return true;
 }
 
-std::optional<std::any> Interpreter::visit(const Expression::Group &group,
-                                           Environment *env) {
-  return evaluate(group.expr.get(), env);
+bool Interpreter::visit(const Expression::Logical &logical,
+                        Environment *env,
+                        Value &result) {
+  evaluate(logical.left.get(), env, result);
+  // And is decided by a false left operand, or by a true one.
+  if(operators::logical(result) == (logical.op.type == Token::Type::Or))
+    return true;
+  evaluate(logical.right.get(), env, result);
+  operators::logical(result);
+  return true;
 }
 
-std::optional<std::any> Interpreter::visit(const Expression::Ternary &ternary,
-                                           Environment *env) {
-  if(isTrue(evaluate(ternary.condition.get(), env)))
-    return evaluate(ternary.thenExpr.get(), env);
-  return evaluate(ternary.elseExpr.get(), env);
+bool Interpreter::visit(const Expression::Group &group,
+                        Environment *env,
+                        Value &result) {
+  return group.expr->accept(this, env, result);
 }
 
-std::optional<std::any> Interpreter::visit(const Expression::Variable &variable,
-                                           Environment *env) {
-  return env->get(variable.variable);
+bool Interpreter::visit(const Expression::Ternary &ternary,
+                        Environment *env,
+                        Value &result) {
+  evaluate(ternary.condition.get(), env, result);
+  if(operators::isTrue(result)) return ternary.thenExpr->accept(this, env, result);
+  return ternary.elseExpr->accept(this, env, result);
 }
 
-std::optional<std::any>
-    Interpreter::visit(const Expression::Assignment &assignment,
-                       Environment *env) {
-  std::any value = evaluate(assignment.value.get(), env);
-  env->assign(assignment.variable, value);
-  return value;
+bool Interpreter::visit(const Expression::Variable &variable,
+                        Environment *env,
+                        Value &result) {
+  result = lookUp(variable.variable, variable.binding, env);
+  return true;
 }
 
-std::optional<std::any> Interpreter::visit(const Expression::Call &call,
-                                           Environment *env) {
-  std::any callee{evaluate(call.callee.get(), env)};
-  std::vector<std::any> args{};
+bool Interpreter::visit(const Expression::Assignment &assignment,
+                        Environment *env,
+                        Value &result) {
+  evaluate(assignment.value.get(), env, result);
+  const Binding &binding{assignment.binding};
+  switch(binding.kind) {
+    case Binding::Kind::Local:
+      env->assignAt(binding.depth, binding.slot, result);
+      break;
+    case Binding::Kind::Boxed:
+      env->cellAt(binding.depth, binding.slot).contents() = result;
+      break;
+    case Binding::Kind::Captured:
+      (*captures)[binding.slot].contents() = result;
+      break;
+    case Binding::Kind::Global:
+      global->assignSlot(binding.slot, result);
+      break;
+    default: env->assign(assignment.variable, result); break;
+  }
+  return true;
+}
+
+bool Interpreter::visit(const Expression::Call &call,
+                        Environment *env,
+                        Value &result) {
+  Value callee{evaluate(call.callee.get(), env)};
+  std::vector<Value> args(call.args.size());
   for(std::size_t i{0}; i < call.args.size(); i++)
-    args.push_back(evaluate(call.args[i].get(), env));
-  try {
-    Callable callable{std::any_cast<Callable>(callee)};
-    if(args.size() < callable.minArity || args.size() > callable.maxArity)
-      throw std::runtime_error{
-          "Method expected at least " + std::to_string(callable.minArity) +
-          " arguments, at most " + std::to_string(callable.maxArity) +
-          " arguments, and received " + std::to_string(args.size()) +
-          " arguments."};
-    return callable.procedure(args, callable.fnEnv.get());
-  } catch(std::bad_any_cast) {
-    try {
-      Prototypable prototype{std::any_cast<Prototypable>(callee)};
-      Prototypable newPrototype{prototype.copy()};
-      if(args.size() < newPrototype.constructor.minArity ||
-         args.size() > newPrototype.constructor.maxArity)
-        throw std::runtime_error{
-            "Constructor expected at least " +
-            std::to_string(newPrototype.constructor.minArity) +
-            " arguments, at most " +
-            std::to_string(newPrototype.constructor.maxArity) +
-            " arguments, and received " + std::to_string(args.size()) +
-            " arguments."};
-      newPrototype.constructor.procedure(args, newPrototype.methodEnv.get());
-      return newPrototype;
-    } catch(std::bad_any_cast) {
-      throw std::runtime_error{"Only functions and prototypes may be called."};
-    }
+    evaluate(call.args[i].get(), env, args[i]);
+  if(call.tail) {
+    // The subroutine returning the call makes it once it has returned, and
+    // returns what the call does instead of this placeholder.
+    tailCall.emplace(TailCall{std::move(callee), std::move(args)});
+    result = Value{};
+    return true;
   }
+  std::optional<Value> returned{operators::call(callee, args)};
+  if(!returned) return false;
+  result = std::move(returned.value());
+  return true;
 }
 
-std::optional<std::any> Interpreter::visit(const Expression::Lambda &lambda,
-                                           Environment *env) {
-  Procedure lambdaFn = [&lambda, this](const std::vector<std::any> &args,
-                                       Environment *fnEnv) {
-    std::unique_ptr<Environment> scopedEnv{
-        std::make_unique<Environment>(fnEnv)};
-    for(std::size_t i{0};
-        i < lambda.params.size() + lambda.defaultParams.size();
-        i++) {
-      if(i < lambda.params.size())
-        scopedEnv->define(lambda.params[i], args[i]);
-      else if(i < args.size())
-        scopedEnv->define(lambda.defaultParams[i - lambda.params.size()].first,
-                          args[i]);
-      else
-        scopedEnv->define(
-            lambda.defaultParams[i - lambda.params.size()].first,
-            evaluate(
-                lambda.defaultParams[i - lambda.params.size()].second.get(),
-                scopedEnv.get()));
-    }
-    try {
-      execute(lambda.body.get(), scopedEnv.get());
-    } catch(std::optional<std::any> &value) {
-      return value;
-    }
-    return std::make_optional<std::any>({});
-  };
-  return Callable{lambda.params.size(),
-                  lambda.params.size() + lambda.defaultParams.size(),
-                  lambdaFn,
-                  std::make_shared<Environment>(env, true)};
+bool Interpreter::visit(const Expression::Lambda &lambda,
+                        Environment *env,
+                        Value &result) {
+  makeClosure(lambda, env, result);
+  return true;
 }
 
-std::optional<std::any>
-    Interpreter::visit(const Expression::Prototype &prototype,
-                       Environment *env) {
+bool Interpreter::visit(const Expression::Prototype &prototype,
+                        Environment *env,
+                        Value &result) {
+  // Every environment of the prototype sits directly within the surrounding
+  // environment, matching the single scope the resolver gives prototypes.
   std::shared_ptr<Environment> surroundingEnv{
-      std::make_shared<Environment>(env, true)};
-  std::shared_ptr<Environment> publicEnv{std::make_shared<Environment>()};
-  std::shared_ptr<Environment> privateEnv{std::make_shared<Environment>()};
+      makeEnvironment(env->shared_from_this())};
+  std::shared_ptr<Environment> publicEnv{
+      makeEnvironment(env->shared_from_this())};
+  std::shared_ptr<Environment> privateEnv{
+      makeEnvironment(env->shared_from_this())};
   if(prototype.parent) {
-    try {
-      std::any parent{env->get(prototype.parent.value())};
-      Prototypable parentPrototype{std::any_cast<Prototypable>(parent)};
-      privateEnv->copyOver(parentPrototype.privateEnv.get());
-      publicEnv->copyOver(parentPrototype.publicEnv.get());
-      surroundingEnv->define(Token{"parent", Token::Type::Identifier, true},
-                             parentPrototype);
-    } catch(...) {
+    const Value parent{
+        lookUp(prototype.parent.value(), prototype.parentBinding, env)};
+    if(parent.type() != Value::Type::Prototype)
       throw std::runtime_error{"Can only inherit from other prototypes."};
-    }
+    const Prototypable &parentPrototype{parent.asPrototype()};
+    privateEnv->copyOver(parentPrototype.privateEnv.get());
+    publicEnv->copyOver(parentPrototype.publicEnv.get());
+    surroundingEnv->define(Token{"parent", Token::Type::Identifier, true},
+                           parent);
   }
   privateEnv->defineOrAssign(true);
   publicEnv->defineOrAssign(true);
@@ -245,106 +253,135 @@ std::optional<std::any>
   anonymousPrototype.methodEnv = Environment::unionize(
       {surroundingEnv.get(), publicEnv.get(), privateEnv.get()});
   if(prototype.constructor)
-    anonymousPrototype.constructor = std::any_cast<Callable>(evaluate(
-        prototype.constructor.get(), anonymousPrototype.methodEnv.get()));
+    anonymousPrototype.constructor =
+        evaluate(prototype.constructor.get(),
+                 anonymousPrototype.methodEnv.get())
+            .asCallable();
+  result = anonymousPrototype;
   anonymousPrototype.methodEnv->define(
-      Token{"this", Token::Type::Identifier, true}, anonymousPrototype);
-  return anonymousPrototype;
+      Token{"this", Token::Type::Identifier, true}, result);
+  return true;
 }
 
-std::optional<std::any> Interpreter::visit(const Expression::Set &set,
-                                           Environment *env) {
-  std::any object{evaluate(set.object.get(), env)};
-  try {
-    Prototypable prototype{std::any_cast<Prototypable>(object)};
-    try {
-      prototype.publicEnv->assign(set.property, evaluate(set.value.get(), env));
-    } catch(std::runtime_error) {
-      try {
-        prototype.privateEnv->get(set.property);
-        throw std::runtime_error{"Requested property is private."};
-      } catch(std::runtime_error) {
-        throw std::runtime_error{"Property not found in prototype."};
-      }
-    }
-  } catch(std::bad_any_cast) {
+bool Interpreter::visit(const Expression::Set &set,
+                        Environment *env,
+                        Value &result) {
+  const Value object{evaluate(set.object.get(), env)};
+  if(object.type() != Value::Type::Prototype)
     throw std::runtime_error{"Can only set properties of prototypes."};
-  }
-  return {};
+  operators::set(object, set.property, evaluate(set.value.get(), env));
+  return false;
 }
 
-std::optional<std::any> Interpreter::visit(const Expression::Get &get,
-                                           Environment *env) {
-  std::any object{evaluate(get.object.get(), env)};
-  std::any value;
-  try {
-    Prototypable prototype{std::any_cast<Prototypable>(object)};
-    try {
-      value = prototype.publicEnv->get(get.property);
-      try {
-        Callable callable{std::any_cast<Callable>(value)};
-        callable.fnEnv = prototype.methodEnv;
-        return callable;
-      } catch(std::bad_any_cast) {
-        return value;
-      }
-    } catch(std::runtime_error) {
-      try {
-        throw prototype.privateEnv->get(get.property);
-      } catch(std::runtime_error) {
-        throw std::runtime_error{"Property not found in prototype."};
-      } catch(std::any) {
-        throw std::runtime_error{"Requested property is private."};
-      }
-    }
-  } catch(std::bad_any_cast) {
-    throw std::runtime_error{"Can only receive properties from prototypes."};
-  }
+bool Interpreter::visit(const Expression::Get &get,
+                        Environment *env,
+                        Value &result) {
+  const Value object{evaluate(get.object.get(), env)};
+  result = operators::get(object, get.property);
+  return true;
 }
 
-void Interpreter::visit(const Statement::Expression &expr, Environment *env) {
-  optEvaluate(expr.expr.get(), env);
+Statement::Completion Interpreter::visit(const Statement::Expression &expr,
+                                         Environment *env) {
+  Value unused{};
+  expr.expr->accept(this, env, unused);
+  return Statement::Completion::Normal;
 }
 
-void Interpreter::visit(const Statement::Variable &variable, Environment *env) {
-  std::any value;
-  if(variable.initializer) value = evaluate(variable.initializer.get(), env);
-  // Necessary so functions can call themselves recursively.
-  if(value.type() == typeid(Callable))
-    std::any_cast<Callable>(value).fnEnv->define(variable.variable, value);
-  env->define(variable.variable, value);
+Statement::Completion Interpreter::visit(const Statement::Variable &variable,
+                                         Environment *env) {
+  if(variable.binding.kind == Binding::Kind::Boxed) {
+    // The cell exists before the initializer runs so subroutines can capture
+    // themselves.
+    const Cell cell{Value::cell()};
+    env->defineAt(variable.binding.slot, cell);
+    if(variable.initializer)
+      cell.contents() = evaluate(variable.initializer.get(), env);
+    return Statement::Completion::Normal;
+  }
+  Value value{};
+  if(variable.initializer) evaluate(variable.initializer.get(), env, value);
+  switch(variable.binding.kind) {
+    case Binding::Kind::Local:
+      env->defineAt(variable.binding.slot, value);
+      break;
+    case Binding::Kind::Global:
+      global->defineSlot(variable.binding.slot, value);
+      break;
+    default: env->define(variable.variable, value); break;
+  }
+  return Statement::Completion::Normal;
 }
 
-void Interpreter::visit(const Statement::Scope &scope, Environment *env) {
-  std::unique_ptr<Environment> scopedEnv{std::make_unique<Environment>(env)};
-  for(std::size_t i{0}; i < scope.statements.size(); i++)
-    execute(scope.statements[i].get(), scopedEnv.get());
+Statement::Completion Interpreter::visit(const Statement::Scope &scope,
+                                         Environment *env) {
+  return withFrame(scope.layout, env, [&](Environment *scopedEnv) {
+    return execute(scope.statements, scopedEnv);
+  });
 }
 
-void Interpreter::visit(const Statement::If &ifStmt, Environment *env) {
-  if(isTrue(evaluate(ifStmt.condition.get(), env)))
-    execute(ifStmt.thenStmt.get(), env);
-  else if(ifStmt.elseStmt)
-    execute(ifStmt.elseStmt.get(), env);
+Statement::Completion Interpreter::visit(const Statement::If &ifStmt,
+                                         Environment *env) {
+  if(operators::isTrue(evaluate(ifStmt.condition.get(), env)))
+    return execute(ifStmt.thenStmt.get(), env);
+  if(ifStmt.elseStmt) return execute(ifStmt.elseStmt.get(), env);
+  return Statement::Completion::Normal;
 }
 
-void Interpreter::visit(const Statement::For &forStmt, Environment *env) {
-  std::unique_ptr<Environment> forEnv{std::make_unique<Environment>(env)};
-  if(forStmt.initializer) execute(forStmt.initializer.get(), forEnv.get());
-  while(isTrue(evaluate(forStmt.condition.get(), forEnv.get()))) {
-    if(forStmt.body) execute(forStmt.body.get(), forEnv.get());
-    if(forStmt.update) execute(forStmt.update.get(), forEnv.get());
-  }
+Statement::Completion Interpreter::visit(const Statement::For &forStmt,
+                                         Environment *env) {
+  using Completion = Statement::Completion;
+  return withFrame(forStmt.layout, env, [&](Environment *forEnv) {
+    if(forStmt.initializer &&
+       execute(forStmt.initializer.get(), forEnv) == Completion::Return)
+      return Completion::Return;
+    // A body no closure can capture keeps one frame for every iteration. Each
+    // declaration fills its slot again before it can be read.
+    const auto *body{dynamic_cast<const Statement::Scope *>(forStmt.body.get())};
+    if(body && !body->layout.captured) {
+      return withFrame(body->layout, forEnv, [&](Environment *bodyEnv) {
+        while(operators::isTrue(evaluate(forStmt.condition.get(), forEnv))) {
+          if(execute(body->statements, bodyEnv) == Completion::Return ||
+             (forStmt.update &&
+              execute(forStmt.update.get(), forEnv) == Completion::Return))
+            return Completion::Return;
+        }
+        return Completion::Normal;
+      });
+    }
+    while(operators::isTrue(evaluate(forStmt.condition.get(), forEnv))) {
+      if((forStmt.body &&
+          execute(forStmt.body.get(), forEnv) == Completion::Return) ||
+         (forStmt.update &&
+          execute(forStmt.update.get(), forEnv) == Completion::Return))
+        return Completion::Return;
+    }
+    return Completion::Normal;
+  });
 }
 
-void Interpreter::visit(const Statement::Return &returnStmt, Environment *env) {
-  if(returnStmt.expr) throw optEvaluate(returnStmt.expr.get(), env);
-  throw std::make_optional<std::any>({});
+Statement::Completion Interpreter::visit(const Statement::Return &returnStmt,
+                                         Environment *env) {
+  // Calls within the expression return through the same member, so it is
+  // only set once the expression is done. The call being returned from takes
+  // it once the completion reaches it.
+  std::optional<Value> value{std::in_place};
+  if(returnStmt.expr && !returnStmt.expr->accept(this, env, value.value()))
+    value.reset();
+  returned = std::move(value);
+  return Statement::Completion::Return;
 }
 
 void Interpreter::interpret(
     const std::vector<Statement::StatementUPtr> &statements) {
   try {
+    if(mode == Mode::Closures) {
+      std::optional<Value> returned{};
+      for(const ClosureCompiler::Execute &statement :
+          ClosureCompiler{this}.compile(statements))
+        statement(global.get(), returned);
+      return;
+    }
     for(std::size_t i{0}; i < statements.size(); i++)
       execute(statements[i].get(), global.get());
   } catch(std::runtime_error &e) {
@@ -352,83 +389,171 @@ void Interpreter::interpret(
   }
 }
 
-std::any Interpreter::evaluate(Expression::Expression *expr, Environment *env) {
-  std::optional<std::any> optValue{expr->accept(this, env)};
-  if(!optValue.has_value())
-    throw std::runtime_error{"Expected a non-null value!"};
-  return optValue.value();
-}
-
-std::optional<std::any> Interpreter::optEvaluate(Expression::Expression *expr,
-                                                 Environment *env) {
-  return expr->accept(this, env);
-}
-
-void Interpreter::execute(Statement::Statement *statement, Environment *env) {
-  statement->accept(this, env);
-}
-
-bool Interpreter::isTrue(const std::any &value) {
-  bool truth{false};
-  if(value.type() == typeid(bool) && std::any_cast<bool>(value))
-    truth = true;
-  else if(value.type() == typeid(long double) &&
-          std::any_cast<long double>(value) != 0.0)
-    truth = true;
-  else if(value.type() == typeid(std::string) &&
-          std::any_cast<std::string>(value) != "")
-    truth = true;
-  return truth;
-}
-
-std::any Interpreter::stringOperation(const std::string &left,
-                                      const Token::Type op,
-                                      const std::string &right) {
-  switch(op) {
-    case Token::Type::Plus: return left + right;
-    case Token::Type::EqualTo: return left == right;
-    case Token::Type::NotEqualTo: return left != right;
-    case Token::Type::LessThan: return left < right;
-    case Token::Type::GreaterThan: return left > right;
-    case Token::Type::LessThanOrEqualTo: return left <= right;
-    case Token::Type::GreaterThanOrEqualTo: return left >= right;
-    default: throw std::runtime_error("Not a supported string operator.");
-  }
+GlobalEnvironment *Interpreter::globals() const {
+  return global.get();
+}
+
+const EnvironmentPool &Interpreter::environmentPool() const {
+  return pool;
+}
+
+void Interpreter::setMaxDepth(const std::size_t maxDepth) {
+  callStack.setMaxDepth(maxDepth);
+}
+
+std::optional<Value>
+    Interpreter::Subroutine::operator()(const std::vector<Value> &args,
+                                        Environment *fnEnv) const {
+  return interpreter->call(*this, args, fnEnv);
+}
+
+std::optional<Value> Interpreter::call(const Subroutine &subroutine,
+                                       const std::vector<Value> &args,
+                                       Environment *fnEnv) {
+  return callStack.enter([&] {
+    std::optional<Value> returned{run(subroutine, args, fnEnv)};
+    // Tail calls to lambdas run in place of the subroutine that made them,
+    // so chains of them take no more stack than a single call.
+    while(tailCall) {
+      const TailCall next{std::move(tailCall.value())};
+      tailCall.reset();
+      const Subroutine *target{
+          next.callee.type() == Value::Type::Callable
+              ? next.callee.asCallable().procedure.target<Subroutine>()
+              : nullptr};
+      if(!target || target->interpreter != this)
+        return operators::call(next.callee, next.args);
+      operators::checkArity(next.callee.asCallable(), next.args.size());
+      returned = run(*target, next.args, next.callee.asCallable().fnEnv.get());
+    }
+    return returned;
+  });
 }
 
-std::any Interpreter::booleanOperation(const bool left,
-                                       const Token::Type op,
-                                       const bool right) {
-  switch(op) {
-    case Token::Type::And: return left && right;
-    case Token::Type::Or: return left || right;
-    case Token::Type::EqualTo: return left == right;
-    case Token::Type::NotEqualTo: return left != right;
-    default: throw std::runtime_error("Not a supported boolean operator.");
+std::optional<Value> Interpreter::run(const Subroutine &subroutine,
+                                      const std::vector<Value> &args,
+                                      Environment *fnEnv) {
+  const Expression::Lambda &lambda{*subroutine.lambda};
+  CapturesGuard guard{captures, std::exchange(captures, subroutine.context)};
+  return withFrame(lambda.layout, fnEnv, [&](Environment *scopedEnv) {
+    // The resolver gives parameters the first slots in order.
+    const std::size_t required{lambda.params.size()};
+    for(std::size_t i{0}; i < required + lambda.defaultParams.size(); i++) {
+      Value value{};
+      if(i < args.size())
+        value = args[i];
+      else if(subroutine.compiled) {
+        if(!subroutine.compiled->defaultParams[i - required](scopedEnv, value))
+          throw std::runtime_error{"Expected a non-null value!"};
+      } else
+        evaluate(lambda.defaultParams[i - required].second.get(),
+                 scopedEnv,
+                 value);
+      defineParam(lambda, scopedEnv, i, value);
+    }
+    if(subroutine.compiled) {
+      std::optional<Value> returned{};
+      if(subroutine.compiled->body(scopedEnv, returned)) return returned;
+    } else if(execute(lambda.body.get(), scopedEnv) ==
+              Statement::Completion::Return)
+      return std::exchange(returned, std::nullopt);
+    return std::make_optional<Value>();
+  });
+}
+
+std::shared_ptr<Environment>
+    Interpreter::makeEnvironment(std::shared_ptr<Environment> outer,
+                                 const std::size_t slotCount) {
+  // The environment, its control block and any slots that do not fit inline
+  // all come from the pool.
+  return std::allocate_shared<Environment>(
+      PoolAllocator<Environment>{&pool}, std::move(outer), slotCount, &pool);
+}
+
+void Interpreter::makeClosure(const Expression::Lambda &lambda,
+                              Environment *env,
+                              Value &result,
+                              std::shared_ptr<const CompiledLambda> compiled) {
+  const bool closesOverScope{!lambda.captures};
+  if(!closesOverScope && lambda.captures->empty()) {
+    // Nothing is captured, so every evaluation can share one closure.
+    auto closure{closures.find(&lambda)};
+    if(closure != closures.end()) {
+      result = closure->second;
+      return;
+    }
+  }
+  // Lambdas within prototypes run with the captures of the subroutine that
+  // created them.
+  std::shared_ptr<const Captures> context{captures};
+  if(!closesOverScope) {
+    Captures cells{};
+    cells.reserve(lambda.captures->size());
+    for(const Binding &capture : lambda.captures.value())
+      cells.push_back(capture.kind == Binding::Kind::Boxed
+                          ? env->cellAt(capture.depth, capture.slot)
+                          : (*captures)[capture.slot]);
+    context = std::make_shared<const Captures>(std::move(cells));
   }
+  result = Callable{lambda.params.size(),
+                    lambda.params.size() + lambda.defaultParams.size(),
+                    Subroutine{this,
+                               &lambda,
+                               std::move(context),
+                               std::move(compiled)},
+                    closesOverScope
+                        ? env->shared_from_this()
+                        : std::static_pointer_cast<Environment>(global)};
+  if(!closesOverScope && lambda.captures->empty())
+    closures.emplace(&lambda, result);
+}
+
+void Interpreter::defineParam(const Expression::Lambda &lambda,
+                              Environment *scopedEnv,
+                              const std::size_t index,
+                              const Value &value) {
+  if(lambda.paramBindings[index].kind == Binding::Kind::Boxed)
+    scopedEnv->defineAt(index, Value::cell(value));
+  else
+    scopedEnv->defineAt(index, value);
 }
 
-std::any Interpreter::numericOperation(const long double left,
-                                       const Token::Type op,
-                                       const long double right) {
-  switch(op) {
-    case Token::Type::NotEqualTo: return left != right;
-    case Token::Type::EqualTo: return left == right;
-    case Token::Type::LessThan: return left < right;
-    case Token::Type::LessThanOrEqualTo: return left <= right;
-    case Token::Type::GreaterThan: return left > right;
-    case Token::Type::GreaterThanOrEqualTo: return left >= right;
-    case Token::Type::Asterisk: return left * right;
-    case Token::Type::Plus: return left + right;
-    case Token::Type::Dash: return left - right;
-    case Token::Type::ForwardSlash:
-      if(right == 0) throw std::runtime_error{"Attempted to divide by zero!"};
-      return left / right;
-    case Token::Type::Modulus:
-      if(right == 0)
-        throw std::runtime_error{
-            "Attempted to take remainder of division by zero!"};
-      return static_cast<long double>(fmod(left, right));
-    default: throw std::runtime_error("Not a supported binary operator.");
+Value Interpreter::lookUp(const Token &variable,
+                          const Binding &binding,
+                          Environment *env) {
+  switch(binding.kind) {
+    case Binding::Kind::Local: return env->getAt(binding.depth, binding.slot);
+    case Binding::Kind::Boxed:
+      return env->cellAt(binding.depth, binding.slot).contents();
+    case Binding::Kind::Captured: return (*captures)[binding.slot].contents();
+    case Binding::Kind::Global: return global->getSlot(binding.slot);
+    default: return env->get(variable);
   }
-}
\ No newline at end of file
+}
+
+Value Interpreter::evaluate(Expression::Expression *expr, Environment *env) {
+  Value value{};
+  evaluate(expr, env, value);
+  return value;
+}
+
+void Interpreter::evaluate(Expression::Expression *expr,
+                           Environment *env,
+                           Value &result) {
+  if(!expr->accept(this, env, result))
+    throw std::runtime_error{"Expected a non-null value!"};
+}
+
+Statement::Completion Interpreter::execute(Statement::Statement *statement,
+                                           Environment *env) {
+  return statement->accept(this, env);
+}
+
+Statement::Completion Interpreter::execute(
+    const std::vector<Statement::StatementUPtr> &statements,
+    Environment *env) {
+  for(const Statement::StatementUPtr &statement : statements)
+    if(statement->accept(this, env) == Statement::Completion::Return)
+      return Statement::Completion::Return;
+  return Statement::Completion::Normal;
+}
@@ -0,0 +1,194 @@
+#include "loopHoister.hpp"
+#include "native.hpp"
+#include <iomanip>
+#include <sstream>
+
+namespace {
+// Determines whether an expression computes anything, rather than only giving
+// a value that is already at hand.
+bool computes(const Expression::Expression *expr) {
+  if(const auto *group{dynamic_cast<const Expression::Group *>(expr)})
+    return computes(group->expr.get());
+  return !dynamic_cast<const Expression::Literal *>(expr) &&
+         !dynamic_cast<const Expression::Variable *>(expr);
+}
+
+// Writes an expression back out as source, for reports of what was hoisted.
+std::string print(const Expression::Expression *expr) {
+  std::ostringstream text{};
+  text << std::setprecision(20);
+  if(const auto *literal{dynamic_cast<const Expression::Literal *>(expr)}) {
+    const Value &value{literal->value};
+    switch(value.type()) {
+      case Value::Type::Boolean:
+        text << (value.asBoolean() ? "true" : "false");
+        break;
+      case Value::Type::Integer: text << value.asInteger(); break;
+      case Value::Type::Number: text << value.asNumber(); break;
+      case Value::Type::String:
+        text << '"' << value.asString().text() << '"';
+        break;
+      default: text << "nil"; break;
+    }
+  } else if(const auto *variable{
+                dynamic_cast<const Expression::Variable *>(expr)}) {
+    text << variable->variable.lexeme;
+  } else if(const auto *unary{dynamic_cast<const Expression::Unary *>(expr)}) {
+    text << unary->op.lexeme << print(unary->right.get());
+  } else if(const auto *binary{
+                dynamic_cast<const Expression::Binary *>(expr)}) {
+    text << print(binary->left.get()) << ' ' << binary->op.lexeme << ' '
+         << print(binary->right.get());
+  } else if(const auto *logical{
+                dynamic_cast<const Expression::Logical *>(expr)}) {
+    text << print(logical->left.get()) << ' ' << logical->op.lexeme << ' '
+         << print(logical->right.get());
+  } else if(const auto *group{dynamic_cast<const Expression::Group *>(expr)}) {
+    text << '(' << print(group->expr.get()) << ')';
+  } else if(const auto *ternary{
+                dynamic_cast<const Expression::Ternary *>(expr)}) {
+    text << print(ternary->thenExpr.get()) << " if "
+         << print(ternary->condition.get()) << " else "
+         << print(ternary->elseExpr.get());
+  } else if(const auto *call{dynamic_cast<const Expression::Call *>(expr)}) {
+    text << print(call->callee.get()) << '(';
+    for(std::size_t i{0}; i < call->args.size(); i++)
+      text << (i ? ", " : "") << print(call->args[i].get());
+    text << ')';
+  } else if(const auto *get{dynamic_cast<const Expression::Get *>(expr)}) {
+    text << print(get->object.get()) << '.' << get->property.lexeme;
+  } else {
+    text << "...";
+  }
+  return text.str();
+}
+} // namespace
+
+void LoopHoister::rewrite(std::vector<Statement::StatementUPtr> &statements) {
+  program.rewrite(statements);
+  rewriteEach(statements);
+}
+
+const std::vector<LoopHoister::Hoist> &LoopHoister::hoists() const {
+  return hoisted;
+}
+
+bool LoopHoister::visit(const Expression::Prototype &prototype,
+                        Environment *env,
+                        Value &result) {
+  prototypeDepth++;
+  TreeRewriter::visit(prototype, env, result);
+  prototypeDepth--;
+  return false;
+}
+
+Statement::Completion LoopHoister::visit(const Statement::For &forStmt,
+                                         Environment *env) {
+  TreeRewriter::visit(forStmt, env);
+  if(prototypeDepth) return Statement::Completion::Normal;
+  Effects loop{};
+  loop.analyze(forStmt.initializer);
+  loop.analyze(forStmt.condition);
+  loop.analyze(forStmt.body);
+  loop.analyze(forStmt.update);
+  std::vector<Statement::StatementUPtr> statements{};
+  bool clean{true};
+  hoist(forStmt.condition, loop, clean, statements);
+  if(statements.empty()) return Statement::Completion::Normal;
+  // The initializer runs before the condition is first checked, so it stays
+  // ahead of what was hoisted from the condition.
+  if(forStmt.initializer)
+    statements.insert(statements.begin(), std::move(forStmt.initializer));
+  statements.push_back(
+      std::make_unique<Statement::For>(nullptr,
+                                       std::move(forStmt.condition),
+                                       std::move(forStmt.body),
+                                       std::move(forStmt.update)));
+  replace(std::make_unique<Statement::Scope>(std::move(statements)));
+  return Statement::Completion::Normal;
+}
+
+bool LoopHoister::invariant(const Expression::Expression *expr,
+                            const Effects &loop) const {
+  if(!expr) return true;
+  // Calls may run closures that assign what the loop itself never does.
+  const bool calls{loop.callsImpure(program)};
+  if(dynamic_cast<const Expression::Literal *>(expr)) return true;
+  if(const auto *variable{dynamic_cast<const Expression::Variable *>(expr)})
+    return !loop.writes(variable->variable) &&
+           !(calls && program.writesFromCalls(variable->variable));
+  if(const auto *unary{dynamic_cast<const Expression::Unary *>(expr)})
+    return invariant(unary->right.get(), loop);
+  if(const auto *binary{dynamic_cast<const Expression::Binary *>(expr)})
+    return invariant(binary->left.get(), loop) &&
+           invariant(binary->right.get(), loop);
+  if(const auto *logical{dynamic_cast<const Expression::Logical *>(expr)})
+    return invariant(logical->left.get(), loop) &&
+           invariant(logical->right.get(), loop);
+  if(const auto *group{dynamic_cast<const Expression::Group *>(expr)})
+    return invariant(group->expr.get(), loop);
+  if(const auto *ternary{dynamic_cast<const Expression::Ternary *>(expr)})
+    return invariant(ternary->condition.get(), loop) &&
+           invariant(ternary->thenExpr.get(), loop) &&
+           invariant(ternary->elseExpr.get(), loop);
+  if(const auto *call{dynamic_cast<const Expression::Call *>(expr)}) {
+    const auto *name{
+        dynamic_cast<const Expression::Variable *>(call->callee.get())};
+    if(!name || !native::isPure(name->variable.lexeme) ||
+       program.declares(name->variable))
+      return false;
+    for(const Expression::ExpressionUPtr &arg : call->args)
+      if(!invariant(arg.get(), loop)) return false;
+    return true;
+  }
+  // Properties only keep their value while nothing in the loop may set them.
+  if(const auto *get{dynamic_cast<const Expression::Get *>(expr)})
+    return !loop.setsProperties() && !calls &&
+           invariant(get->object.get(), loop);
+  return false;
+}
+
+void LoopHoister::hoist(Expression::ExpressionUPtr &expr,
+                        const Effects &loop,
+                        bool &clean,
+                        std::vector<Statement::StatementUPtr> &constants) {
+  if(!expr || !computes(expr.get())) return;
+  if(clean && invariant(expr.get(), loop)) {
+    const Token temporary{"$hoisted" + std::to_string(hoisted.size()),
+                          Token::Type::Identifier};
+    hoisted.push_back(Hoist{print(expr.get()), temporary.lexeme});
+    constants.push_back(
+        std::make_unique<Statement::Variable>(temporary, std::move(expr)));
+    expr = std::make_unique<Expression::Variable>(temporary);
+    return;
+  }
+  // Operands are hoisted in the order they are evaluated, as far as they are
+  // evaluated on every check of the condition.
+  if(const auto *unary{dynamic_cast<const Expression::Unary *>(expr.get())}) {
+    hoist(unary->right, loop, clean, constants);
+  } else if(const auto *binary{
+                dynamic_cast<const Expression::Binary *>(expr.get())}) {
+    hoist(binary->left, loop, clean, constants);
+    hoist(binary->right, loop, clean, constants);
+  } else if(const auto *logical{
+                dynamic_cast<const Expression::Logical *>(expr.get())}) {
+    hoist(logical->left, loop, clean, constants);
+  } else if(const auto *group{
+                dynamic_cast<const Expression::Group *>(expr.get())}) {
+    hoist(group->expr, loop, clean, constants);
+  } else if(const auto *ternary{
+                dynamic_cast<const Expression::Ternary *>(expr.get())}) {
+    hoist(ternary->condition, loop, clean, constants);
+  } else if(const auto *call{
+                dynamic_cast<const Expression::Call *>(expr.get())}) {
+    hoist(call->callee, loop, clean, constants);
+    for(Expression::ExpressionUPtr &arg : call->args)
+      hoist(arg, loop, clean, constants);
+  } else if(const auto *get{
+                dynamic_cast<const Expression::Get *>(expr.get())}) {
+    hoist(get->object, loop, clean, constants);
+  }
+  // Anything evaluated after this node may only be hoisted ahead of it if the
+  // node could neither fail nor change anything.
+  clean = false;
+}
@@ -8,13 +8,38 @@
 
 int main(int argc, char *argv[]) {
   std::cout << std::setprecision(20);
-  if(argc != 2) {
-    std::cerr << "Usage: " << argv[0] << " <file>\n";
+  // Programs are walked as trees unless another engine is asked for.
+  const std::string engineFlag{"--engine="};
+  const std::string maxDepthFlag{"--max-depth="};
+  std::string engine{"tree"};
+  // Each engine keeps its own maximum depth unless one is given.
+  std::optional<std::size_t> maxDepth{};
+  bool dumpOptimizations{false};
+  int fileArg{1};
+  for(; fileArg < argc - 1; fileArg++) {
+    const std::string flag{argv[fileArg]};
+    if(flag.rfind(engineFlag, 0) == 0)
+      engine = flag.substr(engineFlag.size());
+    else if(flag == "--dump-opt")
+      dumpOptimizations = true;
+    else if(flag.rfind(maxDepthFlag, 0) == 0 &&
+            flag.size() > maxDepthFlag.size() &&
+            flag.find_first_not_of("0123456789", maxDepthFlag.size()) ==
+                std::string::npos)
+      maxDepth = std::stoull(flag.substr(maxDepthFlag.size()));
+    else
+      break;
+  }
+  if(argc != fileArg + 1 ||
+     (engine != "tree" && engine != "closures" && engine != "vm")) {
+    std::cerr << "Usage: " << argv[0]
+              << " [--engine=tree|closures|vm] [--dump-opt] [--max-depth=N] "
+                 "<file>\n";
     return 1;
   }
-  std::ifstream file{argv[1]}; // Open the file specified in the CLI.
+  std::ifstream file{argv[fileArg]}; // Open the file specified in the CLI.
   if(!file.is_open()) {
-    std::cerr << "Error opening file: " << argv[1] << "\n";
+    std::cerr << "Error opening file: " << argv[fileArg] << "\n";
     return 1;
   }
   std::string expression{std::istreambuf_iterator<char>(file),
@@ -23,9 +48,46 @@ int main(int argc, char *argv[]) {
       std::make_unique<ErrorReporter>()};
   Scanner scanner{expression, errorReporter.get()};
   Parser parser{scanner.tokenize(), errorReporter.get()};
-  const std::vector<Statement::StatementUPtr> statements{parser.parse()};
+  std::vector<Statement::StatementUPtr> statements{parser.parse()};
   if(errorReporter->hadError()) return 1;
-  Interpreter interpreter{};
+  // Optimizes the program for the given globals and resolves it.
+  const auto prepare{[&](GlobalEnvironment *globals) {
+    ConstantFolder{globals}.rewrite(statements);
+    Inliner inliner{};
+    inliner.rewrite(statements);
+    // Inlined bodies may be folded with the arguments they were given.
+    if(!inliner.inlines().empty()) ConstantFolder{globals}.rewrite(statements);
+    LoopHoister hoister{};
+    hoister.rewrite(statements);
+    DeadCodeEliminator eliminator{};
+    eliminator.rewrite(statements);
+    if(dumpOptimizations) {
+      for(const Inliner::Inline &inlined : inliner.inlines())
+        std::cerr << "Inlined a call to " << inlined.subroutine << " on line "
+                  << inlined.line << "\n";
+      for(const LoopHoister::Hoist &hoist : hoister.hoists())
+        std::cerr << "Hoisted " << hoist.expression << " out of a loop into "
+                  << hoist.temporary << "\n";
+      for(const DeadCodeEliminator::Removal &removal : eliminator.removals())
+        if(removal.count)
+          std::cerr << "Removed " << removal.kind << ": " << removal.count
+                    << " (" << removal.nodes << " nodes)\n";
+    }
+    Resolver resolver{globals, errorReporter.get()};
+    resolver.resolve(statements);
+    return !errorReporter->hadError();
+  }};
+  if(engine == "vm") {
+    VirtualMachine machine{};
+    if(maxDepth) machine.setMaxDepth(maxDepth.value());
+    if(!prepare(machine.globals())) return 1;
+    machine.interpret(statements);
+    return 0;
+  }
+  Interpreter interpreter{engine == "closures" ? Interpreter::Mode::Closures
+                                               : Interpreter::Mode::Walk};
+  if(maxDepth) interpreter.setMaxDepth(maxDepth.value());
+  if(!prepare(interpreter.globals())) return 1;
   interpreter.interpret(statements);
   return 0;
-}
\ No newline at end of file
+}
@@ -1,229 +1,234 @@
 #include "native.hpp"
 
-Prototypable Prototypable::copy() {
-  Callable newConstructor = constructor;
-  std::shared_ptr<Environment> newSurroundingEnv{
-      std::make_shared<Environment>()};
-  newSurroundingEnv->copyOver(surroundingEnv.get());
-  std::shared_ptr<Environment> newPublicEnv{std::make_shared<Environment>()};
-  newPublicEnv->copyOver(publicEnv.get());
-  std::shared_ptr<Environment> newPrivateEnv{std::make_shared<Environment>()};
-  newPrivateEnv->copyOver(privateEnv.get());
-  return Prototypable{
-      constructor,
-      newSurroundingEnv,
-      newPublicEnv,
-      newPrivateEnv,
-      Environment::unionize(
-          {newSurroundingEnv.get(), newPublicEnv.get(), newPrivateEnv.get()})};
-}
-
 namespace native {
 
-std::optional<std::any> doNothing(const std::vector<std::any> &args,
-                                  Environment *fnEnv) {
+std::optional<Value> doNothing(const std::vector<Value> &args,
+                               Environment *fnEnv) {
   return {};
 }
 
-std::optional<std::any> print(const std::vector<std::any> &args,
-                              Environment *fnEnv) {
-  std::any toPrint{args[0]};
-  if(toPrint.type() == typeid(std::string))
-    std::cout << std::any_cast<std::string>(toPrint) << '\n';
-  else if(toPrint.type() == typeid(bool))
-    std::cout << (std::any_cast<bool>(toPrint) ? "true" : "false") << '\n';
-  else if(toPrint.type() == typeid(long double))
-    std::cout << std::any_cast<long double>(toPrint) << '\n';
+std::optional<Value> print(const std::vector<Value> &args,
+                           Environment *fnEnv) {
+  const Value &toPrint{args[0]};
+  switch(toPrint.type()) {
+    case Value::Type::String:
+      std::cout << toPrint.asString().text() << '\n';
+      break;
+    case Value::Type::Boolean:
+      std::cout << (toPrint.asBoolean() ? "true" : "false") << '\n';
+      break;
+    case Value::Type::Integer: std::cout << toPrint.asInteger() << '\n'; break;
+    case Value::Type::Number: std::cout << toPrint.asNumber() << '\n'; break;
+    default: break;
+  }
   return {};
 }
 
-std::optional<std::any> input(const std::vector<std::any> &args,
-                              Environment *fnEnv) {
+std::optional<Value> input(const std::vector<Value> &args,
+                           Environment *fnEnv) {
   if(args.size()) print(args, fnEnv);
   std::string line;
   std::getline(std::cin, line);
   return line;
 }
 
-std::optional<std::any> time(const std::vector<std::any> &args,
-                             Environment *fnEnv) {
+std::optional<Value> time(const std::vector<Value> &args,
+                          Environment *fnEnv) {
   const std::chrono::time_point currentTime{std::chrono::system_clock::now()};
-  return static_cast<long double>(
+  return static_cast<std::int64_t>(
       std::chrono::system_clock::to_time_t(currentTime));
 }
 
-std::any min(const std::vector<std::any> &args, Environment *fnEnv) {
-  const long double valueA{std::any_cast<long double>(args[0])};
-  const long double valueB{std::any_cast<long double>(args[1])};
-  return std::min(valueA, valueB);
+Value min(const std::vector<Value> &args, Environment *fnEnv) {
+  // Returns the argument itself (like std::min) so integers stay integers.
+  const Number valueA{args[0].asNumber()};
+  const Number valueB{args[1].asNumber()};
+  return valueB < valueA ? args[1] : args[0];
 }
 
-std::any max(const std::vector<std::any> &args, Environment *fnEnv) {
-  const long double valueA{std::any_cast<long double>(args[0])};
-  const long double valueB{std::any_cast<long double>(args[1])};
-  return std::max(valueA, valueB);
+Value max(const std::vector<Value> &args, Environment *fnEnv) {
+  const Number valueA{args[0].asNumber()};
+  const Number valueB{args[1].asNumber()};
+  return valueA < valueB ? args[1] : args[0];
 }
 
-std::optional<std::any> abs(const std::vector<std::any> &args,
-                            Environment *fnEnv) {
-  const long double value{std::any_cast<long double>(args[0])};
+std::optional<Value> abs(const std::vector<Value> &args,
+                         Environment *fnEnv) {
+  if(args[0].type() == Value::Type::Integer &&
+     args[0].asInteger() != std::numeric_limits<std::int64_t>::min())
+    return std::abs(args[0].asInteger());
+  const Number value{args[0].asNumber()};
   return std::abs(value);
 }
 
-std::optional<std::any> round(const std::vector<std::any> &args,
-                              Environment *fnEnv) {
-  const long double value{std::any_cast<long double>(args[0])};
-  return std::round(value);
+std::optional<Value> round(const std::vector<Value> &args,
+                           Environment *fnEnv) {
+  if(args[0].type() == Value::Type::Integer) return args[0];
+  const Number value{args[0].asNumber()};
+  return Value::integral(std::round(value));
 }
 
-std::optional<std::any> floor(const std::vector<std::any> &args,
-                              Environment *fnEnv) {
-  const long double value{std::any_cast<long double>(args[0])};
-  return std::floor(value);
+std::optional<Value> floor(const std::vector<Value> &args,
+                           Environment *fnEnv) {
+  if(args[0].type() == Value::Type::Integer) return args[0];
+  const Number value{args[0].asNumber()};
+  return Value::integral(std::floor(value));
 }
 
-std::optional<std::any> ceil(const std::vector<std::any> &args,
-                             Environment *fnEnv) {
-  const long double value{std::any_cast<long double>(args[0])};
-  return std::ceil(value);
+std::optional<Value> ceil(const std::vector<Value> &args,
+                          Environment *fnEnv) {
+  if(args[0].type() == Value::Type::Integer) return args[0];
+  const Number value{args[0].asNumber()};
+  return Value::integral(std::ceil(value));
 }
 
-std::optional<std::any> truncate(const std::vector<std::any> &args,
-                                 Environment *fnEnv) {
-  const long double value{std::any_cast<long double>(args[0])};
-  return std::trunc(value);
+std::optional<Value> truncate(const std::vector<Value> &args,
+                              Environment *fnEnv) {
+  if(args[0].type() == Value::Type::Integer) return args[0];
+  const Number value{args[0].asNumber()};
+  return Value::integral(std::trunc(value));
 }
 
-std::optional<std::any> pow(const std::vector<std::any> &args,
-                            Environment *fnEnv) {
-  const long double base{std::any_cast<long double>(args[0])};
-  const long double power{std::any_cast<long double>(args[1])};
+std::optional<Value> pow(const std::vector<Value> &args,
+                         Environment *fnEnv) {
+  const Number base{args[0].asNumber()};
+  const Number power{args[1].asNumber()};
   return std::pow(base, power);
 }
 
-std::optional<std::any> exp(const std::vector<std::any> &args,
-                            Environment *fnEnv) {
-  const long double power{std::any_cast<long double>(args[0])};
+std::optional<Value> exp(const std::vector<Value> &args,
+                         Environment *fnEnv) {
+  const Number power{args[0].asNumber()};
   return std::exp(power);
 }
 
-std::optional<std::any> sqrt(const std::vector<std::any> &args,
-                             Environment *fnEnv) {
-  const long double value{std::any_cast<long double>(args[0])};
+std::optional<Value> sqrt(const std::vector<Value> &args,
+                          Environment *fnEnv) {
+  const Number value{args[0].asNumber()};
   return std::sqrt(value);
 }
 
-std::optional<std::any> cbrt(const std::vector<std::any> &args,
-                             Environment *fnEnv) {
-  const long double value{std::any_cast<long double>(args[0])};
+std::optional<Value> cbrt(const std::vector<Value> &args,
+                          Environment *fnEnv) {
+  const Number value{args[0].asNumber()};
   return std::cbrt(value);
 }
 
-std::optional<std::any> hypotenuse(const std::vector<std::any> &args,
-                                   Environment *fnEnv) {
-  const long double a{std::any_cast<long double>(args[0])};
-  const long double b{std::any_cast<long double>(args[1])};
+std::optional<Value> hypotenuse(const std::vector<Value> &args,
+                                Environment *fnEnv) {
+  const Number a{args[0].asNumber()};
+  const Number b{args[1].asNumber()};
   if(args.size() == 2) return std::hypot(a, b);
-  const long double c{std::any_cast<long double>(args[2])};
+  const Number c{args[2].asNumber()};
   return std::hypot(a, b, c);
 }
 
-std::optional<std::any> log(const std::vector<std::any> &args,
-                            Environment *fnEnv) {
-  const long double value{std::any_cast<long double>(args[0])};
+std::optional<Value> log(const std::vector<Value> &args,
+                         Environment *fnEnv) {
+  const Number value{args[0].asNumber()};
   return std::log10(value);
 }
 
-std::optional<std::any> lg(const std::vector<std::any> &args,
-                           Environment *fnEnv) {
-  const long double value{std::any_cast<long double>(args[0])};
+std::optional<Value> lg(const std::vector<Value> &args,
+                        Environment *fnEnv) {
+  const Number value{args[0].asNumber()};
   return std::log2(value);
 }
 
-std::optional<std::any> ln(const std::vector<std::any> &args,
-                           Environment *fnEnv) {
-  const long double value{std::any_cast<long double>(args[0])};
+std::optional<Value> ln(const std::vector<Value> &args,
+                        Environment *fnEnv) {
+  const Number value{args[0].asNumber()};
   return std::log(value);
 }
 
-std::optional<std::any> sin(const std::vector<std::any> &args,
-                            Environment *fnEnv) {
-  const long double value{std::any_cast<long double>(args[0])};
+std::optional<Value> sin(const std::vector<Value> &args,
+                         Environment *fnEnv) {
+  const Number value{args[0].asNumber()};
   return std::sin(value);
 }
 
-std::optional<std::any> cos(const std::vector<std::any> &args,
-                            Environment *fnEnv) {
-  const long double value{std::any_cast<long double>(args[0])};
+std::optional<Value> cos(const std::vector<Value> &args,
+                         Environment *fnEnv) {
+  const Number value{args[0].asNumber()};
   return std::cos(value);
 }
 
-std::optional<std::any> tan(const std::vector<std::any> &args,
-                            Environment *fnEnv) {
-  const long double value{std::any_cast<long double>(args[0])};
+std::optional<Value> tan(const std::vector<Value> &args,
+                         Environment *fnEnv) {
+  const Number value{args[0].asNumber()};
   return std::tan(value);
 }
 
-std::optional<std::any> sinh(const std::vector<std::any> &args,
-                             Environment *fnEnv) {
-  const long double value{std::any_cast<long double>(args[0])};
+std::optional<Value> sinh(const std::vector<Value> &args,
+                          Environment *fnEnv) {
+  const Number value{args[0].asNumber()};
   return std::sinh(value);
 }
 
-std::optional<std::any> cosh(const std::vector<std::any> &args,
-                             Environment *fnEnv) {
-  const long double value{std::any_cast<long double>(args[0])};
+std::optional<Value> cosh(const std::vector<Value> &args,
+                          Environment *fnEnv) {
+  const Number value{args[0].asNumber()};
   return std::cosh(value);
 }
 
-std::optional<std::any> tanh(const std::vector<std::any> &args,
-                             Environment *fnEnv) {
-  const long double value{std::any_cast<long double>(args[0])};
+std::optional<Value> tanh(const std::vector<Value> &args,
+                          Environment *fnEnv) {
+  const Number value{args[0].asNumber()};
   return std::tanh(value);
 }
 
-std::optional<std::any> arcsin(const std::vector<std::any> &args,
-                               Environment *fnEnv) {
-  const long double value{std::any_cast<long double>(args[0])};
+std::optional<Value> arcsin(const std::vector<Value> &args,
+                            Environment *fnEnv) {
+  const Number value{args[0].asNumber()};
   return std::asin(value);
 }
 
-std::optional<std::any> arccos(const std::vector<std::any> &args,
-                               Environment *fnEnv) {
-  const long double value{std::any_cast<long double>(args[0])};
+std::optional<Value> arccos(const std::vector<Value> &args,
+                            Environment *fnEnv) {
+  const Number value{args[0].asNumber()};
   return std::acos(value);
 }
 
-std::optional<std::any> arctan(const std::vector<std::any> &args,
-                               Environment *fnEnv) {
-  const long double y{std::any_cast<long double>(args[0])};
+std::optional<Value> arctan(const std::vector<Value> &args,
+                            Environment *fnEnv) {
+  const Number y{args[0].asNumber()};
   if(args.size() == 1) return std::atan(y);
-  const long double x{std::any_cast<long double>(args[1])};
+  const Number x{args[1].asNumber()};
   return std::atan2(y, x);
 }
 
-std::optional<std::any> arcsinh(const std::vector<std::any> &args,
-                                Environment *fnEnv) {
-  const long double value{std::any_cast<long double>(args[0])};
+std::optional<Value> arcsinh(const std::vector<Value> &args,
+                             Environment *fnEnv) {
+  const Number value{args[0].asNumber()};
   return std::asinh(value);
 }
 
-std::optional<std::any> arccosh(const std::vector<std::any> &args,
-                                Environment *fnEnv) {
-  const long double value{std::any_cast<long double>(args[0])};
+std::optional<Value> arccosh(const std::vector<Value> &args,
+                             Environment *fnEnv) {
+  const Number value{args[0].asNumber()};
   return std::acosh(value);
 }
 
-std::optional<std::any> arctanh(const std::vector<std::any> &args,
-                                Environment *fnEnv) {
-  const long double value{std::any_cast<long double>(args[0])};
+std::optional<Value> arctanh(const std::vector<Value> &args,
+                             Environment *fnEnv) {
+  const Number value{args[0].asNumber()};
   return std::atanh(value);
 }
 
-std::optional<std::any> isnan(const std::vector<std::any> &args,
-                              Environment *fnEnv) {
-  const long double value{std::any_cast<long double>(args[0])};
+std::optional<Value> isnan(const std::vector<Value> &args,
+                           Environment *fnEnv) {
+  const Number value{args[0].asNumber()};
   return std::isnan(value);
 }
 
+bool isPure(const std::string &name) {
+  static const std::unordered_set<std::string> pure{
+      "min", "max", "abs", "round", "floor", "ceil", "truncate",
+      "pow", "exp", "sqrt", "cbrt", "hypotenuse", "log", "lg", "ln",
+      "sin", "cos", "tan", "sinh", "cosh", "tanh",
+      "arcsin", "arccos", "arctan", "arcsinh", "arccosh", "arctanh",
+      "isnan"};
+  return pure.count(name) != 0;
+}
+
 } // namespace native
\ No newline at end of file
@@ -0,0 +1,406 @@
+#include "operators.hpp"
+
+namespace {
+Value stringOperation(const Value &leftVal,
+                      const Token::Type op,
+                      const Value &rightVal) {
+  if(op == Token::Type::Plus) return Value::concatenate(leftVal, rightVal);
+  const String &left{leftVal.asString()};
+  const String &right{rightVal.asString()};
+  switch(op) {
+    case Token::Type::EqualTo: return left == right;
+    case Token::Type::NotEqualTo: return left != right;
+    case Token::Type::LessThan: return left.text() < right.text();
+    case Token::Type::GreaterThan: return left.text() > right.text();
+    case Token::Type::LessThanOrEqualTo:
+      return left.text() <= right.text();
+    case Token::Type::GreaterThanOrEqualTo:
+      return left.text() >= right.text();
+    default: throw std::runtime_error("Not a supported string operator.");
+  }
+}
+
+Value booleanOperation(const bool left,
+                       const Token::Type op,
+                       const bool right) {
+  switch(op) {
+    case Token::Type::And: return left && right;
+    case Token::Type::Or: return left || right;
+    case Token::Type::EqualTo: return left == right;
+    case Token::Type::NotEqualTo: return left != right;
+    default: throw std::runtime_error("Not a supported boolean operator.");
+  }
+}
+
+Value numericOperation(const Number left,
+                       const Token::Type op,
+                       const Number right) {
+  switch(op) {
+    case Token::Type::NotEqualTo: return left != right;
+    case Token::Type::EqualTo: return left == right;
+    case Token::Type::LessThan: return left < right;
+    case Token::Type::LessThanOrEqualTo: return left <= right;
+    case Token::Type::GreaterThan: return left > right;
+    case Token::Type::GreaterThanOrEqualTo: return left >= right;
+    case Token::Type::Asterisk: return left * right;
+    case Token::Type::Plus: return left + right;
+    case Token::Type::Dash: return left - right;
+    case Token::Type::ForwardSlash:
+      if(right == 0) throw std::runtime_error{"Attempted to divide by zero!"};
+      return left / right;
+    case Token::Type::Modulus:
+      if(right == 0)
+        throw std::runtime_error{
+            "Attempted to take remainder of division by zero!"};
+      return static_cast<Number>(fmod(left, right));
+    default: throw std::runtime_error("Not a supported binary operator.");
+  }
+}
+
+Value integerOperation(const std::int64_t left,
+                       const Token::Type op,
+                       const std::int64_t right) {
+  std::int64_t result{0};
+  switch(op) {
+    case Token::Type::NotEqualTo: return left != right;
+    case Token::Type::EqualTo: return left == right;
+    case Token::Type::LessThan: return left < right;
+    case Token::Type::LessThanOrEqualTo: return left <= right;
+    case Token::Type::GreaterThan: return left > right;
+    case Token::Type::GreaterThanOrEqualTo: return left >= right;
+    case Token::Type::Asterisk:
+      if(!__builtin_mul_overflow(left, right, &result)) return result;
+      break;
+    case Token::Type::Plus:
+      if(!__builtin_add_overflow(left, right, &result)) return result;
+      break;
+    case Token::Type::Dash:
+      if(!__builtin_sub_overflow(left, right, &result)) return result;
+      break;
+    case Token::Type::ForwardSlash:
+      if(right == 0) throw std::runtime_error{"Attempted to divide by zero!"};
+      // Dividing the lowest integer by -1 overflows.
+      if(right != -1 && left % right == 0) return left / right;
+      if(right == -1 && left != std::numeric_limits<std::int64_t>::min())
+        return -left;
+      break;
+    case Token::Type::Modulus:
+      if(right == 0)
+        throw std::runtime_error{
+            "Attempted to take remainder of division by zero!"};
+      if(right == -1) return std::int64_t{0};
+      return left % right;
+    default: throw std::runtime_error("Not a supported binary operator.");
+  }
+  // Results that overflow or are not integral are computed as numbers.
+  return numericOperation(
+      static_cast<Number>(left), op, static_cast<Number>(right));
+}
+
+template <Token::Type Op, typename T>
+bool compare(const T left, const T right) {
+  if constexpr(Op == Token::Type::EqualTo) return left == right;
+  else if constexpr(Op == Token::Type::NotEqualTo) return left != right;
+  else if constexpr(Op == Token::Type::LessThan) return left < right;
+  else if constexpr(Op == Token::Type::LessThanOrEqualTo) return left <= right;
+  else if constexpr(Op == Token::Type::GreaterThan) return left > right;
+  else return left >= right;
+}
+
+constexpr bool isComparison(const Token::Type op) {
+  return op == Token::Type::EqualTo || op == Token::Type::NotEqualTo ||
+         op == Token::Type::LessThan || op == Token::Type::LessThanOrEqualTo ||
+         op == Token::Type::GreaterThan ||
+         op == Token::Type::GreaterThanOrEqualTo;
+}
+
+// The operand types binary operators specialize to. Each tells whether
+// operands are of its types, which operators it has specializations of, and
+// how those combine its operands.
+struct Integers {
+  static bool matches(const Value &left, const Value &right) {
+    return left.type() == Value::Type::Integer &&
+           right.type() == Value::Type::Integer;
+  }
+
+  static bool supports(const Token::Type op) { return true; }
+
+  template <Token::Type Op>
+  static void combine(Value &left, const Value &right) {
+    const std::int64_t a{left.asInteger()};
+    const std::int64_t b{right.asInteger()};
+    std::int64_t result{0};
+    if constexpr(isComparison(Op)) {
+      left = compare<Op>(a, b);
+      return;
+    } else if constexpr(Op == Token::Type::Plus) {
+      if(!__builtin_add_overflow(a, b, &result)) {
+        left = result;
+        return;
+      }
+    } else if constexpr(Op == Token::Type::Dash) {
+      if(!__builtin_sub_overflow(a, b, &result)) {
+        left = result;
+        return;
+      }
+    } else if constexpr(Op == Token::Type::Asterisk) {
+      if(!__builtin_mul_overflow(a, b, &result)) {
+        left = result;
+        return;
+      }
+    }
+    left = integerOperation(a, Op, b);
+  }
+};
+
+// Numbers mixed with integers, or with each other.
+struct Numbers {
+  static bool matches(const Value &left, const Value &right) {
+    return left.isNumber() && right.isNumber() &&
+           (left.type() == Value::Type::Number ||
+            right.type() == Value::Type::Number);
+  }
+
+  static bool supports(const Token::Type op) { return true; }
+
+  template <Token::Type Op>
+  static void combine(Value &left, const Value &right) {
+    const Number a{left.asNumber()};
+    const Number b{right.asNumber()};
+    if constexpr(isComparison(Op))
+      left = compare<Op>(a, b);
+    else if constexpr(Op == Token::Type::Plus)
+      left = a + b;
+    else if constexpr(Op == Token::Type::Dash)
+      left = a - b;
+    else if constexpr(Op == Token::Type::Asterisk)
+      left = a * b;
+    else
+      left = numericOperation(a, Op, b);
+  }
+};
+
+struct Strings {
+  static bool matches(const Value &left, const Value &right) {
+    return left.type() == Value::Type::String &&
+           right.type() == Value::Type::String;
+  }
+
+  static bool supports(const Token::Type op) {
+    return op == Token::Type::Plus || isComparison(op);
+  }
+
+  template <Token::Type Op>
+  static void combine(Value &left, const Value &right) {
+    left = stringOperation(left, Op, right);
+  }
+};
+
+struct Booleans {
+  static bool matches(const Value &left, const Value &right) {
+    return left.type() == Value::Type::Boolean &&
+           right.type() == Value::Type::Boolean;
+  }
+
+  static bool supports(const Token::Type op) {
+    return op == Token::Type::EqualTo || op == Token::Type::NotEqualTo;
+  }
+
+  template <Token::Type Op>
+  static void combine(Value &left, const Value &right) {
+    if constexpr(Op == Token::Type::EqualTo || Op == Token::Type::NotEqualTo)
+      left = compare<Op>(left.asBoolean(), right.asBoolean());
+  }
+};
+
+template <typename Operands, Token::Type Op>
+bool specialized(Value &left, const Value &right) {
+  if(!Operands::matches(left, right)) return false;
+  Operands::template combine<Op>(left, right);
+  return true;
+}
+
+template <typename Operands>
+operators::BinaryOperation operationOf(const Token::Type op) {
+  if(!Operands::supports(op)) return nullptr;
+  switch(op) {
+    case Token::Type::Plus: return specialized<Operands, Token::Type::Plus>;
+    case Token::Type::Dash: return specialized<Operands, Token::Type::Dash>;
+    case Token::Type::Asterisk:
+      return specialized<Operands, Token::Type::Asterisk>;
+    case Token::Type::ForwardSlash:
+      return specialized<Operands, Token::Type::ForwardSlash>;
+    case Token::Type::Modulus:
+      return specialized<Operands, Token::Type::Modulus>;
+    case Token::Type::EqualTo:
+      return specialized<Operands, Token::Type::EqualTo>;
+    case Token::Type::NotEqualTo:
+      return specialized<Operands, Token::Type::NotEqualTo>;
+    case Token::Type::LessThan:
+      return specialized<Operands, Token::Type::LessThan>;
+    case Token::Type::LessThanOrEqualTo:
+      return specialized<Operands, Token::Type::LessThanOrEqualTo>;
+    case Token::Type::GreaterThan:
+      return specialized<Operands, Token::Type::GreaterThan>;
+    case Token::Type::GreaterThanOrEqualTo:
+      return specialized<Operands, Token::Type::GreaterThanOrEqualTo>;
+    default: return nullptr;
+  }
+}
+
+bool negateInteger(Value &operand) {
+  if(operand.type() != Value::Type::Integer) return false;
+  if(operand.asInteger() == std::numeric_limits<std::int64_t>::min())
+    operand = -static_cast<Number>(operand.asInteger());
+  else
+    operand = -operand.asInteger();
+  return true;
+}
+
+bool negateNumber(Value &operand) {
+  if(operand.type() != Value::Type::Number) return false;
+  operand = -operand.asNumber();
+  return true;
+}
+
+bool notBoolean(Value &operand) {
+  if(operand.type() != Value::Type::Boolean) return false;
+  operand = !operand.asBoolean();
+  return true;
+}
+} // namespace
+
+namespace operators {
+bool isTrue(const Value &value) {
+  switch(value.type()) {
+    case Value::Type::Boolean: return value.asBoolean();
+    case Value::Type::Integer: return value.asInteger() != 0;
+    case Value::Type::Number: return value.asNumber() != 0.0;
+    case Value::Type::String: return value.asString().length() != 0;
+    default: return false;
+  }
+}
+
+bool logical(const Value &operand) {
+  if(operand.type() != Value::Type::Boolean)
+    throw std::runtime_error("Type mismatch between operator!");
+  return operand.asBoolean();
+}
+
+Value unary(const Token::Type op, const Value &right) {
+  switch(op) {
+    case Token::Type::Exclamation: return !right.asBoolean();
+    case Token::Type::Dash:
+      if(right.type() == Value::Type::Integer &&
+         right.asInteger() != std::numeric_limits<std::int64_t>::min())
+        return -right.asInteger();
+      return -right.asNumber();
+    default: throw std::runtime_error("Not a supported unary operator");
+  }
+}
+
+Value binary(const Value &left, const Token::Type op, const Value &right) {
+  if(left.type() == Value::Type::Integer &&
+     right.type() == Value::Type::Integer)
+    return integerOperation(left.asInteger(), op, right.asInteger());
+  // Integers mixed with other numbers are compared and combined as numbers.
+  if(left.isNumber() && right.isNumber())
+    return numericOperation(left.asNumber(), op, right.asNumber());
+  if(left.type() != right.type())
+    throw std::runtime_error("Type mismatch between operator!");
+  switch(left.type()) {
+    case Value::Type::String: return stringOperation(left, op, right);
+    case Value::Type::Boolean:
+      return booleanOperation(left.asBoolean(), op, right.asBoolean());
+    default: throw std::runtime_error("Type mismatch between operator!");
+  }
+}
+
+BinaryOperation
+    specialize(const Token::Type op, const Value &left, const Value &right) {
+  if(Integers::matches(left, right)) return operationOf<Integers>(op);
+  if(Numbers::matches(left, right)) return operationOf<Numbers>(op);
+  if(Strings::matches(left, right)) return operationOf<Strings>(op);
+  if(Booleans::matches(left, right)) return operationOf<Booleans>(op);
+  return nullptr;
+}
+
+UnaryOperation specialize(const Token::Type op, const Value &right) {
+  switch(right.type()) {
+    case Value::Type::Integer:
+      return op == Token::Type::Dash ? negateInteger : nullptr;
+    case Value::Type::Number:
+      return op == Token::Type::Dash ? negateNumber : nullptr;
+    case Value::Type::Boolean:
+      return op == Token::Type::Exclamation ? notBoolean : nullptr;
+    default: return nullptr;
+  }
+}
+
+void checkArity(const Callable &callable, const std::size_t count) {
+  if(count < callable.minArity || count > callable.maxArity)
+    throw std::runtime_error{
+        "Method expected at least " + std::to_string(callable.minArity) +
+        " arguments, at most " + std::to_string(callable.maxArity) +
+        " arguments, and received " + std::to_string(count) + " arguments."};
+}
+
+std::optional<Value> call(const Value &callee, const std::vector<Value> &args) {
+  switch(callee.type()) {
+    case Value::Type::Callable: {
+      const Callable &callable{callee.asCallable()};
+      checkArity(callable, args.size());
+      return callable.procedure(args, callable.fnEnv.get());
+    }
+    case Value::Type::Prototype: {
+      Prototypable newPrototype{callee.asPrototype().copy()};
+      if(args.size() < newPrototype.constructor.minArity ||
+         args.size() > newPrototype.constructor.maxArity)
+        throw std::runtime_error{
+            "Constructor expected at least " +
+            std::to_string(newPrototype.constructor.minArity) +
+            " arguments, at most " +
+            std::to_string(newPrototype.constructor.maxArity) +
+            " arguments, and received " + std::to_string(args.size()) +
+            " arguments."};
+      newPrototype.constructor.procedure(args, newPrototype.methodEnv.get());
+      return std::move(newPrototype);
+    }
+    default:
+      throw std::runtime_error{"Only functions and prototypes may be called."};
+  }
+}
+
+Value get(const Value &object, const Token &property) {
+  if(object.type() != Value::Type::Prototype)
+    throw std::runtime_error{"Can only receive properties from prototypes."};
+  const Prototypable &prototype{object.asPrototype()};
+  std::optional<Value> value{prototype.publicEnv->find(property)};
+  if(!value) {
+    if(prototype.privateEnv->find(property))
+      throw std::runtime_error{"Requested property is private."};
+    throw std::runtime_error{"Property not found in prototype."};
+  }
+  if(value->type() != Value::Type::Callable) return std::move(value.value());
+  // Methods run within the environment of the instance they were taken from.
+  Callable callable{value->asCallable()};
+  callable.fnEnv = prototype.methodEnv;
+  return callable;
+}
+
+void set(const Value &object, const Token &property, const Value &value) {
+  if(object.type() != Value::Type::Prototype)
+    throw std::runtime_error{"Can only set properties of prototypes."};
+  const Prototypable &prototype{object.asPrototype()};
+  switch(prototype.publicEnv->tryAssign(property, value)) {
+    case Environment::AssignStatus::Assigned: return;
+    case Environment::AssignStatus::Constant:
+      throw std::runtime_error{"Can not assign to the constant " +
+                               property.lexeme + "!"};
+    default:
+      if(prototype.privateEnv->find(property))
+        throw std::runtime_error{"Requested property is private."};
+      throw std::runtime_error{"Property not found in prototype."};
+  }
+}
+} // namespace operators
@@ -231,20 +231,13 @@ Expression::ExpressionUPtr Parser::assignment() {
   if(match({Token::Type::Equal})) {
     const Token equal{tokens[pos - 1]};
     Expression::ExpressionUPtr value{assignment()};
-    try {
-      const Token variable{
-          static_cast<Expression::Variable *>(expr.get())->variable};
-      return std::make_unique<Expression::Assignment>(variable,
+    if(auto *variable{dynamic_cast<Expression::Variable *>(expr.get())})
+      return std::make_unique<Expression::Assignment>(variable->variable,
                                                       std::move(value));
-    } catch(std::bad_cast) {
-      try {
-        Expression::Get *get{static_cast<Expression::Get *>(expr.get())};
-        return std::make_unique<Expression::Set>(
-            std::move(get->object), get->property, std::move(value));
-      } catch(std::bad_cast) {
-        error(equal, "Can not assign to this token.");
-      }
-    }
+    if(auto *get{dynamic_cast<Expression::Get *>(expr.get())})
+      return std::make_unique<Expression::Set>(
+          std::move(get->object), get->property, std::move(value));
+    error(equal, "Can not assign to this token.");
   }
   return std::move(expr);
 }
@@ -254,7 +247,7 @@ Expression::ExpressionUPtr Parser::andExpr() {
   while(match({Token::Type::And})) {
     const Token op{tokens[pos - 1]};
     Expression::ExpressionUPtr right{orExpr()};
-    left = std::make_unique<Expression::Binary>(
+    left = std::make_unique<Expression::Logical>(
         std::move(left), op, std::move(right));
   }
   return std::move(left);
@@ -265,7 +258,7 @@ Expression::ExpressionUPtr Parser::orExpr() {
   while(match({Token::Type::Or})) {
     const Token op{tokens[pos - 1]};
     Expression::ExpressionUPtr right{equality()};
-    left = std::make_unique<Expression::Binary>(
+    left = std::make_unique<Expression::Logical>(
         std::move(left), op, std::move(right));
   }
   return std::move(left);
@@ -356,11 +349,23 @@ Expression::ExpressionUPtr Parser::primary() {
   if(match({Token::Type::Boolean}))
     return std::make_unique<Expression::Literal>(
         tokens[pos - 1].lexeme == "true" ? true : false);
-  if(match({Token::Type::Number}))
-    return std::make_unique<Expression::Literal>(
-        std::stold(tokens[pos - 1].lexeme));
+  if(match({Token::Type::Number})) {
+    const std::string &lexeme{tokens[pos - 1].lexeme};
+    // Integral literals are exact unless they are too large for an integer.
+    if(lexeme.find('.') == std::string::npos) {
+      try {
+        return std::make_unique<Expression::Literal>(std::stoll(lexeme));
+      } catch(const std::out_of_range &) {
+      }
+    }
+    if constexpr(std::is_same_v<Number, double>)
+      return std::make_unique<Expression::Literal>(std::stod(lexeme));
+    else
+      return std::make_unique<Expression::Literal>(std::stold(lexeme));
+  }
   if(match({Token::Type::String}))
-    return std::make_unique<Expression::Literal>(tokens[pos - 1].lexeme);
+    return std::make_unique<Expression::Literal>(
+        Value::interned(tokens[pos - 1].lexeme));
   if(match({Token::Type::Identifier}))
     return std::make_unique<Expression::Variable>(tokens[pos - 1]);
   if(match({Token::Type::LeftParen})) {
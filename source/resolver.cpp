@@ -0,0 +1,403 @@
+#include "resolver.hpp"
+
+namespace {
+// Marks the calls whose value is the value of a returned expression.
+void markTailCalls(Expression::Expression *expr) {
+  if(auto *call{dynamic_cast<Expression::Call *>(expr)})
+    call->tail = true;
+  else if(auto *group{dynamic_cast<Expression::Group *>(expr)})
+    markTailCalls(group->expr.get());
+  else if(auto *ternary{dynamic_cast<Expression::Ternary *>(expr)}) {
+    markTailCalls(ternary->thenExpr.get());
+    markTailCalls(ternary->elseExpr.get());
+  }
+}
+} // namespace
+
+Resolver::Resolver(GlobalEnvironment *const iGlobals,
+                   ErrorReporter *const iErrorReporter) :
+    globals{iGlobals}, errorReporter{iErrorReporter} {}
+
+void Resolver::resolve(
+    const std::vector<Statement::StatementUPtr> &statements) {
+  // Subroutines may refer to globals declared after them, so gather every
+  // global declaration up front. New globals take the slots after the ones the
+  // global environment already has, in the order they are declared.
+  std::vector<Token> declared{};
+  std::size_t nextSlot{globals ? globals->size() : 0};
+  for(const Statement::StatementUPtr &statement : statements) {
+    auto *variable{dynamic_cast<Statement::Variable *>(statement.get())};
+    if(!variable) continue;
+    const Token &token{variable->variable};
+    std::optional<std::size_t> existing{globals ? globals->slot(token)
+                                                : std::nullopt};
+    auto [declaration, inserted] = globalDeclarations.try_emplace(
+        token.symbol, GlobalDeclaration{existing.value_or(nextSlot)});
+    if(inserted && !existing) nextSlot++;
+    declaration->second.constant = token.constant;
+    declared.push_back(token);
+  }
+  for(const Statement::StatementUPtr &statement : statements)
+    resolve(statement.get());
+  if(globals)
+    for(const Token &token : declared) globals->declare(token);
+}
+
+bool Resolver::visit(const Expression::Literal &literal,
+                     Environment *env,
+                     Value &result) {
+  return false;
+}
+
+bool Resolver::visit(const Expression::Unary &unary,
+                     Environment *env,
+                     Value &result) {
+  resolve(unary.right.get());
+  return false;
+}
+
+bool Resolver::visit(const Expression::Binary &binary,
+                     Environment *env,
+                     Value &result) {
+  resolve(binary.left.get());
+  resolve(binary.right.get());
+  return false;
+}
+
+bool Resolver::visit(const Expression::Logical &logical,
+                     Environment *env,
+                     Value &result) {
+  resolve(logical.left.get());
+  resolve(logical.right.get());
+  return false;
+}
+
+bool Resolver::visit(const Expression::Group &group,
+                     Environment *env,
+                     Value &result) {
+  resolve(group.expr.get());
+  return false;
+}
+
+bool Resolver::visit(const Expression::Ternary &ternary,
+                     Environment *env,
+                     Value &result) {
+  resolve(ternary.thenExpr.get());
+  resolve(ternary.condition.get());
+  resolve(ternary.elseExpr.get());
+  return false;
+}
+
+bool Resolver::visit(const Expression::Variable &variable,
+                     Environment *env,
+                     Value &result) {
+  bind(variable.variable, false, variable.binding);
+  return false;
+}
+
+bool Resolver::visit(const Expression::Assignment &assignment,
+                     Environment *env,
+                     Value &result) {
+  resolve(assignment.value.get());
+  bind(assignment.variable, true, assignment.binding);
+  return false;
+}
+
+bool Resolver::visit(const Expression::Call &call,
+                     Environment *env,
+                     Value &result) {
+  resolve(call.callee.get());
+  for(const Expression::ExpressionUPtr &arg : call.args) resolve(arg.get());
+  return false;
+}
+
+bool Resolver::visit(const Expression::Lambda &lambda,
+                     Environment *env,
+                     Value &result) {
+  // Dynamic lookups within prototypes walk the environments a lambda was
+  // created in, so lambdas there close over their whole scope.
+  const bool withinPrototype{std::any_of(
+      scopes.begin() + (functions.empty() ? 0 : functions.back().base),
+      scopes.end(),
+      [](const Scope &scope) { return scope.dynamic; })};
+  if(withinPrototype) {
+    captureScopes();
+    lambda.captures.reset();
+  } else {
+    lambda.captures.emplace();
+    functions.push_back(Function{scopes.size(), &lambda.captures.value()});
+  }
+  functionDepth++;
+  // Parameters take the first slots of the call's environment in order.
+  const std::size_t paramCount{lambda.params.size() +
+                               lambda.defaultParams.size()};
+  lambda.paramBindings.assign(paramCount, Binding{});
+  if(paramCount == 0) {
+    lambda.layout = FrameLayout{0, false, true};
+    resolve(lambda.body.get());
+  } else {
+    beginScope();
+    for(std::size_t i{0}; i < lambda.params.size(); i++)
+      declare(lambda.params[i], lambda.paramBindings[i]);
+    for(std::size_t i{0}; i < lambda.defaultParams.size(); i++) {
+      resolve(lambda.defaultParams[i].second.get());
+      declare(lambda.defaultParams[i].first,
+              lambda.paramBindings[lambda.params.size() + i]);
+    }
+    resolve(lambda.body.get());
+    lambda.layout = endScope();
+  }
+  functionDepth--;
+  if(!withinPrototype) functions.pop_back();
+  return false;
+}
+
+bool Resolver::visit(const Expression::Prototype &prototype,
+                     Environment *env,
+                     Value &result) {
+  if(prototype.parent)
+    bind(prototype.parent.value(), false, prototype.parentBinding);
+  captureScopes();
+  beginScope(true);
+  Binding property{};
+  declare(Token{"this", Token::Type::Identifier}, property);
+  if(prototype.parent)
+    declare(Token{"parent", Token::Type::Identifier}, property);
+  for(const auto *properties :
+      {&prototype.publicProperties, &prototype.privateProperties}) {
+    for(const Statement::StatementUPtr &statement : *properties) {
+      auto *variable{dynamic_cast<Statement::Variable *>(statement.get())};
+      if(variable) declare(variable->variable, property);
+    }
+  }
+  if(prototype.constructor) resolve(prototype.constructor.get());
+  for(const Statement::StatementUPtr &property : prototype.publicProperties)
+    resolve(property.get());
+  for(const Statement::StatementUPtr &property : prototype.privateProperties)
+    resolve(property.get());
+  endScope();
+  return false;
+}
+
+bool Resolver::visit(const Expression::Set &set,
+                     Environment *env,
+                     Value &result) {
+  resolve(set.value.get());
+  resolve(set.object.get());
+  return false;
+}
+
+bool Resolver::visit(const Expression::Get &get,
+                     Environment *env,
+                     Value &result) {
+  resolve(get.object.get());
+  return false;
+}
+
+Statement::Completion Resolver::visit(const Statement::Expression &expr,
+                                      Environment *env) {
+  resolve(expr.expr.get());
+  return Statement::Completion::Normal;
+}
+
+Statement::Completion Resolver::visit(const Statement::Variable &variable,
+                                      Environment *env) {
+  // Subroutines are declared before their body is resolved so they may call
+  // themselves recursively.
+  if(dynamic_cast<Expression::Lambda *>(variable.initializer.get())) {
+    declare(variable.variable, variable.binding);
+    resolve(variable.initializer.get());
+  } else {
+    resolve(variable.initializer.get());
+    declare(variable.variable, variable.binding);
+  }
+  return Statement::Completion::Normal;
+}
+
+Statement::Completion Resolver::visit(const Statement::Scope &scope,
+                                      Environment *env) {
+  // Scopes that declare nothing run directly in the enclosing environment.
+  const bool declares{std::any_of(
+      scope.statements.begin(),
+      scope.statements.end(),
+      [](const Statement::StatementUPtr &statement) {
+        return dynamic_cast<Statement::Variable *>(statement.get()) != nullptr;
+      })};
+  if(!declares) {
+    scope.layout = FrameLayout{0, false, true};
+    for(const Statement::StatementUPtr &statement : scope.statements)
+      resolve(statement.get());
+    return Statement::Completion::Normal;
+  }
+  beginScope();
+  for(const Statement::StatementUPtr &statement : scope.statements)
+    resolve(statement.get());
+  scope.layout = endScope();
+  return Statement::Completion::Normal;
+}
+
+Statement::Completion Resolver::visit(const Statement::If &ifStmt,
+                                      Environment *env) {
+  resolve(ifStmt.condition.get());
+  resolve(ifStmt.thenStmt.get());
+  resolve(ifStmt.elseStmt.get());
+  return Statement::Completion::Normal;
+}
+
+Statement::Completion Resolver::visit(const Statement::For &forStmt,
+                                      Environment *env) {
+  // Only a loop variable needs the loop to have its own environment, so while
+  // loops never get one.
+  const bool declares{
+      dynamic_cast<Statement::Variable *>(forStmt.initializer.get()) !=
+      nullptr};
+  if(declares) beginScope();
+  resolve(forStmt.initializer.get());
+  resolve(forStmt.condition.get());
+  resolve(forStmt.body.get());
+  resolve(forStmt.update.get());
+  forStmt.layout = declares ? endScope() : FrameLayout{0, false, true};
+  return Statement::Completion::Normal;
+}
+
+Statement::Completion Resolver::visit(const Statement::Return &returnStmt,
+                                      Environment *env) {
+  resolve(returnStmt.expr.get());
+  markTailCalls(returnStmt.expr.get());
+  return Statement::Completion::Normal;
+}
+
+void Resolver::resolve(Expression::Expression *expr) {
+  Value unused{};
+  if(expr) expr->accept(this, nullptr, unused);
+}
+
+void Resolver::resolve(Statement::Statement *statement) {
+  if(statement) statement->accept(this, nullptr);
+}
+
+void Resolver::beginScope(const bool dynamic) {
+  scopes.push_back(Scope{dynamic});
+}
+
+FrameLayout Resolver::endScope() {
+  const FrameLayout layout{scopes.back().declarations.size(),
+                           scopes.back().captured};
+  scopes.pop_back();
+  return layout;
+}
+
+void Resolver::captureScopes() {
+  // Prototypes and the lambdas within them keep every enclosing environment of
+  // the running subroutine alive, so none of them can live on the stack.
+  for(std::size_t i{functions.empty() ? 0 : functions.back().base};
+      i < scopes.size();
+      i++)
+    scopes[i].captured = true;
+}
+
+void Resolver::declare(const Token &variable, Binding &binding) {
+  if(scopes.empty()) {
+    definedGlobals.insert(variable.symbol);
+    binding = Binding{
+        Binding::Kind::Global, 0, globalDeclarations.at(variable.symbol).slot};
+    return;
+  }
+  Scope &scope{scopes.back()};
+  auto [declaration, inserted] = scope.declarations.try_emplace(
+      variable.symbol,
+      Declaration{scope.declarations.size(), variable.constant});
+  declaration->second.constant = variable.constant;
+  if(scope.dynamic) {
+    binding = Binding{Binding::Kind::Dynamic};
+    return;
+  }
+  use(declaration->second, scopes.size() - 1, binding);
+}
+
+void Resolver::bind(const Token &variable,
+                    const bool assigning,
+                    Binding &binding) {
+  bool crossedPrototype{false};
+  for(std::size_t depth{0}; depth < scopes.size(); depth++) {
+    const std::size_t index{scopes.size() - 1 - depth};
+    Scope &scope{scopes[index]};
+    auto declaration{scope.declarations.find(variable.symbol)};
+    if(declaration != scope.declarations.end()) {
+      if(scope.dynamic) {
+        binding = Binding{Binding::Kind::Dynamic};
+        return;
+      }
+      if(assigning && declaration->second.constant && errorReporter)
+        errorReporter->report(variable,
+                              "Can not assign to the constant " +
+                                  variable.lexeme + "!");
+      use(declaration->second, index, binding);
+      return;
+    }
+    crossedPrototype = crossedPrototype || scope.dynamic;
+  }
+  // Within prototypes unknown names may be inherited properties.
+  if(crossedPrototype) {
+    binding = Binding{Binding::Kind::Dynamic};
+    return;
+  }
+
+  std::optional<bool> constant{};
+  std::size_t slot{0};
+  if(std::optional<Token> existing{globals ? globals->declaration(variable)
+                                           : std::nullopt}) {
+    constant = existing->constant;
+    slot = globals->slot(variable).value();
+  }
+  auto declaration{globalDeclarations.find(variable.symbol)};
+  if(declaration != globalDeclarations.end()) {
+    slot = declaration->second.slot;
+    if(functionDepth > 0 || definedGlobals.count(variable.symbol))
+      constant = declaration->second.constant;
+  }
+  if(!constant) {
+    if(errorReporter)
+      errorReporter->report(variable,
+                            "Undefined variable \"" + variable.lexeme + "\"!");
+  } else if(assigning && constant.value() && errorReporter)
+    errorReporter->report(
+        variable, "Can not assign to the constant " + variable.lexeme + "!");
+  binding = Binding{Binding::Kind::Global, 0, slot};
+}
+
+void Resolver::use(Declaration &declaration,
+                   const std::size_t index,
+                   Binding &binding) {
+  auto first{std::find_if(functions.begin(),
+                          functions.end(),
+                          [&](const Function &function) {
+                            return function.base > index;
+                          })};
+  if(first == functions.end()) {
+    binding = Binding{
+        declaration.boxed ? Binding::Kind::Boxed : Binding::Kind::Local,
+        scopes.size() - 1 - index,
+        declaration.slot};
+    declaration.uses.push_back(&binding);
+    return;
+  }
+  // The outermost function between here and the declaration takes the cell
+  // from the environment it is created in, and each function within it takes
+  // the cell from the captures of the one enclosing it.
+  box(declaration);
+  Binding source{Binding::Kind::Boxed, first->base - 1 - index, declaration.slot};
+  for(auto function{first}; function != functions.end(); function++) {
+    auto [capture, inserted] = function->indices.try_emplace(
+        &declaration, function->captures->size());
+    if(inserted) function->captures->push_back(source);
+    source = Binding{Binding::Kind::Captured, 0, capture->second};
+  }
+  binding = source;
+}
+
+void Resolver::box(Declaration &declaration) {
+  if(declaration.boxed) return;
+  declaration.boxed = true;
+  for(Binding *use : declaration.uses) use->kind = Binding::Kind::Boxed;
+}
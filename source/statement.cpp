@@ -4,22 +4,22 @@ namespace Statement {
 Expression::Expression(::Expression::ExpressionUPtr iExpr) :
     expr{std::move(iExpr)} {}
 
-void Expression::accept(Visitor *visitor, Environment *env) {
-  visitor->visit(*this, env);
+Completion Expression::accept(Visitor *visitor, Environment *env) {
+  return visitor->visit(*this, env);
 }
 
 Variable::Variable(const Token &iVariable,
                    ::Expression::ExpressionUPtr iInitializer) :
     variable{iVariable}, initializer{std::move(iInitializer)} {}
 
-void Variable::accept(Visitor *visitor, Environment *env) {
+Completion Variable::accept(Visitor *visitor, Environment *env) {
   return visitor->visit(*this, env);
 }
 
 Scope::Scope(std::vector<StatementUPtr> iStatements) :
     statements{std::move(iStatements)} {}
 
-void Scope::accept(Visitor *visitor, Environment *env) {
+Completion Scope::accept(Visitor *visitor, Environment *env) {
   return visitor->visit(*this, env);
 }
 
@@ -30,7 +30,7 @@ If::If(::Expression::ExpressionUPtr iCondition,
     thenStmt{std::move(iThen)},
     elseStmt{std::move(iElse)} {}
 
-void If::accept(Visitor *visitor, Environment *env) {
+Completion If::accept(Visitor *visitor, Environment *env) {
   return visitor->visit(*this, env);
 }
 
@@ -43,14 +43,14 @@ For::For(StatementUPtr iInitializer,
     body{std::move(iBody)},
     update{std::move(iUpdate)} {}
 
-void For::accept(Visitor *visitor, Environment *env) {
+Completion For::accept(Visitor *visitor, Environment *env) {
   return visitor->visit(*this, env);
 }
 
 Return::Return(const Token &iKeyword, ::Expression::ExpressionUPtr iExpr) :
     keyword{iKeyword}, expr{std::move(iExpr)} {}
 
-void Return::accept(Visitor *visitor, Environment *env) {
+Completion Return::accept(Visitor *visitor, Environment *env) {
   return visitor->visit(*this, env);
 }
 } // namespace Statement
\ No newline at end of file
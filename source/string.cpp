@@ -0,0 +1,82 @@
+#include "string.hpp"
+#include "value.hpp"
+#include <functional>
+#include <vector>
+
+struct String::Concatenation {
+  Value left;
+  Value right;
+};
+
+String::String(std::string iContents, const bool iInterned) :
+    contents{std::move(iContents)},
+    size{contents.size()},
+    isInterned{iInterned} {}
+
+String::String(const Value &left, const Value &right) :
+    parts{std::make_unique<Concatenation>(Concatenation{left, right})},
+    size{left.asString().length() + right.asString().length()} {}
+
+String::String(String &&other) noexcept :
+    contents{std::move(other.contents)},
+    parts{std::move(other.parts)},
+    size{other.size},
+    hashValue{other.hashValue},
+    hashed{other.hashed},
+    isInterned{other.isInterned} {}
+
+String::~String() {
+  release(std::move(parts));
+}
+
+std::size_t String::hash() const {
+  if(!hashed) {
+    hashValue = std::hash<std::string>{}(text());
+    hashed = true;
+  }
+  return hashValue;
+}
+
+bool String::operator==(const String &other) const {
+  if(this == &other) return true;
+  // Interned strings are unique, so two different ones always differ.
+  if(isInterned && other.isInterned) return false;
+  if(size != other.size) return false;
+  if(hashed && other.hashed && hashValue != other.hashValue) return false;
+  return text() == other.text();
+}
+
+void String::flatten() const {
+  // Ropes built in a loop are as deep as the loop ran, so they are walked with
+  // an explicit stack.
+  std::string flat{};
+  flat.reserve(size);
+  std::vector<const String *> pending{this};
+  while(!pending.empty()) {
+    const String *string{pending.back()};
+    pending.pop_back();
+    if(string->parts) {
+      pending.push_back(&string->parts->right.asString());
+      pending.push_back(&string->parts->left.asString());
+    } else
+      flat += string->contents;
+  }
+  contents = std::move(flat);
+  release(std::move(parts));
+}
+
+void String::release(std::unique_ptr<Concatenation> rope) noexcept {
+  // Tears ropes down iteratively for the same reason: the parts of operands
+  // only this rope refers to are detached before the operands are destroyed.
+  std::vector<std::unique_ptr<Concatenation>> pending{};
+  if(rope) pending.push_back(std::move(rope));
+  while(!pending.empty()) {
+    std::unique_ptr<Concatenation> concatenation{std::move(pending.back())};
+    pending.pop_back();
+    for(Value *operand : {&concatenation->left, &concatenation->right}) {
+      const String &string{operand->asString()};
+      if(string.parts && operand->object()->references == 1)
+        pending.push_back(std::move(string.parts));
+    }
+  }
+}
@@ -0,0 +1,28 @@
+#include "symbol.hpp"
+
+SymbolId Symbols::intern(const std::string &name) {
+  Table &symbols{table()};
+  auto [entry, inserted] = symbols.ids.try_emplace(
+      name, static_cast<SymbolId>(symbols.names.size()));
+  // Keys of an unordered_map never move, so the names can point at them.
+  if(inserted) symbols.names.push_back(&entry->first);
+  return entry->second;
+}
+
+const std::string &Symbols::name(const SymbolId symbol) {
+  static const std::string empty{};
+  const Table &symbols{table()};
+  if(symbol == none || symbol >= symbols.names.size()) return empty;
+  return *symbols.names[symbol];
+}
+
+std::size_t Symbols::size() {
+  return table().names.size() - 1;
+}
+
+Symbols::Table &Symbols::table() {
+  // Constructed on first use so tokens made during static initialization can
+  // intern safely.
+  static Table symbols{};
+  return symbols;
+}
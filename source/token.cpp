@@ -1,11 +1,22 @@
 #include "token.hpp"
 
+Token::Token(std::string iLexeme,
+             const Type iType,
+             const bool iConstant,
+             const int iLine,
+             const int iCol) :
+    lexeme{std::move(iLexeme)},
+    type{iType}, constant{iConstant}, line{iLine}, col{iCol},
+    symbol{iType == Type::Identifier ? Symbols::intern(lexeme)
+                                     : Symbols::none} {}
+
 bool Token::operator==(const Type rhs) const {
   return type == rhs;
 }
 
 bool Token::operator==(const Token &rhs) const {
-  return lexeme == rhs.lexeme && type == rhs.type;
+  if(symbol != rhs.symbol || type != rhs.type) return false;
+  return symbol != Symbols::none || lexeme == rhs.lexeme;
 }
 
 std::ostream &operator<<(std::ostream &out, const Token::Type type) {
@@ -0,0 +1,182 @@
+#include "treeRewriter.hpp"
+#include <algorithm>
+
+void TreeRewriter::rewrite(std::vector<Statement::StatementUPtr> &statements) {
+  rewriteEach(statements);
+}
+
+bool TreeRewriter::visit(const Expression::Literal &literal,
+                         Environment *env,
+                         Value &result) {
+  return false;
+}
+
+bool TreeRewriter::visit(const Expression::Unary &unary,
+                         Environment *env,
+                         Value &result) {
+  rewrite(unary.right);
+  return false;
+}
+
+bool TreeRewriter::visit(const Expression::Binary &binary,
+                         Environment *env,
+                         Value &result) {
+  rewrite(binary.left);
+  rewrite(binary.right);
+  return false;
+}
+
+bool TreeRewriter::visit(const Expression::Logical &logical,
+                         Environment *env,
+                         Value &result) {
+  rewrite(logical.left);
+  rewrite(logical.right);
+  return false;
+}
+
+bool TreeRewriter::visit(const Expression::Group &group,
+                         Environment *env,
+                         Value &result) {
+  rewrite(group.expr);
+  return false;
+}
+
+bool TreeRewriter::visit(const Expression::Ternary &ternary,
+                         Environment *env,
+                         Value &result) {
+  rewrite(ternary.condition);
+  rewrite(ternary.thenExpr);
+  rewrite(ternary.elseExpr);
+  return false;
+}
+
+bool TreeRewriter::visit(const Expression::Variable &variable,
+                         Environment *env,
+                         Value &result) {
+  return false;
+}
+
+bool TreeRewriter::visit(const Expression::Assignment &assignment,
+                         Environment *env,
+                         Value &result) {
+  rewrite(assignment.value);
+  return false;
+}
+
+bool TreeRewriter::visit(const Expression::Call &call,
+                         Environment *env,
+                         Value &result) {
+  rewrite(call.callee);
+  for(Expression::ExpressionUPtr &arg : call.args) rewrite(arg);
+  return false;
+}
+
+bool TreeRewriter::visit(const Expression::Lambda &lambda,
+                         Environment *env,
+                         Value &result) {
+  for(auto &param : lambda.defaultParams) rewrite(param.second);
+  rewrite(lambda.body);
+  return false;
+}
+
+bool TreeRewriter::visit(const Expression::Prototype &prototype,
+                         Environment *env,
+                         Value &result) {
+  rewrite(prototype.constructor);
+  rewriteEach(prototype.publicProperties);
+  rewriteEach(prototype.privateProperties);
+  return false;
+}
+
+bool TreeRewriter::visit(const Expression::Set &set,
+                         Environment *env,
+                         Value &result) {
+  rewrite(set.object);
+  rewrite(set.value);
+  return false;
+}
+
+bool TreeRewriter::visit(const Expression::Get &get,
+                         Environment *env,
+                         Value &result) {
+  rewrite(get.object);
+  return false;
+}
+
+Statement::Completion TreeRewriter::visit(const Statement::Expression &expr,
+                                          Environment *env) {
+  rewrite(expr.expr);
+  return Statement::Completion::Normal;
+}
+
+Statement::Completion TreeRewriter::visit(const Statement::Variable &variable,
+                                          Environment *env) {
+  rewrite(variable.initializer);
+  return Statement::Completion::Normal;
+}
+
+Statement::Completion TreeRewriter::visit(const Statement::Scope &scope,
+                                          Environment *env) {
+  rewriteEach(scope.statements);
+  return Statement::Completion::Normal;
+}
+
+Statement::Completion TreeRewriter::visit(const Statement::If &ifStmt,
+                                          Environment *env) {
+  rewrite(ifStmt.condition);
+  rewrite(ifStmt.thenStmt);
+  rewrite(ifStmt.elseStmt);
+  return Statement::Completion::Normal;
+}
+
+Statement::Completion TreeRewriter::visit(const Statement::For &forStmt,
+                                          Environment *env) {
+  rewrite(forStmt.initializer);
+  rewrite(forStmt.condition);
+  rewrite(forStmt.body);
+  rewrite(forStmt.update);
+  return Statement::Completion::Normal;
+}
+
+Statement::Completion TreeRewriter::visit(const Statement::Return &returnStmt,
+                                          Environment *env) {
+  rewrite(returnStmt.expr);
+  return Statement::Completion::Normal;
+}
+
+bool TreeRewriter::rewrite(Expression::ExpressionUPtr &expr, Value &result) {
+  if(!expr) return false;
+  replacedExpression = nullptr;
+  const bool returned{expr->accept(this, nullptr, result)};
+  if(replacedExpression) expr = std::move(replacedExpression);
+  return returned;
+}
+
+bool TreeRewriter::rewrite(Expression::ExpressionUPtr &expr) {
+  Value unused{};
+  return rewrite(expr, unused);
+}
+
+void TreeRewriter::rewrite(Statement::StatementUPtr &statement) {
+  if(!statement) return;
+  replacedStatement.reset();
+  statement->accept(this, nullptr);
+  if(!replacedStatement) return;
+  statement = std::move(replacedStatement.value());
+  replacedStatement.reset();
+}
+
+void TreeRewriter::rewriteEach(
+    std::vector<Statement::StatementUPtr> &statements) {
+  for(Statement::StatementUPtr &statement : statements) rewrite(statement);
+  statements.erase(std::remove(statements.begin(), statements.end(), nullptr),
+                   statements.end());
+}
+
+void TreeRewriter::replace(Expression::ExpressionUPtr replacement) {
+  replacedExpression = std::move(replacement);
+}
+
+void TreeRewriter::replace(Statement::StatementUPtr replacement) {
+  replacedStatement = std::move(replacement);
+}
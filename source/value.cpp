@@ -0,0 +1,66 @@
+#include "value.hpp"
+#include "environment.hpp"
+#include <string_view>
+#include <unordered_map>
+
+Prototypable Prototypable::copy() const {
+  std::shared_ptr<Environment> newSurroundingEnv{surroundingEnv->copy()};
+  std::shared_ptr<Environment> newPublicEnv{publicEnv->copy()};
+  std::shared_ptr<Environment> newPrivateEnv{privateEnv->copy()};
+  return Prototypable{
+      constructor,
+      newSurroundingEnv,
+      newPublicEnv,
+      newPrivateEnv,
+      Environment::unionize(
+          {newSurroundingEnv.get(), newPublicEnv.get(), newPrivateEnv.get()})};
+}
+
+Value::Value(std::string iString) : kind{Type::String} {
+  hold(new Boxed<String>{std::move(iString)});
+}
+
+Value::Value(const char *iString) : Value{std::string{iString}} {}
+
+Value::Value(Callable iCallable) : kind{Type::Callable} {
+  hold(new Boxed<Callable>{std::move(iCallable)});
+}
+
+Value::Value(Prototypable iPrototype) : kind{Type::Prototype} {
+  hold(new Boxed<Prototypable>{std::move(iPrototype)});
+}
+
+Value Value::interned(const std::string &text) {
+  // Keyed by views of the interned strings themselves, which the table keeps
+  // alive.
+  static std::unordered_map<std::string_view, Value> table{};
+  if(const auto found{table.find(text)}; found != table.end())
+    return found->second;
+  Value string{};
+  string.hold(new Boxed<String>{text, true});
+  string.kind = Type::String;
+  const std::string_view key{string.asString().text()};
+  return table.emplace(key, std::move(string)).first->second;
+}
+
+Value Value::concatenate(const Value &left, const Value &right) {
+  const String &first{left.asString()};
+  const String &second{right.asString()};
+  if(first.length() == 0) return right;
+  if(second.length() == 0) return left;
+  // Short strings are cheaper to copy than to keep ropes of, and are never
+  // ropes themselves.
+  if(first.length() + second.length() < String::ropeLength)
+    return first.text() + second.text();
+  Value rope{};
+  rope.hold(new Boxed<String>{left, right});
+  rope.kind = Type::String;
+  return rope;
+}
+
+Value Value::cell(Value contents) {
+  Value cell{};
+  cell.hold(new Boxed<Value>{std::move(contents)});
+  cell.kind = Type::Cell;
+  return cell;
+}
@@ -0,0 +1,398 @@
+#include "virtualMachine.hpp"
+
+using Bytecode::OpCode;
+
+namespace {
+// Gets the operator a comparison operation applies.
+Token::Type comparisonOperator(const OpCode op) {
+  switch(op) {
+    case OpCode::Equal: return Token::Type::EqualTo;
+    case OpCode::NotEqual: return Token::Type::NotEqualTo;
+    case OpCode::Less: return Token::Type::LessThan;
+    case OpCode::LessEqual: return Token::Type::LessThanOrEqualTo;
+    case OpCode::Greater: return Token::Type::GreaterThan;
+    default: return Token::Type::GreaterThanOrEqualTo;
+  }
+}
+} // namespace
+
+std::optional<Value>
+    VirtualMachine::ClosureCall::operator()(const std::vector<Value> &args,
+                                            Environment *fnEnv) const {
+  return machine->call(*this, args);
+}
+
+void VirtualMachine::interpret(
+    const std::vector<Statement::StatementUPtr> &statements) {
+  try {
+    try {
+      programs.push_back(
+          std::make_unique<Bytecode::Program>(Compiler{}.compile(statements)));
+    } catch(const Compiler::Unsupported &) {
+      // Nothing has run yet, so the tree walker can run the program instead.
+      interpreter.interpret(statements);
+      return;
+    }
+    const Bytecode::Program *program{programs.back().get()};
+    call(ClosureCall{this, program, program->functions.front().get(), nullptr},
+         {});
+  } catch(std::runtime_error &e) {
+    // Errors end the program and are printed as the tree walker prints them.
+    std::cout << e.what() << '\n';
+  }
+}
+
+GlobalEnvironment *VirtualMachine::globals() const {
+  return interpreter.globals();
+}
+
+void VirtualMachine::setMaxDepth(const std::size_t iMaxDepth) {
+  maxDepth = iMaxDepth;
+  interpreter.setMaxDepth(iMaxDepth);
+}
+
+Value VirtualMachine::call(const ClosureCall &closure,
+                           const std::vector<Value> &args) {
+  const std::size_t stackSize{stack.size()};
+  const std::size_t frameCount{frames.size()};
+  try {
+    // A placeholder takes the callee's place below the registers.
+    stack.emplace_back();
+    stack.insert(stack.end(), args.begin(), args.end());
+    enter(closure, stackSize + 1, args.size());
+    // Calls from outside the loop, such as from methods, nest natively.
+    CallStack::grow([&] {
+      run(frameCount);
+      return true;
+    });
+  } catch(...) {
+    // The calls the error interrupted are abandoned.
+    stack.resize(stackSize);
+    frames.erase(frames.begin() + frameCount, frames.end());
+    throw;
+  }
+  Value returned{std::move(stack.back())};
+  stack.pop_back();
+  return returned;
+}
+
+void VirtualMachine::enter(const ClosureCall &closure,
+                           const std::size_t base,
+                           const std::size_t argCount) {
+  // The frame of the program itself is not a call.
+  if(frames.size() > maxDepth) CallStack::overflow();
+  // Registers past the arguments start out nil, like fresh slots.
+  stack.resize(base + closure.function->registers);
+  frames.push_back(Frame{closure.program,
+                         closure.function,
+                         closure.function->code.data(),
+                         base,
+                         argCount,
+                         closure.captures.get()});
+}
+
+void VirtualMachine::run(const std::size_t exitDepth) {
+  GlobalEnvironment *const global{globals()};
+  Frame *frame{&frames.back()};
+  const Bytecode::Instruction *ip{frame->ip};
+  // Applies an operator the fast paths did not handle to the top two operands.
+  const auto binary{[&](const Token::Type op) {
+    Value &left{stack[stack.size() - 2]};
+    left = operators::binary(left, op, stack.back());
+    stack.pop_back();
+  }};
+  // Compares the top two operands, directly when both are integers.
+  const auto compare{[&](const Token::Type op, auto compareIntegers) {
+    Value &left{stack[stack.size() - 2]};
+    const Value &right{stack.back()};
+    if(left.type() == Value::Type::Integer &&
+       right.type() == Value::Type::Integer) {
+      left = compareIntegers(left.asInteger(), right.asInteger());
+      stack.pop_back();
+    } else
+      binary(op);
+  }};
+  // Combines the top two operands, directly when both are integers and the
+  // result does not overflow or need special handling.
+  const auto arithmetic{[&](const Token::Type op, auto overflows) {
+    Value &left{stack[stack.size() - 2]};
+    const Value &right{stack.back()};
+    std::int64_t result{0};
+    if(left.type() == Value::Type::Integer &&
+       right.type() == Value::Type::Integer &&
+       !overflows(left.asInteger(), right.asInteger(), &result)) {
+      left = result;
+      stack.pop_back();
+    } else
+      binary(op);
+  }};
+  // Pops the top two operands and tells if the comparison holds between them.
+  const auto holds{[&](const OpCode op) {
+    const Value &left{stack[stack.size() - 2]};
+    const Value &right{stack.back()};
+    bool result{false};
+    if(left.type() == Value::Type::Integer &&
+       right.type() == Value::Type::Integer) {
+      const std::int64_t a{left.asInteger()};
+      const std::int64_t b{right.asInteger()};
+      switch(op) {
+        case OpCode::Equal: result = a == b; break;
+        case OpCode::NotEqual: result = a != b; break;
+        case OpCode::Less: result = a < b; break;
+        case OpCode::LessEqual: result = a <= b; break;
+        case OpCode::Greater: result = a > b; break;
+        default: result = a >= b; break;
+      }
+    } else
+      result =
+          operators::binary(left, comparisonOperator(op), right).asBoolean();
+    stack.pop_back();
+    stack.pop_back();
+    return result;
+  }};
+  for(;;) {
+    const Bytecode::Instruction instruction{*ip++};
+    switch(instruction.op) {
+      case OpCode::Constant:
+        stack.push_back(frame->function->constants[instruction.a]);
+        break;
+      case OpCode::Nil: stack.emplace_back(); break;
+      case OpCode::Pop: stack.pop_back(); break;
+      case OpCode::GetLocal:
+        stack.push_back(stack[frame->base + instruction.a]);
+        break;
+      case OpCode::SetLocal:
+        stack[frame->base + instruction.a] = stack.back();
+        break;
+      case OpCode::DefineLocal:
+        stack[frame->base + instruction.a] = std::move(stack.back());
+        stack.pop_back();
+        break;
+      case OpCode::NewCell:
+        stack[frame->base + instruction.a] = Value::cell();
+        break;
+      case OpCode::Box: {
+        Value &reg{stack[frame->base + instruction.a]};
+        reg = Value::cell(std::move(reg));
+        break;
+      }
+      case OpCode::GetCell:
+        stack.push_back(stack[frame->base + instruction.a].contents());
+        break;
+      case OpCode::SetCell:
+        stack[frame->base + instruction.a].contents() = stack.back();
+        break;
+      case OpCode::GetCaptured:
+        stack.push_back((*frame->captures)[instruction.a].contents());
+        break;
+      case OpCode::SetCaptured:
+        (*frame->captures)[instruction.a].contents() = stack.back();
+        break;
+      case OpCode::GetGlobal:
+        stack.push_back(global->getSlot(instruction.a));
+        break;
+      case OpCode::SetGlobal:
+        global->assignSlot(instruction.a, stack.back());
+        break;
+      case OpCode::DefineGlobal:
+        global->defineSlot(instruction.a, stack.back());
+        stack.pop_back();
+        break;
+      case OpCode::Negate:
+        stack.back() = operators::unary(Token::Type::Dash, stack.back());
+        break;
+      case OpCode::Not: stack.back() = !stack.back().asBoolean(); break;
+      case OpCode::Add:
+        arithmetic(Token::Type::Plus,
+                   [](std::int64_t a, std::int64_t b, std::int64_t *r) {
+                     return __builtin_add_overflow(a, b, r);
+                   });
+        break;
+      case OpCode::Subtract:
+        arithmetic(Token::Type::Dash,
+                   [](std::int64_t a, std::int64_t b, std::int64_t *r) {
+                     return __builtin_sub_overflow(a, b, r);
+                   });
+        break;
+      case OpCode::Multiply:
+        arithmetic(Token::Type::Asterisk,
+                   [](std::int64_t a, std::int64_t b, std::int64_t *r) {
+                     return __builtin_mul_overflow(a, b, r);
+                   });
+        break;
+      case OpCode::Divide:
+        // Division by zero or -1, and inexact division, take the slow path.
+        arithmetic(Token::Type::ForwardSlash,
+                   [](std::int64_t a, std::int64_t b, std::int64_t *r) {
+                     if(b == 0 || b == -1 || a % b != 0) return true;
+                     *r = a / b;
+                     return false;
+                   });
+        break;
+      case OpCode::Modulus:
+        arithmetic(Token::Type::Modulus,
+                   [](std::int64_t a, std::int64_t b, std::int64_t *r) {
+                     if(b == 0 || b == -1) return true;
+                     *r = a % b;
+                     return false;
+                   });
+        break;
+      case OpCode::Equal:
+        compare(Token::Type::EqualTo,
+                [](std::int64_t a, std::int64_t b) { return a == b; });
+        break;
+      case OpCode::NotEqual:
+        compare(Token::Type::NotEqualTo,
+                [](std::int64_t a, std::int64_t b) { return a != b; });
+        break;
+      case OpCode::Less:
+        compare(Token::Type::LessThan,
+                [](std::int64_t a, std::int64_t b) { return a < b; });
+        break;
+      case OpCode::LessEqual:
+        compare(Token::Type::LessThanOrEqualTo,
+                [](std::int64_t a, std::int64_t b) { return a <= b; });
+        break;
+      case OpCode::Greater:
+        compare(Token::Type::GreaterThan,
+                [](std::int64_t a, std::int64_t b) { return a > b; });
+        break;
+      case OpCode::GreaterEqual:
+        compare(Token::Type::GreaterThanOrEqualTo,
+                [](std::int64_t a, std::int64_t b) { return a >= b; });
+        break;
+      case OpCode::CheckBoolean: operators::logical(stack.back()); break;
+      case OpCode::ShortCircuit:
+        if(operators::logical(stack.back()) == (instruction.b != 0))
+          ip = frame->function->code.data() + instruction.a;
+        else
+          stack.pop_back();
+        break;
+      case OpCode::Jump: ip = frame->function->code.data() + instruction.a; break;
+      case OpCode::JumpIfFalse: {
+        const bool truth{operators::isTrue(stack.back())};
+        stack.pop_back();
+        if(!truth) ip = frame->function->code.data() + instruction.a;
+        break;
+      }
+      case OpCode::JumpIfTrue: {
+        const bool truth{operators::isTrue(stack.back())};
+        stack.pop_back();
+        if(truth) ip = frame->function->code.data() + instruction.a;
+        break;
+      }
+      case OpCode::JumpIfHolds:
+        if(holds(static_cast<OpCode>(instruction.b)))
+          ip = frame->function->code.data() + instruction.a;
+        break;
+      case OpCode::JumpUnless:
+        if(!holds(static_cast<OpCode>(instruction.b)))
+          ip = frame->function->code.data() + instruction.a;
+        break;
+      case OpCode::JumpIfPassed:
+        if(instruction.b < frame->argCount)
+          ip = frame->function->code.data() + instruction.a;
+        break;
+      case OpCode::Call:
+      case OpCode::TailCall: {
+        const std::size_t calleeIndex{stack.size() - instruction.a - 1};
+        const Value &callee{stack[calleeIndex]};
+        const ClosureCall *compiled{
+            callee.type() == Value::Type::Callable
+                ? callee.asCallable().procedure.target<ClosureCall>()
+                : nullptr};
+        if(compiled && compiled->machine == this) {
+          operators::checkArity(callee.asCallable(), instruction.a);
+          if(instruction.op == OpCode::Call) {
+            frame->ip = ip;
+            enter(*compiled, calleeIndex + 1, instruction.a);
+          } else {
+            // The callee and its arguments take the place of the running
+            // call, and its frame the place of the running frame.
+            const std::size_t base{frame->base};
+            std::move(stack.begin() + calleeIndex,
+                      stack.end(),
+                      stack.begin() + base - 1);
+            stack.resize(base + instruction.a);
+            frames.pop_back();
+            enter(*stack[base - 1].asCallable().procedure.target<ClosureCall>(),
+                  base,
+                  instruction.a);
+          }
+          frame = &frames.back();
+          ip = frame->ip;
+          break;
+        }
+        // Anything else may run this machine again, which can move the
+        // stacks, so nothing on them is referred to across the call. Tail
+        // calls to it return what it returns as usual.
+        const Value target{callee};
+        std::vector<Value> args(
+            std::make_move_iterator(stack.end() - instruction.a),
+            std::make_move_iterator(stack.end()));
+        std::optional<Value> returned{operators::call(target, args)};
+        if(!returned && !instruction.b)
+          throw std::runtime_error{"Expected a non-null value!"};
+        frame = &frames.back();
+        stack.resize(calleeIndex);
+        stack.push_back(returned ? std::move(returned.value()) : Value{});
+        break;
+      }
+      case OpCode::Closure:
+        stack.push_back(
+            closure(*frame, *frame->program->functions[instruction.a]));
+        break;
+      case OpCode::Prototype: {
+        Value prototype{};
+        interpreter.visit(
+            *frame->program->prototypes[instruction.a], global, prototype);
+        frame = &frames.back();
+        stack.push_back(std::move(prototype));
+        break;
+      }
+      case OpCode::GetProperty:
+        stack.back() = operators::get(stack.back(),
+                                      frame->function->names[instruction.a]);
+        break;
+      case OpCode::SetProperty:
+        operators::set(stack[stack.size() - 2],
+                       frame->function->names[instruction.a],
+                       stack.back());
+        stack.pop_back();
+        stack.back() = Value{};
+        break;
+      case OpCode::Return: {
+        Value returned{std::move(stack.back())};
+        // The callee (or its placeholder) is replaced by what it returned.
+        stack.resize(frame->base - 1);
+        stack.push_back(std::move(returned));
+        frames.pop_back();
+        if(frames.size() == exitDepth) return;
+        frame = &frames.back();
+        ip = frame->ip;
+        break;
+      }
+    }
+  }
+}
+
+Value VirtualMachine::closure(const Frame &frame,
+                              const Bytecode::Function &function) {
+  // Functions that capture nothing can share one closure.
+  if(function.captures.empty()) {
+    auto shared{closures.find(&function)};
+    if(shared != closures.end()) return shared->second;
+  }
+  auto cells{std::make_shared<Captures>()};
+  cells->reserve(function.captures.size());
+  for(const Bytecode::Capture &capture : function.captures)
+    cells->push_back(capture.fromRegister ? stack[frame.base + capture.index]
+                                          : (*frame.captures)[capture.index]);
+  const Value created{Callable{
+      function.minArity,
+      function.maxArity,
+      ClosureCall{this, frame.program, &function, std::move(cells)},
+      globals()->shared_from_this()}};
+  if(function.captures.empty()) closures.emplace(&function, created);
+  return created;
+}
@@ -0,0 +1,20 @@
+#include "fixture.hpp"
+
+namespace {
+// Runs a program compiled into closures and returns the value it left in the
+// global "result".
+Value run(const std::string &text) {
+  return fixture::runOn(fixture::Engine::Closures, text);
+}
+} // namespace
+
+TEST_SUITE("Closure compiler") {
+  TEST_CASE("Operands read in place see assignments in order.") {
+    CHECK(run("variable result = 0;\n"
+              "{ variable a = 1; result = a + (a = 5); }")
+              .asInteger() == 6);
+    CHECK(run("variable result = 0;\n"
+              "{ variable a = 3; variable b = 4; result = a * b - a; }")
+              .asInteger() == 9);
+  }
+}
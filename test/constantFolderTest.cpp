@@ -0,0 +1,117 @@
+#include "constantFolder.hpp"
+#include "fixture.hpp"
+
+namespace {
+std::vector<Statement::StatementUPtr> fold(const std::string &text) {
+  Interpreter interpreter{};
+  Parser parser{Scanner{text}.tokenize()};
+  std::vector<Statement::StatementUPtr> statements{parser.parse()};
+  ConstantFolder{interpreter.globals()}.rewrite(statements);
+  return statements;
+}
+
+// Folds a program and runs it on every engine, returning the value it left in
+// the global "result".
+Value run(const std::string &text) {
+  return fixture::run(
+      text,
+      {[](std::vector<Statement::StatementUPtr> &statements,
+          GlobalEnvironment *globals) {
+        ConstantFolder{globals}.rewrite(statements);
+      }});
+}
+
+// Gets the initializer of the variable declared by a statement.
+const Expression::Expression *initializer(
+    const Statement::StatementUPtr &statement) {
+  const auto *variable{
+      dynamic_cast<const Statement::Variable *>(statement.get())};
+  REQUIRE(variable);
+  return variable->initializer.get();
+}
+
+// Gets the value of the literal a variable is initialized to.
+Value literal(const Statement::StatementUPtr &statement) {
+  const auto *literal{
+      dynamic_cast<const Expression::Literal *>(initializer(statement))};
+  REQUIRE(literal);
+  return literal->value;
+}
+} // namespace
+
+TEST_SUITE("Constant folder") {
+  TEST_CASE("Operators on literals become literals.") {
+    CHECK(literal(fold("variable a = 1 + 2 * (3 - 1);")[0]).asInteger() == 5);
+    CHECK(literal(fold("variable a = \"a\" + \"b\" == \"ab\";")[0])
+              .asBoolean());
+    CHECK(literal(fold("variable a = -(7 / 2);")[0]).asNumber() == -3.5);
+    CHECK(literal(fold("variable a = 2 * PI;")[0]).asNumber() ==
+          2 * native::PI);
+  }
+
+  TEST_CASE("Known constants are propagated and variables are not.") {
+    const std::vector<Statement::StatementUPtr> statements{
+        fold("constant r = 2;\n"
+             "variable v = 3;\n"
+             "variable area = PI * r * r;\n"
+             "variable other = v * r;")};
+    CHECK(literal(statements[2]).asNumber() == native::PI * 2 * 2);
+    CHECK(dynamic_cast<const Expression::Binary *>(initializer(statements[3])));
+    CHECK(run("constant x = 1;\n"
+              "subroutine f(x) { return x + 1; }\n"
+              "variable result = f(5);")
+              .asInteger() == 6);
+    CHECK(run("constant x = 1;\n"
+              "variable result = 0;\n"
+              "{ variable x = 3; result = x * 10; }\n"
+              "result = result + x;")
+              .asInteger() == 31);
+  }
+
+  TEST_CASE("Names within prototypes may be inherited.") {
+    CHECK(run("constant size = 3;\n"
+              "prototype A { public: constant size = 5; }\n"
+              "prototype B from A {\n"
+              "  public: subroutine get() { return size; }\n"
+              "}\n"
+              "variable result = B().get();")
+              .asInteger() == 5);
+  }
+
+  TEST_CASE("Pure natives are called on known arguments.") {
+    CHECK(literal(fold("variable a = sqrt(16) + pow(2, 3);")[0]).asNumber() ==
+          12);
+    CHECK(literal(fold("variable a = max(abs(-3), 2);")[0]).asInteger() == 3);
+    CHECK(dynamic_cast<const Expression::Call *>(
+        initializer(fold("variable a = time();")[0])));
+    CHECK(run("subroutine sqrt(x) { return x; }\n"
+              "variable result = sqrt(16);")
+              .asInteger() == 16);
+  }
+
+  TEST_CASE("Known conditions choose their branch.") {
+    CHECK(literal(fold("variable a = 1 if 2 > 1 else 2;")[0]).asInteger() ==
+          1);
+    CHECK(dynamic_cast<const Expression::Call *>(
+        initializer(fold("variable a = time() if true else 2;")[0])));
+    CHECK(literal(fold("variable a = false and time();")[0]).asBoolean() ==
+          false);
+    CHECK(fold("if false { print(1); }\n"
+               "constant debug = false;\n"
+               "if debug { print(2); }")
+              .size() == 1);
+    CHECK(run("variable result = 0;\n"
+              "if 1 > 2 { result = 1; } else if true { result = 2; }")
+              .asInteger() == 2);
+  }
+
+  TEST_CASE("Operations that fail are left to fail when run.") {
+    CHECK(dynamic_cast<const Expression::Binary *>(
+        initializer(fold("variable a = 1 / 0;")[0])));
+    CHECK(dynamic_cast<const Expression::Logical *>(
+        initializer(fold("variable a = 1 and true;")[0])));
+    CHECK(dynamic_cast<const Expression::Call *>(
+        initializer(fold("variable a = sqrt(1, 2);")[0])));
+    CHECK(run("variable result = 1;\nresult = 1 / 0;").asInteger() == 1);
+  }
+}
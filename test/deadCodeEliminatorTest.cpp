@@ -0,0 +1,115 @@
+#include "deadCodeEliminator.hpp"
+#include "fixture.hpp"
+
+namespace {
+// Removes the dead code of a program and returns how many statements of each
+// kind were removed.
+std::vector<std::size_t> removed(const std::string &text) {
+  Parser parser{Scanner{text}.tokenize()};
+  std::vector<Statement::StatementUPtr> statements{parser.parse()};
+  DeadCodeEliminator eliminator{};
+  eliminator.rewrite(statements);
+  std::vector<std::size_t> counts{};
+  for(const DeadCodeEliminator::Removal &removal : eliminator.removals())
+    counts.push_back(removal.count);
+  return counts;
+}
+
+// Removes the dead code of a program and runs it on every engine, returning
+// the value it left in the global "result".
+Value run(const std::string &text) {
+  return fixture::run(
+      text,
+      {[](std::vector<Statement::StatementUPtr> &statements,
+          GlobalEnvironment *) { DeadCodeEliminator{}.rewrite(statements); }});
+}
+
+using Counts = std::vector<std::size_t>;
+} // namespace
+
+TEST_SUITE("Dead code eliminator") {
+  TEST_CASE("Statements after a return are removed.") {
+    CHECK(removed("subroutine f() { return; print(1); print(2); }") ==
+          Counts{2, 0, 0, 0});
+    CHECK(removed("subroutine f(c) {\n"
+                  "  if c { return 1; } else { return 2; }\n"
+                  "  print(3);\n"
+                  "}") == Counts{1, 0, 0, 0});
+    CHECK(removed("subroutine f(c) {\n"
+                  "  if c { return 1; }\n"
+                  "  return 2;\n"
+                  "}") == Counts{0, 0, 0, 0});
+    CHECK(run("subroutine f(c) {\n"
+              "  if c { return 1; }\n"
+              "  return 2;\n"
+              "  return 3;\n"
+              "}\n"
+              "variable result = f(false);")
+              .asInteger() == 2);
+  }
+
+  TEST_CASE("Locals that are never read are removed.") {
+    CHECK(removed("subroutine f() {\n"
+                  "  variable unused = 1;\n"
+                  "  variable helper = lambda() { return 2; };\n"
+                  "  return 3;\n"
+                  "}") == Counts{0, 2, 0, 0});
+    CHECK(run("variable result = 0;\n"
+              "subroutine count() { result = result + 1; return result; }\n"
+              "subroutine f() { variable unused = count(); unused = count(); }\n"
+              "f();")
+              .asInteger() == 2);
+    CHECK(removed("variable unused = 1;\n"
+                  "subroutine f(x) { variable y = x; return y; }") ==
+          Counts{0, 0, 0, 0});
+    CHECK(removed("subroutine f() { constant c = 1; c = 2; }") ==
+          Counts{0, 0, 0, 0});
+    CHECK(run("variable result = 1;\n"
+              "{ variable result = 2; result = 3; }")
+              .asInteger() == 1);
+  }
+
+  TEST_CASE("Locals given values by calls are kept.") {
+    CHECK(removed("subroutine f() { variable s = print(1); return 1; }") ==
+          Counts{0, 0, 0, 0});
+    CHECK(removed("subroutine f(c) { variable s = (print(1) if c else 2); }") ==
+          Counts{0, 0, 0, 0});
+    CHECK(run("variable result = 1;\n"
+              "subroutine f() { variable s = print(\"kept\"); return 2; }\n"
+              "result = f();")
+              .asInteger() == 1);
+    CHECK(removed("subroutine f() { variable t = 1; t = print(1); }") ==
+          Counts{0, 0, 0, 0});
+    CHECK(run("variable result = 1;\n"
+              "subroutine c() { variable t = 1; t = print(\"t\"); return 3; }\n"
+              "result = c();")
+              .asInteger() == 1);
+  }
+
+  TEST_CASE("Loops that never run keep only their initializer.") {
+    CHECK(removed("while false { print(1); }") == Counts{0, 0, 1, 0});
+    CHECK(removed("for i = 0; false; i = i + 1 { print(i); }") ==
+          Counts{0, 0, 1, 0});
+    CHECK(removed("variable go = false;\nwhile go { print(1); }") ==
+          Counts{0, 0, 0, 0});
+  }
+
+  TEST_CASE("Private subroutines that are never mentioned are removed.") {
+    CHECK(removed("prototype P {\n"
+                  "public:\n"
+                  "  subroutine used() { return helper(); }\n"
+                  "private:\n"
+                  "  subroutine helper() { return 1; }\n"
+                  "  subroutine unused() { return 2; }\n"
+                  "}") == Counts{0, 0, 0, 1});
+    CHECK(run("prototype P {\n"
+              "public:\n"
+              "  subroutine used() { return helper(); }\n"
+              "private:\n"
+              "  subroutine helper() { return 1; }\n"
+              "  subroutine unused() { return 2; }\n"
+              "}\n"
+              "variable result = P().used();")
+              .asInteger() == 1);
+  }
+}
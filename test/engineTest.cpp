@@ -0,0 +1,222 @@
+#include "fixture.hpp"
+
+using fixture::run;
+
+TEST_SUITE("Engines") {
+  TEST_CASE("Integral literals and arithmetic stay integers.") {
+    CHECK(run("variable result = 2 + 3 * 4 - 1;").asInteger() == 13);
+    CHECK(run("variable result = 7 mod 3;").asInteger() == 1);
+    CHECK(run("variable result = -7 mod 3;").asInteger() == -1);
+    CHECK(run("variable result = 12 / 4;").asInteger() == 3);
+    CHECK(run("variable result = 0;\n"
+              "for i = 0; i < 10; i = i + 1 { result = result + i; }")
+              .asInteger() == 45);
+    CHECK(run("variable result = round(2.5);").asInteger() == 3);
+  }
+
+  TEST_CASE("Integers become numbers when they overflow or are inexact.") {
+    const Value half{run("variable result = 7 / 2;")};
+    CHECK(half.type() == Value::Type::Number);
+    CHECK(half.asNumber() == 3.5);
+    CHECK(run("variable result = 1 + 0.5;").asNumber() == 1.5);
+    const Value big{run("variable result = 9223372036854775807 + 1;")};
+    CHECK(big.type() == Value::Type::Number);
+    CHECK(big.asNumber() == 9223372036854775808.0L);
+    CHECK(run("variable result = 4294967296 * 4294967296;").type() ==
+          Value::Type::Number);
+    CHECK(run("variable result = 99999999999999999999;").type() ==
+          Value::Type::Number);
+  }
+
+  TEST_CASE("Integers compare with numbers.") {
+    CHECK(run("variable result = 1 == 1.0;").asBoolean());
+    CHECK(run("variable result = 2 < 2.5;").asBoolean());
+    CHECK_FALSE(run("variable result = 3 <= 2.5;").asBoolean());
+    CHECK(run("variable result = \"a\" + \"b\" == \"ab\";").asBoolean());
+    CHECK_FALSE(run("variable result = !(1 < 2);").asBoolean());
+  }
+
+  TEST_CASE("Blocks nest and loops repeat.") {
+    CHECK(run("variable result = 0;\n"
+              "{ variable a = 2; { variable b = 3; result = a * b; } }")
+              .asInteger() == 6);
+    CHECK(run("variable result = 0;\n"
+              "while result < 5 { result = result + 1; }")
+              .asInteger() == 5);
+  }
+
+  TEST_CASE("Strings built in loops keep every piece.") {
+    const Value built{run("variable result = \"\";\n"
+                          "for i = 0; i < 1000; i = i + 1 {\n"
+                          "  result = result + \"line\" + \",\";\n"
+                          "}")};
+    CHECK(built.asString().length() == 5000);
+    CHECK(built.asString().text().substr(0, 10) == "line,line,");
+  }
+
+  TEST_CASE("Results pass through groups, ternaries and calls.") {
+    CHECK(run("variable result = -(2 * (3 + 4));").asInteger() == -14);
+    CHECK(run("variable result = (1 if 2 < 1 else (3 if true else 4)) + 1;")
+              .asInteger() == 4);
+    CHECK(run("subroutine twice(x) { return x * 2; }\n"
+              "variable result = twice(twice(3)) + twice(1);")
+              .asInteger() == 14);
+    CHECK(run("variable result = 0;\n"
+              "variable other = result = 5;")
+              .asInteger() == 5);
+  }
+
+  TEST_CASE("Returns complete through loops, scopes and nested calls.") {
+    CHECK(run("subroutine fib(n) {\n"
+              "  if n <= 1 { return n; }\n"
+              "  return fib(n - 2) + fib(n - 1);\n"
+              "}\n"
+              "variable result = fib(15);")
+              .asInteger() == 610);
+    CHECK(run("subroutine find(limit) {\n"
+              "  for i = 0; i < limit; i = i + 1 {\n"
+              "    { if i * i > 50 { return i; } }\n"
+              "  }\n"
+              "  return -1;\n"
+              "}\n"
+              "variable result = find(100) * 10 + find(3);")
+              .asInteger() == 79);
+    CHECK(run("subroutine nothing() { return; }\n"
+              "subroutine after() { nothing(); return 2; }\n"
+              "variable result = after();")
+              .asInteger() == 2);
+    CHECK(run("subroutine nothing() { return; }\n"
+              "variable result = nothing();")
+              .type() == Value::Type::Nil);
+  }
+
+  TEST_CASE("Subroutines take default parameters and capture variables.") {
+    CHECK(run("subroutine add(a, b = 10, c = a + b) { return a + b + c; }\n"
+              "variable result = add(1) * 100 + add(1, 2);")
+              .asInteger() == 2206);
+    CHECK(run("subroutine counter() {\n"
+              "  variable count = 0;\n"
+              "  return lambda() { count = count + 1; return count; };\n"
+              "}\n"
+              "variable next = counter();\n"
+              "next(); next();\n"
+              "variable result = next();")
+              .asInteger() == 3);
+    CHECK(run("subroutine outer(x) {\n"
+              "  return lambda(y) { return lambda() { return x + y; }; };\n"
+              "}\n"
+              "variable result = outer(1)(2)();")
+              .asInteger() == 3);
+  }
+
+  TEST_CASE("Prototypes are shared with the tree walker.") {
+    CHECK(run("prototype Box {\n"
+              "constructor(v) { value = v; }\n"
+              "public:\n"
+              "  subroutine get() { return value; }\n"
+              "  variable value;\n"
+              "}\n"
+              "subroutine make(v) { return Box(v); }\n"
+              "variable result = make(4).get() + Box(5).value;")
+              .asInteger() == 9);
+  }
+
+  TEST_CASE("Calls whose value is used must return one.") {
+    CHECK(run("variable result = 1;\n"
+              "subroutine f() { variable s = print(\"x\"); return s; }\n"
+              "result = f();")
+              .asInteger() == 1);
+    CHECK(run("variable result = 1;\n"
+              "print(\"y\");\n"
+              "result = 2;")
+              .asInteger() == 2);
+  }
+
+  TEST_CASE("Globals are undefined until their declaration runs.") {
+    CHECK(run("variable result = 1;\n"
+              "subroutine f() { return later; }\n"
+              "result = f();\n"
+              "variable later = 9;")
+              .asInteger() == 1);
+    CHECK(run("variable result = 1;\n"
+              "subroutine f() { return later + 1; }\n"
+              "result = f();\n"
+              "variable later = 1;")
+              .asInteger() == 1);
+    CHECK(run("variable result = 1;\n"
+              "subroutine s() { later = 5; }\n"
+              "s();\n"
+              "result = 2;\n"
+              "variable later = 1;")
+              .asInteger() == 1);
+    CHECK(run("subroutine f() { return later; }\n"
+              "variable later = 9;\n"
+              "variable result = f();")
+              .asInteger() == 9);
+  }
+
+  TEST_CASE("Logical operators short-circuit and test boolean operands.") {
+    const std::string counted{
+        "variable result = 0;\n"
+        "subroutine touch() { result = result + 1; return true; }\n"};
+    CHECK(run(counted + "variable unused = false and touch();").asInteger() ==
+          0);
+    CHECK(run(counted + "if true or touch() { result = result + 10; }")
+              .asInteger() == 10);
+    CHECK(run(counted +
+              "if touch() and (1 < 2 or touch()) { result = result + 10; }")
+              .asInteger() == 11);
+    CHECK(run(counted + "for i = 0; i < 3 and touch(); i = i + 1 {}")
+              .asInteger() == 3);
+    CHECK(run(counted +
+              "result = 5 if !(touch() and false) or touch() else 7;")
+              .asInteger() == 5);
+    CHECK(run("variable result = 1;\nresult = 2 and true;").asInteger() == 1);
+    CHECK(run("variable result = 1;\nif 2 or true { result = 2; }")
+              .asInteger() == 1);
+  }
+
+  TEST_CASE("Operators fall back on operands of other types.") {
+    CHECK(run("subroutine add(a, b) { return a + b; }\n"
+              "variable text = add(\"a\", \"b\");\n"
+              "variable result = add(1, 2) * 10 + add(0.5, 0.5);")
+              .asNumber() == 31.0);
+    CHECK(run("subroutine negate(x) { return -x; }\n"
+              "variable result = negate(2) + negate(0.5);")
+              .asNumber() == -2.5);
+    CHECK(run("subroutine less(a, b) { return a < b; }\n"
+              "variable result = less(1, 2) and less(1.5, 2) and "
+              "less(\"a\", \"b\") and !less(3, 2);")
+              .asBoolean());
+  }
+
+  TEST_CASE("Tail calls run in place of their caller.") {
+    CHECK(run("subroutine count(n, total) {\n"
+              "  return total if n == 0 else count(n - 1, total + 1);\n"
+              "}\n"
+              "variable result = count(1000000, 0);")
+              .asInteger() == 1000000);
+    CHECK(run("subroutine isEven(n) { if n == 0 { return true; }\n"
+              "  return isOdd(n - 1); }\n"
+              "subroutine isOdd(n) { if n == 0 { return false; }\n"
+              "  return (isEven(n - 1)); }\n"
+              "variable result = isEven(1000001);")
+              .asBoolean() == false);
+    CHECK(run("subroutine last(n) {\n"
+              "  return round(n) if n < 1 else last(n - 1);\n"
+              "}\n"
+              "variable result = last(100000.5);")
+              .asInteger() == 1);
+  }
+
+  TEST_CASE("Deep recursion is bounded by the maximum depth.") {
+    const std::string sum{"subroutine sum(n) {\n"
+                          "  if n == 0 { return 0; }\n"
+                          "  return n + sum(n - 1);\n"
+                          "}\n"};
+    CHECK(run(sum + "variable result = sum(30000);").asInteger() == 450015000);
+    CHECK(run(sum + "variable result = 0;\nresult = sum(100);", {}, 50)
+              .asInteger() == 0);
+    CHECK(run(sum + "variable result = sum(50);", {}, 51).asInteger() == 1275);
+  }
+}
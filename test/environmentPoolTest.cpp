@@ -0,0 +1,36 @@
+#include "environment.hpp"
+#include "doctest.h"
+
+TEST_SUITE("EnvironmentPool") {
+  TEST_CASE("Freed blocks are reused within their size class.") {
+    EnvironmentPool pool{};
+    void *first{pool.allocate(40)};
+    pool.deallocate(first, 40);
+    CHECK(pool.allocate(48) == first);
+    CHECK(pool.stats().reused == 1);
+    CHECK(pool.allocate(40) != first);
+    CHECK(pool.stats().chunks == 1);
+  }
+
+  TEST_CASE("Oversized blocks bypass the size classes.") {
+    EnvironmentPool pool{};
+    void *block{pool.allocate(4096)};
+    CHECK(pool.stats().oversized == 1);
+    CHECK(pool.stats().chunks == 0);
+    pool.deallocate(block, 4096);
+  }
+
+  TEST_CASE("Pooled environments return their slots.") {
+    EnvironmentPool pool{};
+    for(int i{0}; i < 3; i++) {
+      std::shared_ptr<Environment> env{std::allocate_shared<Environment>(
+          PoolAllocator<Environment>{&pool}, nullptr, 10, &pool)};
+      env->defineAt(9, std::string{"value"});
+      CHECK(env->getAt(0, 9).asString().text() == "value");
+      Environment frame{env.get(), 10, &pool};
+      frame.defineAt(0, 1.0L);
+    }
+    // Only the first iteration needs fresh blocks.
+    CHECK(pool.stats().allocations - pool.stats().reused == 3);
+  }
+}
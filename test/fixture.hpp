@@ -0,0 +1,63 @@
+#pragma once
+
+#include "interpreter.hpp"
+#include "parser.hpp"
+#include "resolver.hpp"
+#include "scanner.hpp"
+#include "virtualMachine.hpp"
+#include "doctest.h"
+#include <functional>
+
+namespace fixture {
+// The engines a program can be run on.
+enum class Engine { Walk, Closures, Machine };
+
+// Rewrites a parsed program, whose globals are given, before it is resolved.
+using Pass = std::function<void(std::vector<Statement::StatementUPtr> &,
+                                GlobalEnvironment *)>;
+
+// Runs a program on an engine after the given passes, and returns the value it
+// left in the global "result". The engine's own maximum depth is kept unless
+// one is given.
+inline Value runOn(const Engine engine,
+                   const std::string &text,
+                   const std::vector<Pass> &passes = {},
+                   const std::optional<std::size_t> maxDepth = {}) {
+  Parser parser{Scanner{text}.tokenize()};
+  std::vector<Statement::StatementUPtr> statements{parser.parse()};
+  const Token result{"result", Token::Type::Identifier};
+  if(engine == Engine::Machine) {
+    VirtualMachine machine{};
+    if(maxDepth) machine.setMaxDepth(maxDepth.value());
+    for(const Pass &pass : passes) pass(statements, machine.globals());
+    Resolver{machine.globals()}.resolve(statements);
+    machine.interpret(statements);
+    return machine.globals()->get(result);
+  }
+  Interpreter interpreter{engine == Engine::Closures
+                              ? Interpreter::Mode::Closures
+                              : Interpreter::Mode::Walk};
+  if(maxDepth) interpreter.setMaxDepth(maxDepth.value());
+  for(const Pass &pass : passes) pass(statements, interpreter.globals());
+  Resolver{interpreter.globals()}.resolve(statements);
+  interpreter.interpret(statements);
+  return interpreter.globals()->get(result);
+}
+
+// Runs a program on every engine after the given passes, checking that they
+// agree, and returns the value it left in the global "result".
+inline Value run(const std::string &text,
+                 const std::vector<Pass> &passes = {},
+                 const std::optional<std::size_t> maxDepth = {}) {
+  const Value walked{runOn(Engine::Walk, text, passes, maxDepth)};
+  for(const Engine engine : {Engine::Closures, Engine::Machine}) {
+    const Value result{runOn(engine, text, passes, maxDepth)};
+    CHECK(result.type() == walked.type());
+    // Nil values only compare by their type.
+    if(walked.type() != Value::Type::Nil)
+      CHECK(operators::isTrue(
+          operators::binary(result, Token::Type::EqualTo, walked)));
+  }
+  return walked;
+}
+} // namespace fixture
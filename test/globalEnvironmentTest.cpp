@@ -0,0 +1,49 @@
+#include "globalEnvironment.hpp"
+#include "doctest.h"
+
+TEST_SUITE("GlobalEnvironment") {
+  TEST_CASE("Globals keep their slots as more are declared.") {
+    GlobalEnvironment globals{};
+    for(int i{0}; i < 100; i++) {
+      const Token name{
+          "global" + std::to_string(i), Token::Type::Identifier, false};
+      globals.define(name, static_cast<long double>(i));
+      CHECK(globals.slot(name).value() == i);
+    }
+    const Token fifty{"global50", Token::Type::Identifier, false};
+    CHECK(globals.getAt(0, 50).asNumber() == 50);
+    CHECK(globals.get(fifty).asNumber() == 50);
+    globals.assign(fifty, 5.0L);
+    CHECK(globals.getAt(0, 50).asNumber() == 5);
+    CHECK(globals.declare(fifty) == 50);
+    CHECK(globals.size() == 100);
+  }
+
+  TEST_CASE("Constants and undefined globals are rejected by name.") {
+    GlobalEnvironment globals{};
+    const Token constant{"constantGlobal", Token::Type::Identifier, true};
+    globals.define(constant, 1.0L);
+    CHECK_THROWS(globals.assign(constant, 2.0L));
+    CHECK_THROWS(globals.get(Token{"missingGlobal", Token::Type::Identifier}));
+    CHECK_FALSE(
+        globals.declaration(Token{"missingGlobal", Token::Type::Identifier}));
+  }
+
+  TEST_CASE("Lookups by name report failures without throwing.") {
+    const auto globals{std::make_shared<GlobalEnvironment>()};
+    const Token constant{"constantGlobal", Token::Type::Identifier, true};
+    const Token missing{"missingGlobal", Token::Type::Identifier};
+    globals->define(constant, 1.0L);
+    CHECK(globals->tryAssign(constant, 2.0L) ==
+          Environment::AssignStatus::Constant);
+    CHECK(globals->tryAssign(missing, 2.0L) ==
+          Environment::AssignStatus::Undefined);
+    CHECK_FALSE(globals->find(missing));
+    CHECK(globals->find(constant)->asNumber() == 1);
+    // Environments found by name fall back to the globals they are within.
+    Environment scope{globals};
+    CHECK(scope.tryAssign(missing, 2.0L) ==
+          Environment::AssignStatus::Undefined);
+    CHECK(scope.find(constant)->asNumber() == 1);
+  }
+}
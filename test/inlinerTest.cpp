@@ -0,0 +1,117 @@
+#include "fixture.hpp"
+#include "inliner.hpp"
+
+namespace {
+// Inlines the calls of a program and returns the subroutines whose calls were.
+std::vector<std::string> inlined(const std::string &text,
+                                 const std::size_t budget = 16) {
+  Parser parser{Scanner{text}.tokenize()};
+  std::vector<Statement::StatementUPtr> statements{parser.parse()};
+  Inliner inliner{budget};
+  inliner.rewrite(statements);
+  std::vector<std::string> subroutines{};
+  for(const Inliner::Inline &call : inliner.inlines())
+    subroutines.push_back(call.subroutine);
+  return subroutines;
+}
+
+// Inlines the calls of a program and runs it on every engine, returning the
+// value it left in the global "result".
+Value run(const std::string &text) {
+  return fixture::run(
+      text,
+      {[](std::vector<Statement::StatementUPtr> &statements,
+          GlobalEnvironment *) { Inliner{}.rewrite(statements); }});
+}
+} // namespace
+
+TEST_SUITE("Inliner") {
+  TEST_CASE("Calls to small subroutines are inlined.") {
+    const std::string square{"subroutine square(x) { return x * x; }\n"};
+    CHECK(inlined(square + "variable a = 3;\n"
+                           "variable result = square(a) + square(2);") ==
+          std::vector<std::string>{"square", "square"});
+    CHECK(run(square + "variable a = 3;\n"
+                       "variable result = square(a) + square(2);")
+              .asInteger() == 13);
+    CHECK(inlined("subroutine half(x) { return x / 2; }\n"
+                  "variable result = half(3 + 5);") ==
+          std::vector<std::string>{"half"});
+    CHECK(inlined("subroutine quad(x) { return square(x) * square(x); }\n"
+                  "subroutine square(x) { return x * x; }\n"
+                  "variable result = quad(2);")
+              .empty());
+    CHECK(inlined(square + "subroutine next(x) { return square(x) + 1; }\n"
+                           "variable result = next(2);") ==
+          std::vector<std::string>{"square", "next"});
+  }
+
+  TEST_CASE("Defaults stand in for missing arguments.") {
+    const std::string scale{
+        "subroutine scale(x, by = 2) { return x * by; }\n"};
+    CHECK(inlined(scale + "variable result = scale(3) + scale(3, 4);") ==
+          std::vector<std::string>{"scale", "scale"});
+    CHECK(run(scale + "variable result = scale(3) + scale(3, 4);")
+              .asInteger() == 18);
+    CHECK(inlined("variable k = 2;\n"
+                  "subroutine scale(x, by = k) { return x * by; }\n"
+                  "variable result = scale(3);")
+              .empty());
+    CHECK(inlined(scale + "variable result = scale();").empty());
+  }
+
+  TEST_CASE("Calls that inlining might change are left as they are.") {
+    CHECK(inlined("subroutine f(n) { return f(n - 1) if n > 0 else 0; }\n"
+                  "variable result = f(3);")
+              .empty());
+    CHECK(inlined("subroutine f(x) { return x; }\n"
+                  "subroutine g(x) { return x + 1; }\n"
+                  "f = g;\n"
+                  "variable result = f(3);")
+              .empty());
+    CHECK(inlined("subroutine f(x) { print(x); return x; }\n"
+                  "variable result = f(3);")
+              .empty());
+    CHECK(inlined("subroutine f(x) { return x + 1 + 2; }\n"
+                  "variable result = f(3);",
+                  3)
+              .empty());
+    CHECK(run("variable k = 1;\n"
+              "subroutine f(x) { return x + k; }\n"
+              "subroutine g(k) { return f(k * 10); }\n"
+              "variable result = g(5);")
+              .asInteger() == 51);
+    CHECK(inlined("variable k = 1;\n"
+                  "subroutine f(x) { return x + k; }\n"
+                  "subroutine g(k) { return f(k * 10); }")
+              .empty());
+    const std::string later{"subroutine f() { return V + 1; }\n"
+                            "variable flag = time() < 0;\n"
+                            "if flag { print(f()); }\n"
+                            "variable V = 5;\n"};
+    CHECK(inlined(later + "variable result = f();") ==
+          std::vector<std::string>{"f"});
+    CHECK(run(later + "variable result = f();").asInteger() == 6);
+  }
+
+  TEST_CASE("Arguments are evaluated once and in order.") {
+    CHECK(inlined("subroutine square(x) { return x * x; }\n"
+                  "variable a = 3;\n"
+                  "variable result = square(a + 1);")
+              .empty());
+    CHECK(inlined("subroutine minus(a, b) { return b - a; }\n"
+                  "variable result = minus(1 + 1, 2 + 2);")
+              .empty());
+    CHECK(inlined("subroutine minus(a, b) { return a - b; }\n"
+                  "variable result = minus(1 + 1, 2 + 2);") ==
+          std::vector<std::string>{"minus"});
+    CHECK(inlined("subroutine pick(c, x) { return x if c else 0; }\n"
+                  "variable result = pick(false, 1 / 0);")
+              .empty());
+    CHECK(run("variable counter = 0;\n"
+              "subroutine count() { counter = counter + 1; return counter; }\n"
+              "subroutine twice(x) { return x + x; }\n"
+              "variable result = twice(count());")
+              .asInteger() == 2);
+  }
+}
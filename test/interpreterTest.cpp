@@ -0,0 +1,27 @@
+#include "interpreter.hpp"
+#include "parser.hpp"
+#include "resolver.hpp"
+#include "scanner.hpp"
+#include "doctest.h"
+
+TEST_SUITE("Interpreter") {
+  TEST_CASE("Operators specialize to their operands and fall back after.") {
+    Interpreter interpreter{};
+    Parser parser{Scanner{"variable sum = 1 + 2;\n"
+                          "variable mismatched = true + 1;"}
+                      .tokenize()};
+    const std::vector<Statement::StatementUPtr> statements{parser.parse()};
+    Resolver{interpreter.globals()}.resolve(statements);
+    interpreter.interpret(statements);
+    const auto stateOf{[&](const std::size_t index) {
+      const auto *variable{
+          dynamic_cast<const Statement::Variable *>(statements[index].get())};
+      return dynamic_cast<const Expression::Binary *>(
+                 variable->initializer.get())
+          ->specialization.state;
+    }};
+    using State = Expression::Specialization<operators::BinaryOperation>::State;
+    CHECK(stateOf(0) == State::Specialized);
+    CHECK(stateOf(1) == State::Generic);
+  }
+}
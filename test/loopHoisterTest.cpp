@@ -0,0 +1,94 @@
+#include "fixture.hpp"
+#include "loopHoister.hpp"
+
+namespace {
+// Hoists the loops of a program and returns the expressions that were.
+std::vector<std::string> hoist(const std::string &text) {
+  Parser parser{Scanner{text}.tokenize()};
+  std::vector<Statement::StatementUPtr> statements{parser.parse()};
+  LoopHoister hoister{};
+  hoister.rewrite(statements);
+  std::vector<std::string> hoisted{};
+  for(const LoopHoister::Hoist &hoist : hoister.hoists())
+    hoisted.push_back(hoist.expression);
+  return hoisted;
+}
+
+// Hoists the loops of a program and runs it on every engine, returning the
+// value it left in the global "result".
+Value run(const std::string &text) {
+  return fixture::run(
+      text,
+      {[](std::vector<Statement::StatementUPtr> &statements,
+          GlobalEnvironment *) { LoopHoister{}.rewrite(statements); }});
+}
+} // namespace
+
+TEST_SUITE("Loop hoister") {
+  TEST_CASE("Invariant parts of loop conditions are hoisted.") {
+    CHECK(hoist("variable n = 3;\n"
+                "variable i = 0;\n"
+                "while i < n * n { i = i + 1; }") ==
+          std::vector<std::string>{"n * n"});
+    CHECK(hoist("variable x = 9;\n"
+                "for i = 0; i < sqrt(x) + 1; i = i + 1 {}") ==
+          std::vector<std::string>{"sqrt(x) + 1"});
+    CHECK(hoist("prototype P { public: variable size = 3; }\n"
+                "variable p = P();\n"
+                "variable i = 0;\n"
+                "while i < p.size { i = i + 1; }") ==
+          std::vector<std::string>{"p.size"});
+    CHECK(run("variable n = 3;\n"
+              "variable result = 0;\n"
+              "while result < n * n { result = result + 1; }")
+              .asInteger() == 9);
+  }
+
+  TEST_CASE("Expressions whose inputs the loop writes stay in it.") {
+    CHECK(hoist("variable n = 3;\n"
+                "variable i = 0;\n"
+                "while i < n * n { n = n - 1; i = i + 1; }")
+              .empty());
+    CHECK(hoist("prototype P { public: variable size = 3; }\n"
+                "variable p = P();\n"
+                "while p.size > 0 { p.size = p.size - 1; }")
+              .empty());
+    CHECK(hoist("variable n = 3;\n"
+                "subroutine shrink() { n = n - 1; }\n"
+                "variable i = 0;\n"
+                "while i < n * n { shrink(); i = i + 1; }")
+              .empty());
+    CHECK(hoist("subroutine sqrt(x) { return x; }\n"
+                "variable i = 0;\n"
+                "while i < sqrt(4) { i = i + 1; }")
+              .empty());
+    CHECK(run("variable n = 4;\n"
+              "subroutine shrink() { n = n - 1; }\n"
+              "variable result = 0;\n"
+              "while result < n * n { shrink(); result = result + 1; }")
+              .asInteger() == 3);
+  }
+
+  TEST_CASE("Only what every check evaluates is hoisted.") {
+    CHECK(hoist("variable n = 3;\n"
+                "variable i = 0;\n"
+                "while i < 3 and i < n * n { i = i + 1; }")
+              .empty());
+    CHECK(hoist("variable n = 3;\n"
+                "variable i = 0;\n"
+                "while i < time() + n * n { i = i + 1; }")
+              .empty());
+    CHECK(run("variable n = 0;\n"
+              "variable result = 0;\n"
+              "for i = 0; i < 3 / n; i = i + 1 {\n"
+              "  result = result + 1;\n"
+              "}")
+              .asInteger() == 0);
+    CHECK(run("variable result = 0;\n"
+              "variable n = 2;\n"
+              "for i = n * 2; i < n * n; i = i + 1 {\n"
+              "  result = result + 1;\n"
+              "}")
+              .asInteger() == 0);
+  }
+}
@@ -0,0 +1,110 @@
+#include "persistentMap.hpp"
+#include "doctest.h"
+
+// Sends every key to the same hash so the collision lists get exercised.
+struct CollidingHash {
+  std::size_t operator()(const int key) const noexcept {
+    return 42;
+  }
+};
+
+TEST_SUITE("PersistentMap") {
+  TEST_CASE("Inserted values can be found.") {
+    PersistentMap<int, int> map{};
+    for(int i{0}; i < 5000; i++) map = map.insert(i, i * 2);
+    CHECK(map.size() == 5000);
+    for(int i{0}; i < 5000; i++) CHECK(map.get(i) == i * 2);
+    CHECK_FALSE(map.get(5000).has_value());
+    CHECK_FALSE(static_cast<bool>(map.getEntry(5000)));
+  }
+
+  TEST_CASE("Insertions do not change older maps.") {
+    PersistentMap<int, int> older{};
+    for(int i{0}; i < 100; i++) older = older.insert(i, i);
+    PersistentMap<int, int> newer{older.insert(100, 100).insert(5, 50)};
+    CHECK(older.size() == 100);
+    CHECK_FALSE(older.get(100).has_value());
+    CHECK(older.get(5) == 5);
+    CHECK(newer.size() == 101);
+    CHECK(newer.get(100) == 100);
+    CHECK(newer.get(5) == 50);
+  }
+
+  TEST_CASE("Assignments are shared between maps holding the entry.") {
+    PersistentMap<int, int> older{PersistentMap<int, int>{}.insert(1, 1)};
+    PersistentMap<int, int> newer{older.insert(2, 2)};
+    REQUIRE(newer.assign(1, 10).has_value());
+    CHECK(older.get(1) == 10);
+    CHECK_FALSE(newer.assign(3, 3).has_value());
+  }
+
+  TEST_CASE("Colliding hashes are kept apart.") {
+    PersistentMap<int, int, CollidingHash> map{};
+    for(int i{0}; i < 10; i++) map = map.insert(i, i);
+    map = map.insert(3, 30);
+    CHECK(map.size() == 10);
+    CHECK(map.get(3) == 30);
+    CHECK(map.get(9) == 9);
+    CHECK_FALSE(map.get(10).has_value());
+  }
+
+  TEST_CASE("Copying over creates new entries.") {
+    PersistentMap<int, int> original{PersistentMap<int, int>{}.insert(1, 1)};
+    PersistentMap<int, int> copy{PersistentMap<int, int>{}.copyOver(original)};
+    REQUIRE(copy.assign(1, 2).has_value());
+    CHECK(original.get(1) == 1);
+    CHECK(copy.get(1) == 2);
+    PersistentMap<int, int> large{};
+    for(int i{0}; i < 1000; i++) large = large.insert(i, i);
+    PersistentMap<int, int> cloned{PersistentMap<int, int>{}.copyOver(large)};
+    PersistentMap<int, int> merged{copy.copyOver(large)};
+    REQUIRE(cloned.assign(500, -1).has_value());
+    REQUIRE(merged.assign(500, -2).has_value());
+    CHECK(large.get(500) == 500);
+    CHECK(cloned.get(500) == -1);
+    CHECK(cloned.size() == 1000);
+    CHECK(merged.get(1) == 1);
+    CHECK(merged.size() == 1000);
+  }
+
+  TEST_CASE("Unions share entries and prefer earlier maps.") {
+    PersistentMap<int, int> first{PersistentMap<int, int>{}.insert(1, 1)};
+    PersistentMap<int, int> second{
+        PersistentMap<int, int>{}.insert(1, 100).insert(2, 2)};
+    PersistentMap<int, int> both{
+        PersistentMap<int, int>::unionize({first, second})};
+    CHECK(both.size() == 2);
+    CHECK(both.get(1) == 1);
+    REQUIRE(both.assign(2, 20).has_value());
+    CHECK(second.get(2) == 20);
+  }
+
+  TEST_CASE("Builders leave the maps they start from and return untouched.") {
+    PersistentMap<int, int> start{};
+    for(int i{0}; i < 100; i++) start = start.insert(i, i);
+    PersistentMap<int, int>::Builder builder{start};
+    for(int i{50}; i < 1000; i++) builder.insert(i, -i);
+    PersistentMap<int, int> built{builder.build()};
+    builder.insert(0, 7);
+    builder.insert(2000, 7);
+    CHECK(start.size() == 100);
+    CHECK(start.get(60) == 60);
+    CHECK(built.size() == 1000);
+    CHECK(built.get(10) == 10);
+    CHECK(built.get(60) == -60);
+    CHECK(built.get(0) == 0);
+    CHECK_FALSE(built.get(2000).has_value());
+    PersistentMap<int, int> rebuilt{builder.build()};
+    CHECK(rebuilt.size() == 1001);
+    CHECK(rebuilt.get(0) == 7);
+  }
+
+  TEST_CASE("Builders keep colliding hashes apart.") {
+    PersistentMap<int, int, CollidingHash>::Builder builder{};
+    for(int i{0}; i < 10; i++) builder.insert(i, i);
+    PersistentMap<int, int, CollidingHash> map{builder.build()};
+    CHECK(map.size() == 10);
+    for(int i{0}; i < 10; i++) CHECK(map.get(i) == i);
+    CHECK(map.copyOver(map).size() == 10);
+  }
+}
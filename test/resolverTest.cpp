@@ -0,0 +1,191 @@
+#include "interpreter.hpp"
+#include "parser.hpp"
+#include "resolver.hpp"
+#include "scanner.hpp"
+#include "doctest.h"
+
+namespace {
+// Collects reported messages instead of printing them.
+class RecordingReporter : public ErrorReporter {
+  public:
+  void report(const Token &token, const std::string &msg) override {
+    messages.push_back(msg);
+  }
+
+  std::vector<std::string> messages{};
+};
+
+struct Resolved {
+  std::vector<Statement::StatementUPtr> statements;
+  std::vector<std::string> errors;
+};
+
+Resolved resolve(const std::string &text) {
+  Interpreter interpreter{};
+  RecordingReporter reporter{};
+  Parser parser{Scanner{text}.tokenize()};
+  Resolved resolved{parser.parse(), {}};
+  Resolver{interpreter.globals(), &reporter}.resolve(resolved.statements);
+  resolved.errors = reporter.messages;
+  return resolved;
+}
+
+template <typename Node, typename Parent>
+Node *as(const std::unique_ptr<Parent> &node) {
+  Node *result{dynamic_cast<Node *>(node.get())};
+  REQUIRE(result);
+  return result;
+}
+} // namespace
+
+TEST_SUITE("Resolver") {
+  TEST_CASE("Locals are bound to a depth and slot.") {
+    Resolved resolved{
+        resolve("variable a = 1; { variable b = a; variable c = b; "
+                "{ variable d = c; } }")};
+    REQUIRE(resolved.errors.empty());
+    CHECK(as<Statement::Variable>(resolved.statements[0])->binding.kind ==
+          Binding::Kind::Global);
+    auto *scope{as<Statement::Scope>(resolved.statements[1])};
+    auto *b{as<Statement::Variable>(scope->statements[0])};
+    CHECK(b->binding.kind == Binding::Kind::Local);
+    CHECK(b->binding.slot == 0);
+    CHECK(as<Expression::Variable>(b->initializer)->binding.kind ==
+          Binding::Kind::Global);
+    auto *c{as<Statement::Variable>(scope->statements[1])};
+    CHECK(c->binding.slot == 1);
+    auto *inner{as<Statement::Scope>(scope->statements[2])};
+    auto *use{as<Statement::Variable>(inner->statements[0])};
+    const Binding &binding{as<Expression::Variable>(use->initializer)->binding};
+    CHECK(binding.kind == Binding::Kind::Local);
+    CHECK(binding.depth == 1);
+    CHECK(binding.slot == 1);
+  }
+
+  TEST_CASE("Undefined variables are reported.") {
+    CHECK(resolve("print(missing);").errors.size() == 1);
+    CHECK(resolve("{ variable a = 1; } a = 2;").errors.size() == 1);
+    CHECK(resolve("print(later); variable later = 1;").errors.size() == 1);
+  }
+
+  TEST_CASE("Subroutines may refer to globals declared after them.") {
+    CHECK(resolve("subroutine a() { return b(); }\n"
+                  "subroutine b() { return 1; }")
+              .errors.empty());
+    CHECK(resolve("subroutine fib(n) { return fib(n - 1); }").errors.empty());
+  }
+
+  TEST_CASE("Assigning to constants is reported.") {
+    CHECK(resolve("constant a = 1; a = 2;").errors.size() == 1);
+    CHECK(resolve("{ constant a = 1; a = 2; }").errors.size() == 1);
+    CHECK(resolve("PI = 3;").errors.size() == 1);
+    CHECK(resolve("variable a = 1; a = 2;").errors.empty());
+  }
+
+  TEST_CASE("Prototype properties are looked up by name.") {
+    Resolved resolved{resolve("prototype A { public: subroutine get() { "
+                              "return value; } private: variable value; }\n"
+                              "prototype B from A { public: subroutine "
+                              "other() { return inherited; } }")};
+    CHECK(resolved.errors.empty());
+  }
+
+  TEST_CASE("Scopes are sized and marked when prototypes capture them.") {
+    Resolved resolved{
+        resolve("{ variable a = 1; variable b = 2; }\n"
+                "{ variable c = 3; variable P = prototype { public: "
+                "subroutine get() { return c; } }; }\n"
+                "for i = 0; i < 3; i = i + 1 {}")};
+    REQUIRE(resolved.errors.empty());
+    const FrameLayout &plain{
+        as<Statement::Scope>(resolved.statements[0])->layout};
+    CHECK(plain.slots == 2);
+    CHECK_FALSE(plain.captured);
+    auto *closing{as<Statement::Scope>(resolved.statements[1])};
+    CHECK(closing->layout.captured);
+    const FrameLayout &loop{as<Statement::For>(resolved.statements[2])->layout};
+    CHECK(loop.slots == 1);
+    CHECK_FALSE(loop.captured);
+  }
+
+  TEST_CASE("Lambdas capture only their free variables.") {
+    Resolved resolved{resolve("{ variable a = 1; variable b = 2;\n"
+                              "  a = 3;\n"
+                              "  subroutine outer() {\n"
+                              "    return lambda() { return a; };\n"
+                              "  }\n"
+                              "  subroutine none(x) { return x; }\n"
+                              "}")};
+    REQUIRE(resolved.errors.empty());
+    auto *scope{as<Statement::Scope>(resolved.statements[0])};
+    CHECK_FALSE(scope->layout.captured);
+    CHECK(as<Statement::Variable>(scope->statements[0])->binding.kind ==
+          Binding::Kind::Boxed);
+    CHECK(as<Statement::Variable>(scope->statements[1])->binding.kind ==
+          Binding::Kind::Local);
+    auto *assignment{as<Expression::Assignment>(
+        as<Statement::Expression>(scope->statements[2])->expr)};
+    CHECK(assignment->binding.kind == Binding::Kind::Boxed);
+    auto *outer{as<Expression::Lambda>(
+        as<Statement::Variable>(scope->statements[3])->initializer)};
+    REQUIRE(outer->captures);
+    REQUIRE(outer->captures->size() == 1);
+    CHECK(outer->captures->front().kind == Binding::Kind::Boxed);
+    CHECK(outer->captures->front().depth == 0);
+    auto *body{as<Statement::Scope>(outer->body)};
+    auto *inner{as<Expression::Lambda>(
+        as<Statement::Return>(body->statements[0])->expr)};
+    REQUIRE(inner->captures);
+    REQUIRE(inner->captures->size() == 1);
+    CHECK(inner->captures->front().kind == Binding::Kind::Captured);
+    auto *none{as<Expression::Lambda>(
+        as<Statement::Variable>(scope->statements[4])->initializer)};
+    REQUIRE(none->captures);
+    CHECK(none->captures->empty());
+  }
+
+  TEST_CASE("Scopes that declare nothing are elided.") {
+    Resolved resolved{resolve("{ variable a = 0;\n"
+                              "  while a < 5 { if a > 2 { { a = a + 1; } } }\n"
+                              "  for i = 0; i < 1; i = i + 1 { a; }\n"
+                              "}")};
+    REQUIRE(resolved.errors.empty());
+    auto *scope{as<Statement::Scope>(resolved.statements[0])};
+    CHECK_FALSE(scope->layout.elided);
+    auto *whileStmt{as<Statement::For>(scope->statements[1])};
+    CHECK(whileStmt->layout.elided);
+    auto *body{as<Statement::Scope>(whileStmt->body)};
+    CHECK(body->layout.elided);
+    auto *ifStmt{as<Statement::If>(body->statements[0])};
+    auto *thenStmt{as<Statement::Scope>(ifStmt->thenStmt)};
+    auto *inner{as<Statement::Scope>(thenStmt->statements[0])};
+    auto *increment{as<Statement::Expression>(inner->statements[0])};
+    const Binding &binding{
+        as<Expression::Assignment>(increment->expr)->binding};
+    CHECK(binding.kind == Binding::Kind::Local);
+    CHECK(binding.depth == 0);
+    auto *forStmt{as<Statement::For>(scope->statements[2])};
+    CHECK_FALSE(forStmt->layout.elided);
+    auto *use{as<Statement::Expression>(
+        as<Statement::Scope>(forStmt->body)->statements[0])};
+    CHECK(as<Expression::Variable>(use->expr)->binding.depth == 1);
+  }
+
+  TEST_CASE("Globals are bound to slots after the natives.") {
+    Interpreter interpreter{};
+    GlobalEnvironment *globals{interpreter.globals()};
+    const std::size_t natives{globals->size()};
+    Parser parser{Scanner{"subroutine f() { return print(later); }\n"
+                          "variable later = PI;"}
+                      .tokenize()};
+    std::vector<Statement::StatementUPtr> statements{parser.parse()};
+    Resolver{globals}.resolve(statements);
+    REQUIRE(globals->size() == natives + 2);
+    CHECK(as<Statement::Variable>(statements[0])->binding.slot == natives);
+    auto *later{as<Statement::Variable>(statements[1])};
+    CHECK(later->binding.kind == Binding::Kind::Global);
+    CHECK(later->binding.slot == natives + 1);
+    CHECK(as<Expression::Variable>(later->initializer)->binding.slot ==
+          globals->slot(Token{"PI", Token::Type::Identifier}).value());
+  }
+}
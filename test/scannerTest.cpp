@@ -243,6 +243,7 @@ TEST_SUITE("Scanner") {
                        {"+", Token::Type::Plus, true, 5, 5},
                        {"-", Token::Type::Dash, true, 5, 7},
                        {"!", Token::Type::Exclamation, true, 5, 9},
+                       {"%", Token::Type::Error, true, 5, 11},
                        {",", Token::Type::Comma, true, 5, 13},
                        {".", Token::Type::Dot, true, 5, 15},
                        {"mod", Token::Type::Modulus, true, 5, 17},
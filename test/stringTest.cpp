@@ -0,0 +1,82 @@
+#include "parser.hpp"
+#include "scanner.hpp"
+#include "value.hpp"
+#include "doctest.h"
+
+TEST_SUITE("Strings") {
+  TEST_CASE("Equal strings compare equal.") {
+    const String first{"stringTest"};
+    const String second{"stringTest"};
+    CHECK(first == first);
+    CHECK(first == second);
+    CHECK(first != String{"stringTest!"});
+    CHECK(first != String{"stringTess"});
+    CHECK(first.length() == 10);
+    CHECK(first.text() == "stringTest");
+  }
+
+  TEST_CASE("Hashes are computed once and agree with the contents.") {
+    const String string{"stringTestHash"};
+    CHECK(string.hash() == std::hash<std::string>{}("stringTestHash"));
+    CHECK(string.hash() == String{"stringTestHash"}.hash());
+    CHECK(string != String{"stringTestHasH"});
+  }
+
+  TEST_CASE("Interned strings exist once.") {
+    const Value first{Value::interned("stringTestInterned")};
+    const Value second{Value::interned("stringTestInterned")};
+    CHECK(first.asString().interned());
+    CHECK(&first.asString() == &second.asString());
+    CHECK(first.asString() != Value::interned("stringTestOther").asString());
+    const Value built{std::string{"stringTestInterned"}};
+    CHECK_FALSE(built.asString().interned());
+    CHECK(built.asString() == first.asString());
+  }
+
+  TEST_CASE("Long concatenations are ropes flattened when read.") {
+    const Value shortString{Value::concatenate("a", "b")};
+    CHECK(shortString.asString().flat());
+    CHECK(shortString.asString().text() == "ab");
+    const Value empty{""};
+    const Value piece{std::string(String::ropeLength, 'x')};
+    CHECK(&Value::concatenate(piece, empty).asString() == &piece.asString());
+    CHECK(&Value::concatenate(empty, piece).asString() == &piece.asString());
+    const Value rope{Value::concatenate(piece, "y")};
+    CHECK_FALSE(rope.asString().flat());
+    CHECK(rope.asString().length() == String::ropeLength + 1);
+    CHECK(rope.asString() != piece.asString());
+    CHECK_FALSE(rope.asString().flat());
+    CHECK(rope.asString().text() == std::string(String::ropeLength, 'x') + "y");
+    CHECK(rope.asString().flat());
+    CHECK(piece.asString().length() == String::ropeLength);
+    CHECK_THROWS_AS(Value::concatenate(piece, Value{1}), std::runtime_error);
+  }
+
+  TEST_CASE("Deep ropes are flattened and destroyed without recursing.") {
+    const std::size_t count{1000000};
+    Value built{std::string(String::ropeLength, '-')};
+    const Value shared{built};
+    for(std::size_t i{0}; i < count; i++)
+      built = Value::concatenate(built, i % 2 == 0 ? "a" : "b");
+    CHECK(built.asString().length() == String::ropeLength + count);
+    const std::string &text{built.asString().text()};
+    CHECK(text.substr(String::ropeLength, 4) == "abab");
+    Value dropped{shared};
+    for(std::size_t i{0}; i < count; i++)
+      dropped = Value::concatenate("c", dropped);
+    dropped = Value{};
+    CHECK(shared.asString().length() == String::ropeLength);
+  }
+
+  TEST_CASE("String literals are interned.") {
+    Parser parser{Scanner{"\"stringTestLiteral\";"}.tokenize()};
+    std::vector<Statement::StatementUPtr> statements{parser.parse()};
+    REQUIRE(statements.size() == 1);
+    auto *statement{dynamic_cast<Statement::Expression *>(statements[0].get())};
+    REQUIRE(statement);
+    auto *literal{dynamic_cast<Expression::Literal *>(statement->expr.get())};
+    REQUIRE(literal);
+    CHECK(&literal->value.asString() ==
+          &Value::interned("stringTestLiteral").asString());
+  }
+}
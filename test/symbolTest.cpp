@@ -0,0 +1,27 @@
+#include "scanner.hpp"
+#include "symbol.hpp"
+#include "doctest.h"
+
+TEST_SUITE("Symbols") {
+  TEST_CASE("Names are interned once.") {
+    const SymbolId first{Symbols::intern("symbolTestName")};
+    const std::size_t size{Symbols::size()};
+    CHECK(first != Symbols::none);
+    CHECK(Symbols::intern("symbolTestName") == first);
+    CHECK(Symbols::size() == size);
+    CHECK(Symbols::intern("symbolTestOther") != first);
+    CHECK(Symbols::name(first) == "symbolTestName");
+  }
+
+  TEST_CASE("Scanned identifiers carry their symbol.") {
+    Tokens first{Scanner{"symbolTestScanned + 1"}.tokenize()};
+    const std::size_t size{Symbols::size()};
+    Tokens second{Scanner{"symbolTestScanned \"symbolTestScanned\""}.tokenize()};
+    CHECK(Symbols::size() == size);
+    CHECK(first[0].symbol != Symbols::none);
+    CHECK(first[0].symbol == second[0].symbol);
+    CHECK(first[1].symbol == Symbols::none);
+    CHECK(second[1].symbol == Symbols::none);
+    CHECK_FALSE(second[0] == second[1]);
+  }
+}
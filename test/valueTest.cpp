@@ -0,0 +1,71 @@
+#include "environment.hpp"
+#include "value.hpp"
+#include "doctest.h"
+
+TEST_SUITE("Value") {
+  TEST_CASE("Values report the type they hold.") {
+    CHECK(Value{}.isNil());
+    CHECK(Value{true}.type() == Value::Type::Boolean);
+    CHECK(Value{Number{2}}.type() == Value::Type::Number);
+    CHECK(Value{"text"}.type() == Value::Type::String);
+    CHECK(Value{Callable{0, 0, nullptr, nullptr}}.type() ==
+          Value::Type::Callable);
+    CHECK(Value{true}.asBoolean());
+    CHECK(Value{2.5L}.asNumber() == 2.5L);
+    CHECK(Value{std::string{"text"}}.asString().text() == "text");
+  }
+
+  TEST_CASE("Integral types become integers.") {
+    CHECK(Value{7}.type() == Value::Type::Integer);
+    CHECK(Value{std::int64_t{-7}}.asInteger() == -7);
+    CHECK(Value{7}.isNumber());
+    CHECK(Value{7}.asNumber() == 7);
+    CHECK_THROWS_AS(Value{Number{7}}.asInteger(), std::runtime_error);
+    CHECK(Value::integral(3).type() == Value::Type::Integer);
+    CHECK(Value::integral(-3.0L).asInteger() == -3);
+    CHECK(Value::integral(3.5L).type() == Value::Type::Number);
+    CHECK(Value::integral(1e30L).type() == Value::Type::Number);
+    CHECK(Value::integral(std::numeric_limits<Number>::quiet_NaN()).type() ==
+          Value::Type::Number);
+    const Number lowest{
+        static_cast<Number>(std::numeric_limits<std::int64_t>::min())};
+    CHECK(Value::integral(lowest).type() == Value::Type::Integer);
+    CHECK(Value::integral(-lowest).type() == Value::Type::Number);
+  }
+
+  TEST_CASE("Reading the wrong type throws.") {
+    CHECK_THROWS_AS(Value{}.asNumber(), std::runtime_error);
+    CHECK_THROWS_AS(Value{true}.asString(), std::runtime_error);
+    CHECK_THROWS_AS(Value{"1"}.asNumber(), std::runtime_error);
+    CHECK_THROWS_AS(Value{Number{1}}.asCallable(), std::runtime_error);
+  }
+
+  TEST_CASE("Copies share what they refer to.") {
+    const Value original{"shared"};
+    Value copy{original};
+    CHECK(&copy.asString() == &original.asString());
+    Value moved{std::move(copy)};
+    CHECK(copy.isNil());
+    CHECK(&moved.asString() == &original.asString());
+    moved = Number{3};
+    CHECK(moved.asNumber() == 3);
+    CHECK(original.asString().text() == "shared");
+    moved = original;
+    moved = moved;
+    CHECK(moved.asString().text() == "shared");
+  }
+
+  TEST_CASE("Cells are shared storage.") {
+    const Value cell{Value::cell(Number{1})};
+    const Value other{cell};
+    other.contents() = "changed";
+    CHECK(cell.contents().asString().text() == "changed");
+    CHECK_THROWS_AS(Value{Number{1}}.contents(), std::runtime_error);
+  }
+
+  TEST_CASE("Values take 16 bytes.") {
+    if(std::numeric_limits<Number>::digits <= 64) CHECK(sizeof(Value) == 16);
+    const Value third{Number{1} / 3};
+    CHECK(Value{third}.asNumber() == Number{1} / 3);
+  }
+}
@@ -0,0 +1,49 @@
+#include "fixture.hpp"
+
+namespace {
+// Runs a program on the virtual machine and returns the value it left in the
+// global "result".
+Value run(const std::string &text) {
+  return fixture::runOn(fixture::Engine::Machine, text);
+}
+} // namespace
+
+TEST_SUITE("Virtual machine") {
+  TEST_CASE("Programs declaring prototypes within scopes still run.") {
+    CHECK(run("subroutine make() {\n"
+              "  prototype Local { public: variable v = 7; }\n"
+              "  return Local.v;\n"
+              "}\n"
+              "variable result = make();")
+              .asInteger() == 7);
+    CHECK(run("variable result = 0;\n"
+              "{ prototype P { public: variable v = 2; } result = P.v; }")
+              .asInteger() == 2);
+  }
+
+  TEST_CASE("Errors leave the machine able to run again.") {
+    VirtualMachine machine{};
+    Parser failing{Scanner{"subroutine f(n) { return n / 0; }\n"
+                           "variable result = f(1);"}
+                       .tokenize()};
+    const std::vector<Statement::StatementUPtr> first{failing.parse()};
+    Resolver{machine.globals()}.resolve(first);
+    machine.interpret(first);
+    Parser parser{Scanner{"variable result = 1 + 2;"}.tokenize()};
+    const std::vector<Statement::StatementUPtr> second{parser.parse()};
+    Resolver{machine.globals()}.resolve(second);
+    machine.interpret(second);
+    CHECK(machine.globals()
+              ->get(Token{"result", Token::Type::Identifier})
+              .asInteger() == 3);
+  }
+
+  TEST_CASE("Deep recursion keeps its frames on the heap.") {
+    CHECK(run("subroutine sum(n) {\n"
+              "  if n == 0 { return 0; }\n"
+              "  return n + sum(n - 1);\n"
+              "}\n"
+              "variable result = sum(1000000);")
+              .asInteger() == 500000500000);
+  }
+}